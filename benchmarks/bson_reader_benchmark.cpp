@@ -0,0 +1,183 @@
+// Micro-benchmark: field extraction through bsoncxx lookups (doc[key], as FlattenDocument did before the raw pass)
+// versus one MongoBsonReader walk per document, on wide and nested documents.
+//
+// Build and run (needs only the bsoncxx headers and library):
+//   c++ -O2 -std=c++17 -Isrc/include benchmarks/bson_reader_benchmark.cpp \
+//       $(pkg-config --cflags --libs libbsoncxx) -o bson_reader_benchmark
+//   ./bson_reader_benchmark [documents]
+
+#include "mongo_bson_reader.hpp"
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/types.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using bsoncxx::builder::basic::kvp;
+using duckdb::MongoBsonElement;
+using duckdb::MongoBsonReader;
+using duckdb::MongoBsonType;
+
+namespace {
+
+struct Workload {
+	const char *name;
+	std::vector<bsoncxx::document::value> documents;
+	//! Top-level field (or parent document) names and, for nested fields, the child name
+	std::vector<std::pair<std::string, std::string>> fields;
+};
+
+Workload MakeWide(size_t document_count, size_t field_count) {
+	Workload workload {"wide", {}, {}};
+	for (size_t field_idx = 0; field_idx < field_count; field_idx++) {
+		workload.fields.emplace_back("field_" + std::to_string(field_idx), "");
+	}
+	for (size_t doc_idx = 0; doc_idx < document_count; doc_idx++) {
+		bsoncxx::builder::basic::document builder;
+		for (size_t field_idx = 0; field_idx < field_count; field_idx++) {
+			auto &name = workload.fields[field_idx].first;
+			switch (field_idx % 3) {
+			case 0:
+				builder.append(kvp(name, int64_t(doc_idx * field_idx)));
+				break;
+			case 1:
+				builder.append(kvp(name, double(doc_idx) / double(field_idx + 1)));
+				break;
+			default:
+				builder.append(kvp(name, "value_" + std::to_string(doc_idx)));
+				break;
+			}
+		}
+		workload.documents.push_back(builder.extract());
+	}
+	return workload;
+}
+
+Workload MakeNested(size_t document_count, size_t parent_count, size_t child_count) {
+	Workload workload {"nested", {}, {}};
+	for (size_t parent_idx = 0; parent_idx < parent_count; parent_idx++) {
+		for (size_t child_idx = 0; child_idx < child_count; child_idx++) {
+			workload.fields.emplace_back("parent_" + std::to_string(parent_idx), "child_" + std::to_string(child_idx));
+		}
+	}
+	for (size_t doc_idx = 0; doc_idx < document_count; doc_idx++) {
+		bsoncxx::builder::basic::document builder;
+		for (size_t parent_idx = 0; parent_idx < parent_count; parent_idx++) {
+			bsoncxx::builder::basic::document child;
+			for (size_t child_idx = 0; child_idx < child_count; child_idx++) {
+				child.append(kvp("child_" + std::to_string(child_idx), int64_t(doc_idx + child_idx)));
+			}
+			builder.append(kvp("parent_" + std::to_string(parent_idx), child.extract()));
+		}
+		workload.documents.push_back(builder.extract());
+	}
+	return workload;
+}
+
+int64_t ElementValue(const bsoncxx::document::element &element) {
+	switch (element.type()) {
+	case bsoncxx::type::k_int64:
+		return element.get_int64().value;
+	case bsoncxx::type::k_double:
+		return int64_t(element.get_double().value);
+	case bsoncxx::type::k_string:
+		return int64_t(element.get_string().value.size());
+	default:
+		return 0;
+	}
+}
+
+int64_t ElementValue(const MongoBsonElement &element) {
+	switch (element.type) {
+	case MongoBsonType::INT64:
+		return element.GetInt64();
+	case MongoBsonType::DOUBLE:
+		return int64_t(element.GetDouble());
+	case MongoBsonType::STRING:
+		return int64_t(element.GetStringLength());
+	default:
+		return 0;
+	}
+}
+
+// One doc[key] lookup per field, each restarting from the first element
+int64_t ExtractWithLookups(const Workload &workload) {
+	int64_t checksum = 0;
+	for (auto &document : workload.documents) {
+		auto doc = document.view();
+		for (auto &field : workload.fields) {
+			auto element = doc[field.first];
+			if (element && !field.second.empty()) {
+				element = element.get_document().view()[field.second];
+			}
+			if (element) {
+				checksum += ElementValue(element);
+			}
+		}
+	}
+	return checksum;
+}
+
+int64_t WalkDocument(const uint8_t *data, size_t length, bool top_level) {
+	int64_t checksum = 0;
+	MongoBsonReader reader(data, length);
+	MongoBsonElement element;
+	while (reader.Next(element)) {
+		if (top_level && element.type == MongoBsonType::DOCUMENT) {
+			checksum += WalkDocument(element.value, element.value_length, false);
+			continue;
+		}
+		// The field lists select every key, like a plan decoding all columns
+		checksum += ElementValue(element);
+	}
+	return checksum;
+}
+
+// A single forward walk over each document's bytes
+int64_t ExtractWithReader(const Workload &workload) {
+	int64_t checksum = 0;
+	for (auto &document : workload.documents) {
+		auto doc = document.view();
+		checksum += WalkDocument(doc.data(), doc.length(), true);
+	}
+	return checksum;
+}
+
+template <class FUNC>
+double Measure(FUNC &&extract, const Workload &workload, int64_t &checksum) {
+	auto start = std::chrono::steady_clock::now();
+	checksum = extract(workload);
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	size_t document_count = argc > 1 ? size_t(std::strtoull(argv[1], nullptr, 10)) : 20000;
+	std::vector<Workload> workloads;
+	workloads.push_back(MakeWide(document_count, 200));
+	workloads.push_back(MakeNested(document_count, 20, 10));
+
+	std::printf("%-8s %12s %12s %10s\n", "workload", "bsoncxx_ms", "reader_ms", "speedup");
+	for (auto &workload : workloads) {
+		int64_t lookup_checksum;
+		int64_t reader_checksum;
+		auto lookup_ms = Measure(ExtractWithLookups, workload, lookup_checksum);
+		auto reader_ms = Measure(ExtractWithReader, workload, reader_checksum);
+		if (lookup_checksum != reader_checksum) {
+			std::fprintf(stderr, "%s: checksums differ (%lld vs %lld)\n", workload.name,
+			             static_cast<long long>(lookup_checksum), static_cast<long long>(reader_checksum));
+			return 1;
+		}
+		std::printf("%-8s %12.1f %12.1f %9.1fx\n", workload.name, lookup_ms, reader_ms, lookup_ms / reader_ms);
+	}
+	return 0;
+}
@@ -0,0 +1,107 @@
+// Micro-benchmark: matching the element names of wide documents against the requested columns with a string compare
+// per column (as FlattenDocument's raw pass did) versus MongoFieldMatcher, the hashed lookup of the path trie.
+//
+// Build and run (no dependencies):
+//   c++ -O2 -std=c++17 -Isrc/include benchmarks/field_matcher_benchmark.cpp -o field_matcher_benchmark
+//   ./field_matcher_benchmark [documents]
+
+#include "mongo_field_matcher.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using duckdb::MongoFieldMatcher;
+
+namespace {
+
+struct Workload {
+	std::string name;
+	//! Element names of one document, in document order
+	std::vector<std::string> elements;
+	//! Requested column names
+	std::vector<std::string> columns;
+};
+
+Workload MakeWorkload(const std::string &prefix, size_t field_count, size_t column_step) {
+	Workload workload;
+	workload.name = prefix + std::to_string(field_count) + "/" + std::to_string(field_count / column_step);
+	for (size_t field_idx = 0; field_idx < field_count; field_idx++) {
+		workload.elements.push_back(prefix + std::to_string(field_idx));
+		if (field_idx % column_step == 0) {
+			workload.columns.push_back(workload.elements.back());
+		}
+	}
+	return workload;
+}
+
+// Compares each element name with every requested column, checking the length first
+uint64_t MatchWithCompares(const Workload &workload, size_t document_count) {
+	uint64_t checksum = 0;
+	for (size_t doc_idx = 0; doc_idx < document_count; doc_idx++) {
+		for (auto &element : workload.elements) {
+			for (size_t col_idx = 0; col_idx < workload.columns.size(); col_idx++) {
+				auto &column = workload.columns[col_idx];
+				if (column.size() == element.size() && memcmp(column.data(), element.data(), element.size()) == 0) {
+					checksum += col_idx + 1;
+					break;
+				}
+			}
+		}
+	}
+	return checksum;
+}
+
+uint64_t MatchWithMatcher(const Workload &workload, size_t document_count) {
+	MongoFieldMatcher matcher;
+	for (auto &column : workload.columns) {
+		matcher.Add(column);
+	}
+	matcher.Build();
+	uint64_t checksum = 0;
+	for (size_t doc_idx = 0; doc_idx < document_count; doc_idx++) {
+		for (auto &element : workload.elements) {
+			auto col_idx = matcher.Find(element.data(), uint32_t(element.size()));
+			if (col_idx != MongoFieldMatcher::NOT_FOUND) {
+				checksum += col_idx + 1;
+			}
+		}
+	}
+	return checksum;
+}
+
+template <class FUNC>
+double Measure(FUNC &&match, const Workload &workload, size_t document_count, uint64_t &checksum) {
+	auto start = std::chrono::steady_clock::now();
+	checksum = match(workload, document_count);
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	size_t document_count = argc > 1 ? size_t(std::strtoull(argv[1], nullptr, 10)) : 20000;
+	std::vector<Workload> workloads;
+	workloads.push_back(MakeWorkload("f", 50, 1));
+	workloads.push_back(MakeWorkload("field_", 200, 1));
+	workloads.push_back(MakeWorkload("field_", 200, 4));
+	workloads.push_back(MakeWorkload("sensor_reading_", 500, 2));
+
+	std::printf("%-24s %12s %12s %10s\n", "fields/columns", "compare_ms", "matcher_ms", "speedup");
+	for (auto &workload : workloads) {
+		uint64_t compare_checksum;
+		uint64_t matcher_checksum;
+		auto compare_ms = Measure(MatchWithCompares, workload, document_count, compare_checksum);
+		auto matcher_ms = Measure(MatchWithMatcher, workload, document_count, matcher_checksum);
+		if (compare_checksum != matcher_checksum) {
+			std::fprintf(stderr, "%s: checksums differ\n", workload.name.c_str());
+			return 1;
+		}
+		std::printf("%-24s %12.1f %12.1f %9.1fx\n", workload.name.c_str(), compare_ms, matcher_ms,
+		            compare_ms / matcher_ms);
+	}
+	return 0;
+}
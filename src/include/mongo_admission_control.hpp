@@ -0,0 +1,89 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/mutex.hpp"
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <string>
+
+namespace duckdb {
+
+// Limits on the cursors mongo_scan keeps open against one connection string (0 = unlimited)
+struct MongoAdmissionLimits {
+	idx_t max_cursors = 0;
+	//! New cursors wait while the active cursors hold at least this many bytes (see MongoCursorSlot::AddDocument)
+	idx_t max_in_flight_bytes = 0;
+	//! How long a cursor waits for admission before its scan fails (0 waits indefinitely)
+	int64_t timeout_ms = 60000;
+};
+
+// Open and waiting cursors of one connection string
+struct MongoAdmissionPool {
+	mutex lock;
+	std::condition_variable changed;
+	idx_t active_cursors = 0;
+	idx_t in_flight_bytes = 0;
+	//! Tickets of the waiting cursors, admitted in order
+	std::deque<idx_t> waiting;
+	idx_t next_ticket = 0;
+	idx_t admitted_cursors = 0;
+	idx_t timed_out_cursors = 0;
+};
+
+// Admission of one cursor, released when destroyed
+class MongoCursorSlot {
+public:
+	explicit MongoCursorSlot(shared_ptr<MongoAdmissionPool> pool);
+	~MongoCursorSlot();
+
+	//! Counts a document read from the cursor. The cursor's in-flight bytes are the bytes of its latest
+	//! STANDARD_VECTOR_SIZE documents, roughly the batch the driver and the decoder hold on to.
+	void AddDocument(idx_t bytes);
+
+private:
+	shared_ptr<MongoAdmissionPool> pool;
+	idx_t window_documents = 0;
+	idx_t window_bytes = 0;
+	idx_t in_flight_bytes = 0;
+};
+
+struct MongoConnectionStats {
+	std::string connection_string;
+	idx_t active_cursors;
+	idx_t waiting_cursors;
+	idx_t in_flight_bytes;
+	idx_t admitted_cursors;
+	idx_t timed_out_cursors;
+};
+
+// Admission control for mongo_scan cursors, per connection string: a cursor is opened once the number of active
+// cursors and their in-flight bytes are below the limits, in arrival order (FIFO). Shared by all database instances
+// in the process, like the mongocxx instance, so that every query against a cluster is counted.
+class MongoAdmissionController {
+public:
+	static MongoAdmissionController &Get();
+
+	//! Waits for admission; throws IOException after limits.timeout_ms, or InterruptException when the query is
+	//! interrupted while waiting
+	unique_ptr<MongoCursorSlot> Acquire(ClientContext &context, const std::string &connection_string,
+	                                    const MongoAdmissionLimits &limits);
+	vector<MongoConnectionStats> GetStats();
+
+private:
+	mutex lock;
+	std::map<std::string, shared_ptr<MongoAdmissionPool>> pools;
+};
+
+// Reads mongo_max_concurrent_cursors, mongo_max_in_flight_bytes and mongo_admission_timeout_ms
+MongoAdmissionLimits MongoAdmissionLimitsFromSettings(ClientContext &context);
+
+// Registers mongo_max_concurrent_cursors, mongo_max_in_flight_bytes and mongo_admission_timeout_ms
+void RegisterMongoAdmissionSettings(DBConfig &config);
+
+class MongoConnectionsFunction : public TableFunction {
+public:
+	MongoConnectionsFunction();
+};
+
+} // namespace duckdb
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace duckdb {
+
+// BSON element type bytes (bsoncxx::type values)
+enum class MongoBsonType : uint8_t {
+	DOUBLE = 0x01,
+	STRING = 0x02,
+	DOCUMENT = 0x03,
+	ARRAY = 0x04,
+	BINARY = 0x05,
+	UNDEFINED = 0x06,
+	OID = 0x07,
+	BOOL = 0x08,
+	DATE = 0x09,
+	NULL_VALUE = 0x0A,
+	REGEX = 0x0B,
+	DBPOINTER = 0x0C,
+	CODE = 0x0D,
+	SYMBOL = 0x0E,
+	CODE_WITH_SCOPE = 0x0F,
+	INT32 = 0x10,
+	TIMESTAMP = 0x11,
+	INT64 = 0x12,
+	DECIMAL128 = 0x13,
+	MAX_KEY = 0x7F,
+	MIN_KEY = 0xFF
+};
+
+// One element of a document, pointing into the document's bytes
+struct MongoBsonElement {
+	MongoBsonType type;
+	const char *key;
+	uint32_t key_length;
+	//! The value bytes (for strings: the int32 length prefix, the characters and the terminating NUL)
+	const uint8_t *value;
+	uint32_t value_length;
+
+	bool KeyEquals(const char *other, uint32_t other_length) const {
+		return key_length == other_length && memcmp(key, other, other_length) == 0;
+	}
+
+	// Accessors for elements of the matching type
+	int32_t GetInt32() const {
+		int32_t result;
+		memcpy(&result, value, sizeof(result));
+		return result;
+	}
+	int64_t GetInt64() const {
+		int64_t result;
+		memcpy(&result, value, sizeof(result));
+		return result;
+	}
+	double GetDouble() const {
+		double result;
+		memcpy(&result, value, sizeof(result));
+		return result;
+	}
+	bool GetBool() const {
+		return value[0] != 0;
+	}
+	//! STRING, CODE and SYMBOL: the characters without the terminating NUL
+	const char *GetStringData() const {
+		return reinterpret_cast<const char *>(value) + sizeof(int32_t);
+	}
+	uint32_t GetStringLength() const {
+		return value_length - uint32_t(sizeof(int32_t)) - 1;
+	}
+};
+
+// Forward-only reader over the elements of one BSON document (little-endian, as on the wire). Every length is
+// checked against the document bounds, so a malformed document ends the iteration (Malformed() is then true) instead
+// of reading out of bounds. Nested documents and arrays are skipped over, not validated; read them with a reader of
+// their own. The decode path walks each document once with it instead of looking fields up by key through bsoncxx,
+// which restarts from the first element for every lookup.
+class MongoBsonReader {
+public:
+	MongoBsonReader(const uint8_t *data, size_t length) : position(data), end(data), malformed(true) {
+		int32_t document_length;
+		if (length < 5) {
+			return;
+		}
+		memcpy(&document_length, data, sizeof(document_length));
+		if (document_length < 5 || size_t(document_length) > length || data[document_length - 1] != 0) {
+			return;
+		}
+		position = data + sizeof(int32_t);
+		// The terminating NUL of the document
+		end = data + document_length - 1;
+		malformed = false;
+	}
+
+	//! Reads the next element; returns false at the end of the document or when it is malformed
+	bool Next(MongoBsonElement &element) {
+		if (position >= end) {
+			return false;
+		}
+		element.type = MongoBsonType(*position++);
+		auto key_end = static_cast<const uint8_t *>(memchr(position, 0, size_t(end - position)));
+		if (!key_end) {
+			return Fail();
+		}
+		element.key = reinterpret_cast<const char *>(position);
+		element.key_length = uint32_t(key_end - position);
+		position = key_end + 1;
+
+		size_t value_length;
+		if (!ValueLength(element.type, value_length)) {
+			return Fail();
+		}
+		element.value = position;
+		element.value_length = uint32_t(value_length);
+		position += value_length;
+		return true;
+	}
+
+	bool Malformed() const {
+		return malformed;
+	}
+
+private:
+	bool Fail() {
+		malformed = true;
+		position = end;
+		return false;
+	}
+
+	size_t Remaining() const {
+		return size_t(end - position);
+	}
+
+	// Reads an int32 length prefix at `offset` from the current value
+	bool ReadLength(size_t offset, int32_t &length) const {
+		if (Remaining() < offset + sizeof(int32_t)) {
+			return false;
+		}
+		memcpy(&length, position + offset, sizeof(length));
+		return length >= 0;
+	}
+
+	// Length of a NUL-terminated string starting `offset` bytes into the current value, including the NUL
+	bool CStringLength(size_t offset, size_t &length) const {
+		if (Remaining() < offset) {
+			return false;
+		}
+		auto terminator = memchr(position + offset, 0, Remaining() - offset);
+		if (!terminator) {
+			return false;
+		}
+		length = size_t(static_cast<const uint8_t *>(terminator) - (position + offset)) + 1;
+		return true;
+	}
+
+	bool ValueLength(MongoBsonType type, size_t &length) const {
+		int32_t prefix;
+		switch (type) {
+		case MongoBsonType::UNDEFINED:
+		case MongoBsonType::NULL_VALUE:
+		case MongoBsonType::MAX_KEY:
+		case MongoBsonType::MIN_KEY:
+			length = 0;
+			break;
+		case MongoBsonType::BOOL:
+			length = 1;
+			break;
+		case MongoBsonType::INT32:
+			length = 4;
+			break;
+		case MongoBsonType::DOUBLE:
+		case MongoBsonType::DATE:
+		case MongoBsonType::TIMESTAMP:
+		case MongoBsonType::INT64:
+			length = 8;
+			break;
+		case MongoBsonType::OID:
+			length = 12;
+			break;
+		case MongoBsonType::DECIMAL128:
+			length = 16;
+			break;
+		case MongoBsonType::STRING:
+		case MongoBsonType::CODE:
+		case MongoBsonType::SYMBOL:
+			if (!ReadLength(0, prefix) || prefix < 1) {
+				return false;
+			}
+			length = sizeof(int32_t) + size_t(prefix);
+			// The string must end with its NUL
+			if (length > Remaining() || position[length - 1] != 0) {
+				return false;
+			}
+			return true;
+		case MongoBsonType::DBPOINTER:
+			if (!ReadLength(0, prefix) || prefix < 1) {
+				return false;
+			}
+			length = sizeof(int32_t) + size_t(prefix) + 12;
+			break;
+		case MongoBsonType::DOCUMENT:
+		case MongoBsonType::ARRAY:
+		case MongoBsonType::CODE_WITH_SCOPE:
+			if (!ReadLength(0, prefix) || prefix < 5) {
+				return false;
+			}
+			length = size_t(prefix);
+			break;
+		case MongoBsonType::BINARY:
+			if (!ReadLength(0, prefix)) {
+				return false;
+			}
+			length = sizeof(int32_t) + 1 + size_t(prefix);
+			break;
+		case MongoBsonType::REGEX: {
+			size_t pattern_length;
+			size_t options_length;
+			if (!CStringLength(0, pattern_length) || !CStringLength(pattern_length, options_length)) {
+				return false;
+			}
+			length = pattern_length + options_length;
+			break;
+		}
+		default:
+			return false;
+		}
+		return length <= Remaining();
+	}
+
+	const uint8_t *position;
+	const uint8_t *end;
+	bool malformed;
+};
+
+} // namespace duckdb
@@ -13,6 +13,7 @@
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "duckdb/parser/parsed_data/create_view_info.hpp"
 #include "duckdb/parser/parsed_data/create_schema_info.hpp"
+#include "duckdb/parser/parsed_data/create_table_info.hpp"
 #include "duckdb/parser/parsed_data/drop_info.hpp"
 #include "duckdb/catalog/catalog_entry.hpp"
 
@@ -100,6 +101,16 @@ inline unique_ptr<TableFilter> MongoCopyFilter(const TableFilter &filter) {
 #endif
 }
 
+// Expression equivalent of a TableFilter applied to `column` (DuckDB main only has ExpressionFilter).
+inline unique_ptr<Expression> MongoFilterToExpression(const TableFilter &filter, const Expression &column) {
+#ifdef DUCKDB_MAIN_VECTOR_API
+	auto &ef = static_cast<const ExpressionFilter &>(filter);
+	return ef.ToExpression(column);
+#else
+	return filter.ToExpression(column);
+#endif
+}
+
 // Cross-version comparison expression helpers.
 // DuckDB main: comparisons are BoundFunctionExpression; v1.5.x: BoundComparisonExpression.
 inline bool MongoIsComparisonExpr(const Expression &expr) {
@@ -291,7 +302,7 @@ inline const string &MongoChildPairName(const pair<string, LogicalType> &p) {
 }
 #endif
 
-// DuckDB main refactored CreateViewInfo, CreateSchemaInfo, DropInfo to use QualifiedName.
+// DuckDB main refactored CreateViewInfo, CreateSchemaInfo, CreateTableInfo, DropInfo to use QualifiedName.
 // These helpers abstract field access for cross-version compatibility.
 #ifdef DUCKDB_MAIN_VECTOR_API
 
@@ -316,6 +327,12 @@ inline string MongoGetViewSchema(const CreateViewInfo &info) {
 inline string MongoGetViewName(const CreateViewInfo &info) {
 	return info.GetViewName().GetIdentifierName();
 }
+inline string MongoGetTableName(const CreateTableInfo &info) {
+	return info.GetTableName().GetIdentifierName();
+}
+inline string MongoColumnName(const ColumnDefinition &column) {
+	return column.Name().GetIdentifierName();
+}
 using MongoDefaultEntryList = vector<Identifier>;
 inline MongoDefaultEntryList MongoMakeDefaultEntries(const vector<string> &names) {
 	MongoDefaultEntryList result;
@@ -348,6 +365,12 @@ inline string MongoGetViewSchema(const CreateViewInfo &info) {
 inline string MongoGetViewName(const CreateViewInfo &info) {
 	return info.view_name;
 }
+inline string MongoGetTableName(const CreateTableInfo &info) {
+	return info.table;
+}
+inline string MongoColumnName(const ColumnDefinition &column) {
+	return column.Name();
+}
 using MongoDefaultEntryList = vector<string>;
 inline MongoDefaultEntryList MongoMakeDefaultEntries(const vector<string> &names) {
 	return names;
@@ -2,14 +2,23 @@
 
 #include "duckdb/common/common.hpp"
 
+#include <bsoncxx/document/value.hpp>
+
 namespace duckdb {
 
 class ClientContext;
 class Expression;
 class FunctionData;
 class LogicalGet;
+struct MongoScanData;
 
 void MongoPushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data,
                                 vector<unique_ptr<Expression>> &filters);
 
+// MongoDB aggregation expression computing `expr` from the columns of the find scan `get`, projected by the cursor
+// as a computed field: +, - and * of DOUBLE columns and constants, concat and || of VARCHAR columns and constants.
+// Column values of another BSON type become null. Returns false otherwise.
+bool ConvertMongoComputedExpression(const Expression &expr, const LogicalGet &get, const MongoScanData &data,
+                                    bsoncxx::document::value &out);
+
 } // namespace duckdb
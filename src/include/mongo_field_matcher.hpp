@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Lookup of BSON element names among a fixed set of field names, replacing a string compare against every
+// requested column. Names are hashed a word at a time into an open-addressing table whose seed is chosen at build
+// time so that no two names collide (a perfect hash) whenever one is found among the tried seeds; otherwise lookups
+// probe linearly. A slot is rejected on its length and first 8 bytes, compared as one word, before the rest of the
+// name is compared with memcmp.
+class MongoFieldMatcher {
+public:
+	static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+	//! Adds a name (build time only); returns its index, the existing one for a name that was added before
+	uint32_t Add(const std::string &name) {
+		for (uint32_t i = 0; i < names.size(); i++) {
+			if (names[i] == name) {
+				return i;
+			}
+		}
+		names.push_back(name);
+		return uint32_t(names.size() - 1);
+	}
+
+	//! Builds the table once every name was added
+	void Build() {
+		if (names.empty()) {
+			return;
+		}
+		uint64_t capacity = 8;
+		while (capacity < names.size() * 2) {
+			capacity *= 2;
+		}
+		uint32_t best_probes = UINT32_MAX;
+		for (uint64_t attempt = 0; attempt < MAX_SEED_ATTEMPTS && best_probes > 1; attempt++) {
+			auto probes = Fill(capacity, SEED_BASE + attempt * SEED_STEP);
+			if (probes < best_probes) {
+				best_probes = probes;
+				best_seed = SEED_BASE + attempt * SEED_STEP;
+			}
+		}
+		Fill(capacity, best_seed);
+	}
+
+	//! Index of the name, or NOT_FOUND
+	uint32_t Find(const char *name, uint32_t length) const {
+		if (slots.empty()) {
+			return NOT_FOUND;
+		}
+		uint64_t prefix = Prefix(name, length);
+		uint64_t slot_idx = Hash(name, length, prefix, best_seed) & mask;
+		while (true) {
+			auto &slot = slots[slot_idx];
+			if (slot.index == NOT_FOUND) {
+				return NOT_FOUND;
+			}
+			if (slot.prefix == prefix && slot.length == length &&
+			    (length <= sizeof(uint64_t) ||
+			     memcmp(names[slot.index].data() + sizeof(uint64_t), name + sizeof(uint64_t),
+			            length - sizeof(uint64_t)) == 0)) {
+				return slot.index;
+			}
+			slot_idx = (slot_idx + 1) & mask;
+		}
+	}
+
+	const std::vector<std::string> &Names() const {
+		return names;
+	}
+
+private:
+	struct Slot {
+		uint64_t prefix;
+		uint32_t length;
+		uint32_t index;
+	};
+
+	static constexpr uint64_t MAX_SEED_ATTEMPTS = 32;
+	static constexpr uint64_t SEED_BASE = 0x9E3779B97F4A7C15ULL;
+	static constexpr uint64_t SEED_STEP = 0xBF58476D1CE4E5B9ULL;
+
+	// The first 8 bytes of the name, zero padded
+	static uint64_t Prefix(const char *name, uint32_t length) {
+		uint64_t prefix = 0;
+		memcpy(&prefix, name, length < sizeof(prefix) ? length : sizeof(prefix));
+		return prefix;
+	}
+
+	static uint64_t Mix(uint64_t hash) {
+		hash ^= hash >> 32;
+		hash *= 0xD6E8FEB86659FD93ULL;
+		return hash ^ (hash >> 32);
+	}
+
+	static uint64_t Hash(const char *name, uint32_t length, uint64_t prefix, uint64_t seed) {
+		uint64_t hash = Mix(seed ^ prefix ^ length);
+		for (uint32_t offset = sizeof(uint64_t); offset < length; offset += sizeof(uint64_t)) {
+			hash = Mix(hash ^ Prefix(name + offset, length - offset));
+		}
+		return hash;
+	}
+
+	// Fills the table with the given seed; returns the longest probe sequence
+	uint32_t Fill(uint64_t capacity, uint64_t seed) {
+		slots.assign(capacity, Slot {0, 0, NOT_FOUND});
+		mask = capacity - 1;
+		uint32_t max_probes = 0;
+		for (uint32_t i = 0; i < names.size(); i++) {
+			auto &name = names[i];
+			auto length = uint32_t(name.size());
+			auto prefix = Prefix(name.data(), length);
+			uint64_t slot_idx = Hash(name.data(), length, prefix, seed) & mask;
+			uint32_t probes = 1;
+			while (slots[slot_idx].index != NOT_FOUND) {
+				slot_idx = (slot_idx + 1) & mask;
+				probes++;
+			}
+			slots[slot_idx] = Slot {prefix, length, i};
+			if (probes > max_probes) {
+				max_probes = probes;
+			}
+		}
+		return max_probes;
+	}
+
+	std::vector<std::string> names;
+	std::vector<Slot> slots;
+	uint64_t mask = 0;
+	uint64_t best_seed = SEED_BASE;
+};
+
+// Trie of the dotted paths of the columns FlattenDocument resolves in its raw pass. Each node matches the element
+// names of one (sub-)document level against the path segments at that level.
+struct MongoPathTrie {
+	static constexpr uint32_t NO_CHILD = UINT32_MAX;
+
+	struct Field {
+		//! Columns whose path ends at this field
+		std::vector<uint32_t> columns;
+		//! Every column whose path starts with this field, all resolved by the field's first occurrence
+		std::vector<uint32_t> subtree_columns;
+		//! Node of the segments below this field
+		uint32_t child = NO_CHILD;
+	};
+
+	struct Node {
+		MongoFieldMatcher matcher;
+		//! Indexed by matcher.Find()
+		std::vector<Field> fields;
+	};
+
+	//! nodes[0] is the root (the top-level fields)
+	std::vector<Node> nodes;
+
+	MongoPathTrie() : nodes(1) {
+	}
+
+	void Add(const std::vector<std::string> &path, uint32_t column) {
+		uint32_t node_idx = 0;
+		for (size_t depth = 0; depth < path.size(); depth++) {
+			auto field_idx = nodes[node_idx].matcher.Add(path[depth]);
+			if (field_idx == nodes[node_idx].fields.size()) {
+				nodes[node_idx].fields.emplace_back();
+			}
+			nodes[node_idx].fields[field_idx].subtree_columns.push_back(column);
+			if (depth + 1 == path.size()) {
+				nodes[node_idx].fields[field_idx].columns.push_back(column);
+				break;
+			}
+			if (nodes[node_idx].fields[field_idx].child == NO_CHILD) {
+				nodes[node_idx].fields[field_idx].child = uint32_t(nodes.size());
+				nodes.emplace_back();
+			}
+			node_idx = nodes[node_idx].fields[field_idx].child;
+		}
+	}
+
+	//! Builds the matchers once every path was added
+	void Build() {
+		for (auto &node : nodes) {
+			node.matcher.Build();
+		}
+	}
+};
+
+} // namespace duckdb
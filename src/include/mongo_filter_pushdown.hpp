@@ -64,6 +64,31 @@ bsoncxx::document::value
 ConvertFiltersToMongoQuery(optional_ptr<TableFilterSet> filters, const std::vector<std::string> &column_names,
                            const std::vector<LogicalType> &column_types,
                            const std::unordered_map<std::string, std::string> &column_name_to_mongo_path,
-                           const std::unordered_set<std::string> &objectid_columns);
+                           const std::unordered_set<std::string> &objectid_columns,
+                           const std::unordered_set<std::string> &client_filter_columns = {});
+
+// Schema column indices (keys of `filters`) whose filter ConvertFiltersToMongoQuery drops or only partly converts,
+// including every filter on client_filter_columns. The scan evaluates these filters itself (see
+// MongoScanState::residual_filter).
+vector<idx_t> GetResidualFilterColumns(TableFilterSet &filters, const std::vector<std::string> &column_names,
+                                       const std::vector<LogicalType> &column_types,
+                                       const std::unordered_map<std::string, std::string> &column_name_to_mongo_path,
+                                       const std::unordered_set<std::string> &objectid_columns,
+                                       const std::unordered_set<std::string> &client_filter_columns = {});
+
+// Whether `filter` is a dynamic filter (hash join bounds, Top-N boundary) that has no value yet. Its value may be
+// set while the query runs, so it is converted again when the cursor is opened.
+bool IsPendingDynamicFilter(const TableFilter &filter);
+
+// Single `{path: {<op>: constant}}` comparison on an arbitrary MongoDB path (e.g. a MAP key as "metrics.host1")
+bsoncxx::document::value BuildMongoPathComparison(ExpressionType comparison_type, const Value &constant,
+                                                  const std::string &mongo_path, const LogicalType &value_type);
+
+// `$expr` that keeps only documents whose scalar schema columns are missing, null or of a BSON type the column
+// accepts (the server-side form of the DROPMALFORMED check). Empty when no column needs a check. `exact` is set
+// when the filter drops precisely the documents the client-side check drops; otherwise it only drops a subset.
+bsoncxx::document::value
+BuildSchemaTypeFilter(const std::vector<std::string> &column_names, const std::vector<LogicalType> &column_types,
+                      const std::unordered_map<std::string, std::string> &column_name_to_mongo_path, bool &exact);
 
 } // namespace duckdb
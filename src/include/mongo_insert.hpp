@@ -0,0 +1,115 @@
+#pragma once
+
+#include "duckdb/common/enums/on_create_conflict.hpp"
+#include "duckdb/execution/physical_operator.hpp"
+#include "duckdb/function/copy_function.hpp"
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/types/bson_value/value.hpp>
+
+namespace duckdb {
+
+class MongoCatalog;
+
+// BSON value written for a DuckDB value, the inverse of the BSON type mapping: integers as Int32/Int64 (Double beyond
+// Int64), DECIMAL as Decimal128, DATE and TIMESTAMP as Date, BLOB as Binary, LIST as Array, STRUCT and MAP as
+// Document, and the remaining types as their string representation
+bsoncxx::types::bson_value::value MongoValueToBson(const Value &value);
+
+// Document of row `row` of `chunk`, one field per column. A NULL _id is left out (the server generates one). A VARCHAR
+// _id read from an ObjectId column (listed in `objectid_columns`) is written as an ObjectId when it holds 24 hex
+// digits, so that ObjectIds survive a round trip; other strings stay strings.
+bsoncxx::document::value MongoRowToDocument(DataChunk &chunk, idx_t row, const vector<string> &column_names,
+                                            const unordered_set<string> &objectid_columns);
+
+// Collection written by CREATE TABLE AS
+struct MongoInsertTarget {
+	string database_name;
+	string collection_name;
+	OnCreateConflict on_conflict = OnCreateConflict::ERROR_ON_CONFLICT;
+	//! Field name of every column of the inserted rows
+	vector<string> column_names;
+	//! Columns read from a detected ObjectId column of a mongo_scan (see MongoInsertObjectIdColumns)
+	unordered_set<string> objectid_columns;
+};
+
+// CREATE TABLE AS through DuckDB: the rows of the child plan become documents, written with unordered insert_many
+// batches by every thread of the sink (one client per thread)
+class MongoInsert : public PhysicalOperator {
+public:
+	MongoInsert(PhysicalPlan &physical_plan, LogicalOperator &op, MongoCatalog &catalog, MongoInsertTarget target);
+
+	MongoCatalog &catalog;
+	MongoInsertTarget target;
+
+public:
+	// Source interface
+	SourceResultType GetData(ExecutionContext &context, DataChunk &chunk, OperatorSourceInput &input) const override;
+
+	bool IsSource() const override {
+		return true;
+	}
+
+public:
+	// Sink interface
+	unique_ptr<GlobalSinkState> GetGlobalSinkState(ClientContext &context) const override;
+	unique_ptr<LocalSinkState> GetLocalSinkState(ExecutionContext &context) const override;
+	SinkResultType Sink(ExecutionContext &context, DataChunk &chunk, OperatorSinkInput &input) const override;
+	SinkCombineResultType Combine(ExecutionContext &context, OperatorSinkCombineInput &input) const override;
+	SinkFinalizeType Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
+	                          OperatorSinkFinalizeInput &input) const override;
+
+	bool IsSink() const override {
+		return true;
+	}
+	bool ParallelSink() const override {
+		return true;
+	}
+
+	string GetName() const override;
+	InsertionOrderPreservingMap<string> ParamsToString() const override;
+};
+
+// CREATE TABLE AS reading a single mongo_scan of the same cluster: the scan's pipeline, a $project naming the target
+// columns and a $out into the target collection run on the server, so no document passes through DuckDB
+class MongoServerInsert : public PhysicalOperator {
+public:
+	MongoServerInsert(PhysicalPlan &physical_plan, LogicalOperator &op, MongoCatalog &catalog, MongoInsertTarget target,
+	                  string source_database, string source_collection, vector<bsoncxx::document::value> stages);
+
+	MongoCatalog &catalog;
+	MongoInsertTarget target;
+	string source_database;
+	string source_collection;
+	//! The aggregation run on the source collection, ending with the $out stage
+	vector<bsoncxx::document::value> stages;
+
+public:
+	SourceResultType GetData(ExecutionContext &context, DataChunk &chunk, OperatorSourceInput &input) const override;
+
+	bool IsSource() const override {
+		return true;
+	}
+
+	string GetName() const override;
+	InsertionOrderPreservingMap<string> ParamsToString() const override;
+};
+
+// Builds the stages of a MongoServerInsert when `plan` is a mongo_scan on `connection_string`, under projections that
+// only select or reorder its columns, the scan can be expressed as a pipeline, and the server writes the same
+// documents as MONGO_INSERT would (BIGINT, DOUBLE, BOOLEAN, TIMESTAMP and VARCHAR columns, the latter only holding
+// strings and ObjectIds, which a query checks). Returns false otherwise.
+bool BuildMongoServerInsertPipeline(PhysicalOperator &plan, const string &connection_string,
+                                    const MongoInsertTarget &target, string &source_database,
+                                    string &source_collection, vector<bsoncxx::document::value> &stages);
+
+// Names of the columns of `plan` (named `column_names`) that are read from a detected ObjectId column of a mongo_scan,
+// under projections that only select or reorder columns
+unordered_set<string> MongoInsertObjectIdColumns(PhysicalOperator &plan, const vector<string> &column_names);
+
+// COPY ... TO '<catalog>.<database>.<collection>' (FORMAT mongo) into a collection of an attached MongoDB database.
+// Rows are inserted, or with KEY (columns) upserted on those columns ($set of the other columns, or the whole
+// document with REPLACE), in unordered bulk writes issued by every thread.
+CopyFunction GetMongoCopyFunction();
+
+} // namespace duckdb
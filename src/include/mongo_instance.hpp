@@ -1,6 +1,11 @@
 #pragma once
 
 #include <mongocxx/instance.hpp>
+#include <mongocxx/pool.hpp>
+#include <mongoc/mongoc.h>
+
+#include <memory>
+#include <string>
 
 namespace duckdb {
 
@@ -9,4 +14,15 @@ namespace duckdb {
 // Defined in mongo_instance.cpp to ensure only one instance exists
 mongocxx::instance &GetMongoInstance();
 
+// Get the process-wide client pool for a connection string (created on first use)
+// Pools are thread-safe, so independent requests can run concurrently on clients acquired from the same pool,
+// and connections are reused across queries instead of being set up again for every bind
+std::shared_ptr<mongocxx::pool> GetMongoClientPool(const std::string &connection_string);
+
+// Get the process-wide libmongoc client pool for a connection string, used by native cursors (created on first use)
+std::shared_ptr<mongoc_client_pool_t> GetMongoNativeClientPool(const std::string &connection_string);
+
+// Drops every pool (mongo_clear_cache); a pool closes its connections once the requests still using it are done
+void ClearMongoClientPools();
+
 } // namespace duckdb
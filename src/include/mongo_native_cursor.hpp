@@ -0,0 +1,45 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <bsoncxx/document/view.hpp>
+#include <mongocxx/options/find.hpp>
+#include <mongoc/mongoc.h>
+#include <memory>
+#include <string>
+
+namespace duckdb {
+
+// A find cursor driven through libmongoc instead of mongocxx (native_cursor). mongoc_cursor_next returns each
+// document as a bson_t pointing into the reply batch the driver received; it is wrapped in a bsoncxx view without
+// copying or allocating per document, and stays valid until the cursor advances.
+class MongoNativeCursor {
+public:
+	//! Sends the find command and reads the first document; throws IOException when the query fails
+	MongoNativeCursor(const std::string &connection_string, const std::string &database_name,
+	                  const std::string &collection_name, const bsoncxx::document::view &filter,
+	                  const mongocxx::options::find &options);
+	~MongoNativeCursor();
+
+	MongoNativeCursor(const MongoNativeCursor &) = delete;
+	MongoNativeCursor &operator=(const MongoNativeCursor &) = delete;
+
+	//! Whether the cursor points at a document
+	bool HasDocument() const {
+		return current != nullptr;
+	}
+	//! The current document, a view into the reply batch
+	bsoncxx::document::view Document() const;
+	//! Moves to the next document, sending a getMore once the batch is used up; throws IOException on errors
+	void Advance();
+
+private:
+	void Close();
+
+	std::shared_ptr<mongoc_client_pool_t> pool;
+	mongoc_client_t *client = nullptr;
+	mongoc_collection_t *collection = nullptr;
+	mongoc_cursor_t *cursor = nullptr;
+	const bson_t *current = nullptr;
+};
+
+} // namespace duckdb
@@ -1,11 +1,27 @@
 #pragma once
 
+#include "duckdb/common/column_index.hpp"
+#include "duckdb/main/config.hpp"
 #include "duckdb/optimizer/optimizer_extension.hpp"
+#include "duckdb/planner/table_filter.hpp"
+
+#include <bsoncxx/document/value.hpp>
 
 namespace duckdb {
 
 // Optimizer extension entry point (runs after built-in optimizers).
-// Rewrites eligible Mongo plans (COUNT/GROUPBY/TopN) into `mongo_scan(pipeline := ...)`.
+// Rewrites eligible Mongo plans (COUNT/GROUPBY/TopN, aggregates over joins) into `mongo_scan(pipeline := ...)`.
 void MongoOptimizerOptimize(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan);
 
+// Registers mongo_eager_aggregation
+void RegisterMongoOptimizerSettings(DBConfig &config);
+
+struct MongoScanData;
+
+// Appends the stages of an aggregation pipeline returning the documents a scan reads, given its pushed-down table
+// filters over `column_ids` (used to run CREATE TABLE AS on the server). Returns false when the scan can't be
+// expressed as a pipeline, including when a filter doesn't fully convert to a MongoDB query.
+bool BuildMongoScanPipeline(const MongoScanData &data, optional_ptr<const TableFilterSet> filters,
+                            const vector<ColumnIndex> &column_ids, vector<bsoncxx::document::value> &stages);
+
 } // namespace duckdb
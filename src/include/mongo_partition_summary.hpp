@@ -0,0 +1,64 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/mutex.hpp"
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/types/bson_value/value.hpp>
+#include <mongocxx/collection.hpp>
+#include <map>
+#include <string>
+
+namespace duckdb {
+
+// Documents of one range of consecutive _id values, with the $min and $max of each summarized field. Like in
+// $group, nulls and missing fields are skipped: both are null when no document of the range has a value.
+struct MongoPartition {
+	bsoncxx::types::bson_value::value min_id;
+	bsoncxx::types::bson_value::value max_id;
+	vector<bsoncxx::types::bson_value::value> min_values;
+	vector<bsoncxx::types::bson_value::value> max_values;
+};
+
+// Zone map of a collection (partition_summary): partitions in _id order, built with $bucketAuto on _id
+struct MongoPartitionSummary {
+	//! MongoDB paths of the summarized fields
+	vector<string> paths;
+	vector<MongoPartition> partitions;
+};
+
+// Partition summaries by connection string, collection, fields and partition count. Shared by all database
+// instances in the process, like the mongocxx instance.
+class MongoPartitionSummaryCache {
+public:
+	static MongoPartitionSummaryCache &Get();
+
+	//! The summary, only reused while the collection's change stream proves it up to date: inserts past the last _id
+	//! are summarized into a new partition, and any write that may change the summarized values or _id ranges
+	//! rebuilds it. Returns nullptr when the deployment has no change streams (a standalone server).
+	shared_ptr<const MongoPartitionSummary> GetSummary(const std::string &connection_string,
+	                                                   const std::string &database_name,
+	                                                   mongocxx::collection &collection, const vector<string> &paths,
+	                                                   idx_t partition_count);
+	//! Drops every summary (mongo_clear_cache)
+	void Clear();
+
+private:
+	struct Entry {
+		mutex lock;
+		shared_ptr<const MongoPartitionSummary> summary;
+		//! Position of the change stream the summary is up to date with
+		bsoncxx::document::value resume_token {bsoncxx::document::view()};
+	};
+
+	mutex lock;
+	std::map<std::string, shared_ptr<Entry>> entries;
+};
+
+// Sets `id_filter` to the _id ranges of the partitions whose summaries don't rule out `query_filter` (left empty when
+// no partition is ruled out). Only equality, $eq, $in and range conditions on summarized fields, at the top level or
+// under $and, are used; anything else keeps the partition. Returns false when no partition can match.
+bool MongoPrunePartitions(const MongoPartitionSummary &summary, const bsoncxx::document::view &query_filter,
+                          bsoncxx::document::value &id_filter);
+
+} // namespace duckdb
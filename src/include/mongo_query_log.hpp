@@ -0,0 +1,72 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/mutex.hpp"
+#include <chrono>
+#include <deque>
+#include <string>
+
+namespace duckdb {
+
+// One MongoDB command issued by mongo_scan that exceeded mongo_slow_query_threshold_ms
+struct MongoQueryLogEntry {
+	timestamp_t start_time;
+	std::string database_name;
+	std::string collection_name;
+	//! "find" or "aggregate"
+	std::string scan_method;
+	//! Generated filter (find) or pipeline (aggregate) as JSON
+	std::string command;
+	//! Projection document as JSON (empty when all fields are fetched)
+	std::string projection;
+	//! Time spent waiting on the server: opening the cursor and fetching batches
+	double server_ms = 0;
+	//! Time spent decoding BSON into DuckDB vectors
+	double client_ms = 0;
+	idx_t documents = 0;
+	idx_t bytes = 0;
+	//! The DuckDB query that issued the command
+	std::string query;
+};
+
+// Bounded in-memory log of slow MongoDB commands (oldest entries are evicted first).
+// Shared by all database instances in the process, like the mongocxx instance.
+class MongoQueryLog {
+public:
+	static MongoQueryLog &Get();
+
+	void Record(MongoQueryLogEntry entry, idx_t max_entries);
+	vector<MongoQueryLogEntry> GetEntries();
+
+private:
+	mutex lock;
+	std::deque<MongoQueryLogEntry> entries;
+};
+
+// Per-cursor timing and volume counters. Reported to MongoQueryLog once, when the scan state is destroyed,
+// if the total duration exceeds the threshold.
+struct MongoQueryStats {
+	using clock_t = std::chrono::steady_clock;
+
+	MongoQueryLogEntry entry;
+	int64_t threshold_ms = -1;
+	idx_t max_entries = 0;
+	clock_t::duration server_time = clock_t::duration::zero();
+	clock_t::duration client_time = clock_t::duration::zero();
+
+	~MongoQueryStats();
+};
+
+// Creates the stats tracker for a scan, or returns nullptr when the slow-query log is disabled
+unique_ptr<MongoQueryStats> MongoQueryStatsCreate(ClientContext &context, const std::string &database_name,
+                                                  const std::string &collection_name);
+
+// Registers mongo_slow_query_threshold_ms and mongo_query_log_size
+void RegisterMongoQueryLogSettings(DBConfig &config);
+
+class MongoQueryLogFunction : public TableFunction {
+public:
+	MongoQueryLogFunction();
+};
+
+} // namespace duckdb
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/mutex.hpp"
+#include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/types/bson_value/value.hpp>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+
+// One in-flight scan whose decoded chunks are read by every scan attached to it (mongo_shared_scans).
+// A chunk is produced by the first reader that needs it, outside the lock, and is never modified once published.
+// The first max_buffered_chunks chunks are kept so that scans starting slightly later can still attach; after that,
+// chunks are released once every reader has read them. A reader that is max_buffered_chunks ahead of the slowest
+// reader waits for it briefly, then detaches the slowest readers: they continue on their own cursors, after the _id
+// of the last document they read. That needs the shared cursor in _id order, which is only requested when more than
+// one reader is registered as it opens; a scan read by a single reader keeps the cursor's own order.
+class MongoSharedScan {
+public:
+	using document_id_t = bsoncxx::stdx::optional<bsoncxx::types::bson_value::value>;
+	//! Decodes the next chunk and sets last_id to the _id of its last document; returns nullptr once the cursor is
+	//! exhausted. The first call opens the cursor, in _id order when sort_by_id is set. An error that only concerns
+	//! the calling reader (its query was interrupted or timed out waiting to open the cursor) sets reader_error
+	//! before it is thrown: the producer must then be able to retry, and another reader produces the chunk instead.
+	using producer_t = std::function<unique_ptr<DataChunk>(ClientContext &context, bool sort_by_id,
+	                                                       document_id_t &last_id, bool &reader_error)>;
+
+	//! `ordered` when the cursor returns documents in _id order anyway
+	MongoSharedScan(producer_t producer, idx_t max_buffered_chunks, bool ordered);
+
+	//! Registers a reader starting at the first chunk. Fails once the first chunk was released, once the cursor was
+	//! opened for a single reader (a later reader could not be detached), and for a second reader from the same
+	//! connection (scans of one query never wait for each other).
+	bool TryAddReader(idx_t connection_id, idx_t &reader);
+	void RemoveReader(idx_t reader);
+	//! The reader's next chunk (nullptr at the end). Returns nullptr with `detached` set once the reader was
+	//! detached; `resume_after` is then the _id of the last document it read (empty when it read none). Throws the
+	//! producer's error, or InterruptException when the reader's query is interrupted while waiting.
+	//! Errors specific to the reader producing a chunk are only thrown to that reader.
+	shared_ptr<DataChunk> Next(ClientContext &context, idx_t reader, bool &detached, document_id_t &resume_after);
+
+private:
+	struct Reader {
+		idx_t connection_id;
+		//! Index of the next chunk the reader reads
+		idx_t position;
+		//! _id of the last document the reader read
+		document_id_t last_id;
+		bool detached;
+	};
+
+	//! Drops the chunks every reader has read (keeping the first ones until the buffer is full)
+	bool ReleaseReadChunks();
+
+	//! Detaches the readers at the slowest position (other than `reader`); returns whether there were any
+	bool DetachSlowestReaders(idx_t reader);
+
+	mutex lock;
+	std::condition_variable changed;
+	producer_t producer;
+	idx_t max_buffered_chunks;
+	//! Buffered chunks and the _id of their last documents; chunks.front() has index first_chunk
+	std::deque<shared_ptr<DataChunk>> chunks;
+	std::deque<document_id_t> chunk_last_ids;
+	idx_t first_chunk = 0;
+	//! Whether the cursor is (or will be opened) in _id order, so that readers can be detached
+	bool ordered;
+	//! Whether the first chunk was requested from the producer, which opened the cursor
+	bool started = false;
+	bool producing = false;
+	bool exhausted = false;
+	std::exception_ptr error;
+	std::unordered_map<idx_t, Reader> readers;
+	idx_t next_reader = 0;
+};
+
+// In-flight shared scans by key (connection, collection, generated query, projection and decoded columns).
+// Shared by all database instances in the process, like the mongocxx instance.
+class MongoSharedScanRegistry {
+public:
+	static MongoSharedScanRegistry &Get();
+
+	//! Attaches a reader to the scan registered under key. When there is none or it can't be attached to, registers
+	//! a new scan reading from create_producer(), which is only called in that case (see MongoSharedScan for
+	//! `ordered`).
+	shared_ptr<MongoSharedScan> Attach(const std::string &key, idx_t connection_id,
+	                                   const std::function<MongoSharedScan::producer_t()> &create_producer,
+	                                   idx_t max_buffered_chunks, bool ordered, idx_t &reader);
+
+private:
+	mutex lock;
+	std::unordered_map<std::string, weak_ptr<MongoSharedScan>> scans;
+};
+
+} // namespace duckdb
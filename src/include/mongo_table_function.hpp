@@ -1,11 +1,24 @@
 #pragma once
 
 #include "duckdb.hpp"
+#include "mongo_admission_control.hpp"
+#include "mongo_field_matcher.hpp"
+#include "mongo_filter_pushdown.hpp"
+#include "mongo_native_cursor.hpp"
+#include "mongo_query_log.hpp"
+#include "mongo_shared_scan.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/planner/expression.hpp"
+#include "duckdb/storage/arena_allocator.hpp"
 #include <mongocxx/client.hpp>
 #include <mongocxx/instance.hpp>
+#include <mongocxx/options/find.hpp>
 #include <bsoncxx/document/view.hpp>
 #include <bsoncxx/builder/stream/document.hpp>
 #include <bsoncxx/json.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <chrono>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -20,6 +33,32 @@ enum class SchemaMode {
 	FAILFAST       // Throw error immediately on first mismatch
 };
 
+// Bounds for schema inference on wide or deeply nested documents
+struct MongoSchemaInferenceOptions {
+	//! Sub-documents nested deeper than this are kept as a single JSON VARCHAR column
+	int max_depth = 5;
+	//! Sub-documents with more fields than this are not descended into and are kept as a single JSON VARCHAR
+	//! column (0 = unlimited). Top-level fields are always inferred.
+	idx_t max_fields_per_level = 0;
+	//! When non-empty, only these MongoDB paths (plus _id) are fetched from the sample and inferred
+	vector<std::string> include_paths;
+	//! Sub-documents with at least this many distinct keys across the sample are not flattened: they become
+	//! MAP(VARCHAR, T) when their values share a scalar type, otherwise JSON VARCHAR (0 = disabled)
+	idx_t map_key_threshold = 0;
+};
+
+// Keys and value types seen under one sub-document path while sampling, used to detect dynamic-key documents
+// (e.g. {metrics: {"host1": 1.2, "host2": 0.8, ...}}) that should not be flattened into one column per key
+struct MongoMapCandidate {
+	std::string mongo_path;
+	//! Distinct keys, collected up to map_key_threshold
+	std::unordered_set<std::string> keys;
+	//! Distinct inferred value types (null values are ignored)
+	std::vector<LogicalType> value_types;
+	//! False once a nested document or array value was seen
+	bool scalar_values = true;
+};
+
 struct MongoConnection {
 	std::string connection_string;
 	mongocxx::client client;
@@ -28,6 +67,27 @@ struct MongoConnection {
 	}
 };
 
+// Pre-resolved lookup information for one column. Built once per scan so the per-document decode path does not
+// split paths, look up the path mapping or copy column metadata for every row.
+struct MongoColumnPlan {
+	std::string column_name;
+	LogicalType column_type;
+	//! MongoDB path of the column (the column name when it has no mapping)
+	std::string mongo_path;
+	//! Whether column_name_to_mongo_path contains an entry for the column
+	bool has_mongo_path = false;
+	//! Whether mongo_path uses dot notation
+	bool nested_path = false;
+	//! mongo_path split on '.'
+	std::vector<std::string> path_segments;
+	//! column_name split on '_' (fallback lookup for unmapped nested fields)
+	std::vector<std::string> underscore_segments;
+	//! Whether the column is a scalar FlattenDocument resolves in its single pass over the raw document bytes
+	bool raw_scalar = false;
+	//! Paths of the raw_scalar columns of all plans built together (one trie shared by those plans)
+	shared_ptr<const MongoPathTrie> raw_paths;
+};
+
 struct MongoScanData : public TableFunctionData {
 	std::string connection_string;
 	shared_ptr<MongoConnection> connection;
@@ -38,6 +98,8 @@ struct MongoScanData : public TableFunctionData {
 	//! `find(...)`. Schema must be provided via `columns` for non-collection-shaped results.
 	std::string pipeline_json;
 	int64_t sample_size;
+	//! Limits applied when the schema is inferred from sampled documents
+	MongoSchemaInferenceOptions inference_options;
 	//! Schema enforcement mode: controls behavior when document fields don't match expected types
 	SchemaMode schema_mode;
 	//! Whether an explicit schema was provided (only enforce schema_mode when true)
@@ -50,6 +112,10 @@ struct MongoScanData : public TableFunctionData {
 	// e.g., "address_city" -> "address.city", "l_returnflag" -> "l_returnflag"
 	unordered_map<string, string> column_name_to_mongo_path;
 
+	// include_paths the schema was inferred from (empty when it wasn't inferred). A column above one of them was
+	// sampled with only the listed subtrees, so the scan fetches only those too.
+	vector<string> sampled_paths;
+
 	// Columns whose BSON type is k_oid (actual ObjectId), keyed by MongoDB path.
 	// Used by filter pushdown to decide whether to send bsoncxx::oid vs plain string.
 	std::unordered_set<std::string> objectid_columns;
@@ -57,12 +123,99 @@ struct MongoScanData : public TableFunctionData {
 	// Complex filter pushdown: MongoDB $expr queries for complex expressions
 	bsoncxx::document::value complex_filter_expr;
 
+	// Dotted-path prefilter for MAP key lookups (e.g. {"metrics.host1": {"$gt": 1}}).
+	// The original predicates stay in DuckDB, so this only has to be a superset of the matching documents.
+	bsoncxx::document::value map_filter_query;
+
+	// DROPMALFORMED type checks evaluated by the server (see BuildSchemaTypeFilter), so malformed documents are
+	// dropped before transfer. The client still checks every row.
+	bsoncxx::document::value schema_type_filter;
+	//! Whether schema_type_filter drops exactly the rows the client would (allows aggregate pushdown)
+	bool schema_type_filter_exact = false;
+
+	// Inferred columns whose sampled values had conflicting scalar types. With type_coercion := 'server' they are
+	// fetched through $convert, so the client decodes a single type.
+	std::unordered_set<std::string> conflicted_columns;
+	bool server_type_coercion = false;
+
+	//! Whether pipeline_json is an optimizer-generated aggregation that may be merged with others into one $facet
+	bool facet_mergeable = false;
+	//! For $facet pipelines: the same rows with the branches in $unionWith stages, run when the single $facet output
+	//! document exceeds the BSON size limit
+	std::string facet_fallback_pipeline_json;
+
+	//! 1 or -1: the find cursor returns documents sorted on _id, replacing an ORDER BY _id removed by the optimizer
+	int32_t sort_by_id = 0;
+
+	//! Worker threads decoding documents from one shared cursor (1 = the cursor is read and decoded by one thread)
+	idx_t decode_threads = 1;
+
+	//! Whether filters DuckDB evaluates above the scan are also evaluated at decode time (late_materialization)
+	bool late_materialization = false;
+	// Filters left in the plan by MongoPushdownComplexFilter, rewritten so BoundReferenceExpression i reads schema
+	// column late_filter_columns[i]. The scan decodes those columns first and the others only for documents that
+	// pass. DuckDB still evaluates the original filters, so documents passing here may be dropped later.
+	shared_ptr<Expression> late_filter;
+	vector<idx_t> late_filter_columns;
+
+	//! Whether concurrent identical find scans share one cursor and its decoded chunks (shared_scans)
+	bool shared_scans = false;
+	//! Chunks a shared scan buffers ahead of its slowest reader (mongo_shared_scan_buffer)
+	idx_t shared_scan_buffer = 8;
+
+	//! Read rate limits of the whole scan (max_docs_per_second, max_bytes_per_second; 0 = unlimited)
+	idx_t max_docs_per_second = 0;
+	idx_t max_bytes_per_second = 0;
+
+	//! Documents per server reply batch of the scan's cursor (batch_size, mongo_batch_size; 0 = server default)
+	idx_t batch_size = 0;
+	//! Whether find cursors are driven through libmongoc directly (native_cursor, mongo_native_cursor)
+	bool native_cursor = false;
+
+	//! MongoDB paths of the fields summarized per _id range (partition_summary; empty = no zone map)
+	vector<string> partition_summary_paths;
+	//! Number of _id ranges of a full summary (partition_count)
+	idx_t partition_count = 64;
+
+	// Columns added by the optimizer for projection expressions the server computes: column name -> aggregation
+	// expression, projected by the find cursor as a field of that name (see ConvertMongoComputedExpression)
+	unordered_map<string, bsoncxx::document::value> computed_columns;
+
 	MongoScanData()
 	    : sample_size(100), schema_mode(SchemaMode::PERMISSIVE), has_explicit_schema(false),
-	      complex_filter_expr(bsoncxx::builder::basic::document {}.extract()) {
+	      complex_filter_expr(bsoncxx::builder::basic::document {}.extract()),
+	      map_filter_query(bsoncxx::builder::basic::document {}.extract()),
+	      schema_type_filter(bsoncxx::builder::basic::document {}.extract()) {
 	}
 };
 
+// Token buckets limiting the documents and bytes a scan reads per second (max_docs_per_second,
+// max_bytes_per_second), shared by all threads of the scan. Each bucket holds up to one second of tokens; a reader
+// that overdraws it ends its chunk and waits until the balance is back to zero before it reads the next one, which
+// also delays the cursor's next getMore. The wait happens outside of any lock and stops when the query is
+// interrupted.
+class MongoScanThrottle {
+public:
+	using clock_t = std::chrono::steady_clock;
+
+	MongoScanThrottle(idx_t max_docs_per_second, idx_t max_bytes_per_second);
+
+	//! Takes the tokens of one document of `bytes` bytes; returns when the scan is back within its rate
+	clock_t::time_point Consume(idx_t bytes);
+	//! Sleeps until `until` in short intervals; throws InterruptException when the query is interrupted
+	static void Wait(ClientContext &context, clock_t::time_point until);
+
+private:
+	mutex lock;
+	double docs_per_second;
+	double bytes_per_second;
+	double doc_tokens;
+	double byte_tokens;
+	clock_t::time_point last_refill;
+};
+
+struct MongoScanSharedCursor;
+
 struct MongoScanState : public LocalTableFunctionState {
 	shared_ptr<MongoConnection> connection;
 	std::string database_name;
@@ -70,6 +223,16 @@ struct MongoScanState : public LocalTableFunctionState {
 	std::string filter_query;
 	std::string pipeline_json;
 	int64_t limit = -1;
+	// Rate limits shared by all states of the scan (nullptr when unlimited)
+	shared_ptr<MongoScanThrottle> throttle;
+	// When the documents read so far are back within the rate limits
+	MongoScanThrottle::clock_t::time_point throttle_until;
+	// Admission of the cursor (declared first so that the cursor is closed before the slot is released)
+	MongoAdmissionLimits admission_limits;
+	unique_ptr<MongoCursorSlot> cursor_slot;
+	// Find cursors of native_cursor scans; the mongocxx cursor below is not used then
+	bool use_native_cursor = false;
+	unique_ptr<MongoNativeCursor> native_cursor;
 	unique_ptr<mongocxx::cursor> cursor;
 	unique_ptr<mongocxx::cursor::iterator> current;
 	unique_ptr<mongocxx::cursor::iterator> end;
@@ -82,30 +245,128 @@ struct MongoScanState : public LocalTableFunctionState {
 	bsoncxx::document::value projection_document;
 	// Keep pipeline document alive for the lifetime of the cursor (aggregate path)
 	bsoncxx::document::value pipeline_document;
+	// find path: the cursor is opened by the first scan call, adding the dynamic filters populated by then
+	bool cursor_pending = false;
+	bsoncxx::document::value find_filter;
+	mongocxx::options::find find_options;
+	unique_ptr<TableFilterSet> pending_dynamic_filters;
+	// Slow-query log counters (nullptr when mongo_slow_query_threshold_ms is disabled)
+	unique_ptr<MongoQueryStats> query_stats;
+	// Decode plans for the output columns and, under schema enforcement, for the full schema
+	vector<MongoColumnPlan> output_plans;
+	vector<MongoColumnPlan> validation_plans;
+	bool plans_initialized = false;
+	// Scratch space for per-row temporaries, reset for every output chunk
+	ArenaAllocator scratch;
+	// Parallel decode: the shared cursor (nullptr when this state reads its own cursor). Documents are copied out of
+	// the cursor in batches, stored back to back in batch_data as (offset, length).
+	shared_ptr<MongoScanSharedCursor> shared;
+	std::vector<uint8_t> batch_data;
+	std::vector<std::pair<idx_t, idx_t>> batch_documents;
+	idx_t batch_position = 0;
+	//! Whether documents are read through batch_data (shared cursors and residual filters)
+	bool batched = false;
+	// Residual filters: table filters ConvertFiltersToMongoQuery could not express, which the scan must apply, and
+	// the optional late_filter. Both read residual_chunk, decoded from residual_plans before the output columns.
+	unique_ptr<Expression> residual_filter;
+	unique_ptr<Expression> late_filter;
+	vector<MongoColumnPlan> residual_plans;
+	unique_ptr<ExpressionExecutor> residual_executor;
+	unique_ptr<ExpressionExecutor> late_filter_executor;
+	DataChunk residual_chunk;
+	// Shared scan this state reads its chunks from (nullptr when it reads its own cursor)
+	shared_ptr<MongoSharedScan> shared_scan;
+	idx_t shared_scan_reader = 0;
 
 	MongoScanState()
 	    : limit(-1), finished(false), projection_document(bsoncxx::builder::basic::document {}.extract()),
-	      pipeline_document(bsoncxx::builder::basic::document {}.extract()) {
+	      pipeline_document(bsoncxx::builder::basic::document {}.extract()),
+	      find_filter(bsoncxx::builder::basic::document {}.extract()),
+	      pending_dynamic_filters(make_uniq<TableFilterSet>()), scratch(Allocator::DefaultAllocator()) {
+	}
+	~MongoScanState() override;
+};
+
+// Cursor read by all decode workers of a scan. The global state and every worker hold a reference, so the cursor
+// (and its slow-query log entry, which the workers add their timings to) outlives whichever is destroyed first.
+struct MongoScanSharedCursor {
+	mutex lock;
+	unique_ptr<MongoScanState> state;
+};
+
+// With decode_threads > 1, a single cursor is opened here and shared by all worker threads: a worker copies the
+// next batch of raw BSON out of the cursor under the lock and decodes it into its own chunk outside the lock.
+// Rows are produced in no particular order.
+struct MongoScanGlobalState : public GlobalTableFunctionState {
+	//! The shared cursor (nullptr when every thread opens its own, i.e. single-threaded scans)
+	shared_ptr<MongoScanSharedCursor> cursor;
+	idx_t max_threads = 1;
+	shared_ptr<MongoScanThrottle> throttle;
+
+	idx_t MaxThreads() const override {
+		return max_threads;
 	}
 };
 
 // Schema inference functions
+// Each schema source is split into a fetch (network) and a parse step, so bind can issue the fetches concurrently
+bsoncxx::stdx::optional<bsoncxx::document::value> FetchAtlasSchemaDocument(mongocxx::collection &collection);
+
 bool ParseSchemaFromAtlasDocument(ClientContext &context, mongocxx::collection &collection,
                                   std::vector<std::string> &column_names, std::vector<LogicalType> &column_types,
                                   std::unordered_map<std::string, std::string> &column_name_to_mongo_path);
 
+bool ParseSchemaFromAtlasDocument(ClientContext &context, const bsoncxx::document::view &schema_doc,
+                                  std::vector<std::string> &column_names, std::vector<LogicalType> &column_types,
+                                  std::unordered_map<std::string, std::string> &column_name_to_mongo_path);
+
+// listCollections entry of a collection (none when it doesn't exist or listCollections isn't permitted)
+bsoncxx::stdx::optional<bsoncxx::document::value> FetchCollectionInfo(mongocxx::database &database,
+                                                                       const std::string &collection_name);
+
+// Converts the collection's $jsonSchema validator (from listCollections) into a schema. Returns false when there is
+// no validator with properties. `enforced` is set when the server rejects non-matching documents
+// (validationLevel "strict" and validationAction "error").
+bool ParseSchemaFromJsonSchemaValidator(mongocxx::database &database, const std::string &collection_name,
+                                        int max_depth, std::vector<std::string> &column_names,
+                                        std::vector<LogicalType> &column_types,
+                                        std::unordered_map<std::string, std::string> &column_name_to_mongo_path,
+                                        bool &enforced);
+
+// Same, from a FetchCollectionInfo result. Fields typed as objectId are added to objectid_columns.
+bool ParseSchemaFromJsonSchemaValidator(const bsoncxx::document::view &collection_info, int max_depth,
+                                        std::vector<std::string> &column_names,
+                                        std::vector<LogicalType> &column_types,
+                                        std::unordered_map<std::string, std::string> &column_name_to_mongo_path,
+                                        bool &enforced, std::unordered_set<std::string> &objectid_columns);
+
 void ParseSchemaFromColumnsParameter(ClientContext &context, const Value &columns_value,
                                      std::vector<std::string> &column_names, std::vector<LogicalType> &column_types,
                                      std::unordered_map<std::string, std::string> &column_name_to_mongo_path);
 
+// Random sample used for inference ($sample, or find().limit() where $sample is unavailable)
+std::vector<bsoncxx::document::value>
+SampleDocuments(mongocxx::collection &collection, int64_t sample_size,
+                const MongoSchemaInferenceOptions &options = MongoSchemaInferenceOptions());
+
 void InferSchemaFromDocuments(mongocxx::collection &collection, int64_t sample_size,
                               std::vector<std::string> &column_names, std::vector<LogicalType> &column_types,
-                              std::unordered_map<std::string, std::string> &column_name_to_mongo_path);
+                              std::unordered_map<std::string, std::string> &column_name_to_mongo_path,
+                              const MongoSchemaInferenceOptions &options = MongoSchemaInferenceOptions());
+
+// conflicted_columns (optional) receives the scalar columns whose sampled values had more than one type
+void InferSchemaFromSample(const std::vector<bsoncxx::document::value> &sample,
+                           std::vector<std::string> &column_names, std::vector<LogicalType> &column_types,
+                           std::unordered_map<std::string, std::string> &column_name_to_mongo_path,
+                           const MongoSchemaInferenceOptions &options = MongoSchemaInferenceOptions(),
+                           std::unordered_set<std::string> *conflicted_columns = nullptr);
 
 void CollectFieldPaths(const bsoncxx::document::view &doc, const std::string &prefix, int depth,
                        std::unordered_map<std::string, std::vector<LogicalType>> &field_types,
                        std::unordered_map<std::string, std::string> &flattened_to_mongo_path,
-                       const std::string &mongo_prefix = "");
+                       const std::string &mongo_prefix = "",
+                       const MongoSchemaInferenceOptions &options = MongoSchemaInferenceOptions(),
+                       std::unordered_map<std::string, MongoMapCandidate> *map_candidates = nullptr);
 
 LogicalType InferTypeFromBSON(const bsoncxx::document::element &element);
 
@@ -117,13 +378,31 @@ SchemaMode ParseSchemaMode(const std::string &mode_str);
 // Convert schema mode to string for display
 std::string SchemaModeToString(SchemaMode mode);
 
+std::vector<MongoColumnPlan>
+BuildColumnPlans(const std::vector<std::string> &column_names, const std::vector<LogicalType> &column_types,
+                 const std::unordered_map<std::string, std::string> &column_name_to_mongo_path);
+
 // Returns true if row is valid, false if row should be skipped (DROPMALFORMED)
 // Throws exception in FAILFAST mode on schema violation
+bool FlattenDocument(const bsoncxx::document::view &doc, const std::vector<MongoColumnPlan> &columns,
+                     DataChunk &output, idx_t row_idx, SchemaMode schema_mode, bool has_explicit_schema,
+                     ArenaAllocator *scratch = nullptr);
+
 bool FlattenDocument(const bsoncxx::document::view &doc, const std::vector<std::string> &column_names,
                      const std::vector<LogicalType> &column_types, DataChunk &output, idx_t row_idx,
                      const std::unordered_map<std::string, std::string> &column_name_to_mongo_path,
                      SchemaMode schema_mode = SchemaMode::PERMISSIVE, bool has_explicit_schema = false);
 
+bool ValidateDocumentSchema(const bsoncxx::document::view &doc, const std::vector<MongoColumnPlan> &columns,
+                            SchemaMode schema_mode);
+
+// Single decode pass under schema enforcement: checks the schema columns that are not decoded (validation_columns),
+// then decodes and checks the output columns. A row dropped under DROPMALFORMED is rolled back so the next
+// document can be written to the same row. Throws under FAILFAST.
+bool FlattenAndValidateDocument(const bsoncxx::document::view &doc, const std::vector<MongoColumnPlan> &columns,
+                                const std::vector<MongoColumnPlan> &validation_columns, DataChunk &output,
+                                idx_t row_idx, SchemaMode schema_mode, ArenaAllocator *scratch = nullptr);
+
 bool ValidateDocumentSchema(const bsoncxx::document::view &doc, const std::vector<std::string> &column_names,
                             const std::vector<LogicalType> &column_types,
                             const std::unordered_map<std::string, std::string> &column_name_to_mongo_path,
@@ -132,10 +411,35 @@ bool ValidateDocumentSchema(const bsoncxx::document::view &doc, const std::vecto
 // Probe one document to discover which fields have BSON ObjectId type
 void DetectObjectIdColumns(mongocxx::collection &collection, std::unordered_set<std::string> &objectid_columns);
 
-// Projection pushdown function
+// Discover ObjectId fields from already fetched documents (e.g. the inference sample)
+void CollectObjectIdColumns(const std::vector<bsoncxx::document::value> &sample,
+                            std::unordered_set<std::string> &objectid_columns);
+
+// Projection pushdown function. Paths in convert_to are projected as {$convert: {to: <type>}} expressions, and
+// paths in computed as their computed expression. A path above some of sampled_paths projects only those.
 bsoncxx::document::value BuildMongoProjection(const vector<column_t> &column_ids,
                                               const vector<string> &all_column_names,
-                                              const unordered_map<string, string> &column_name_to_mongo_path);
+                                              const unordered_map<string, string> &column_name_to_mongo_path,
+                                              const unordered_map<string, string> &convert_to = {},
+                                              const unordered_map<string, bsoncxx::document::value> &computed = {},
+                                              const vector<string> &sampled_paths = {});
+
+// MongoDB path -> $convert target type of the conflicted columns the server converts (empty unless
+// type_coercion := 'server')
+unordered_map<string, string> GetServerTypeConversions(const MongoScanData &data);
+
+// Names of the columns GetServerTypeConversions converts. Their filters stay in DuckDB: the server would compare
+// the stored values, DuckDB sees the converted ones.
+unordered_set<string> GetServerConvertedColumns(const MongoScanData &data);
+
+// {$convert: {input: "$<path>", to: <type>, onError: "$<path>"}}: values that can't be converted are returned
+// unchanged and go through the client-side coercion. For "string", only int, long, bool and objectId values are
+// converted.
+bsoncxx::document::value BuildMongoConvertExpression(const std::string &mongo_path, const std::string &to);
+
+// Registers the mongo_scan settings (mongo_decode_threads, mongo_late_materialization, mongo_shared_scans,
+// mongo_shared_scan_buffer, mongo_batch_size, mongo_native_cursor)
+void RegisterMongoScanSettings(DBConfig &config);
 
 class MongoClearCacheFunction : public TableFunction {
 public:
@@ -1,5 +1,6 @@
 #include "mongo_catalog.hpp"
 #include "mongo_compat.hpp"
+#include "mongo_insert.hpp"
 #include "mongo_instance.hpp"
 #include "mongo_schema_entry.hpp"
 #include "mongo_secrets.hpp"
@@ -386,7 +387,30 @@ optional_ptr<SchemaCatalogEntry> MongoCatalog::LookupSchema(CatalogTransaction t
 
 PhysicalOperator &MongoCatalog::PlanCreateTableAs(ClientContext &context, PhysicalPlanGenerator &planner,
                                                   LogicalCreateTable &op, PhysicalOperator &plan) {
-	throw NotImplementedException("CREATE TABLE AS is not supported for MongoDB catalogs");
+	auto &info = op.info->Base();
+	MongoInsertTarget target;
+	target.database_name = database_name.empty() ? MongoCatalogEntryName(op.schema) : database_name;
+	if (database_name.empty() && target.database_name == "main") {
+		throw BinderException("CREATE TABLE AS in a MongoDB catalog needs a database: <catalog>.<database>.<table>");
+	}
+	target.collection_name = MongoGetTableName(info);
+	target.on_conflict = info.on_conflict;
+	for (auto &column : info.columns.Logical()) {
+		target.column_names.push_back(MongoColumnName(column));
+	}
+	target.objectid_columns = MongoInsertObjectIdColumns(plan, target.column_names);
+
+	// A query over one collection of this cluster runs entirely on the server
+	string source_database;
+	string source_collection;
+	vector<bsoncxx::document::value> stages;
+	if (BuildMongoServerInsertPipeline(plan, connection_string, target, source_database, source_collection, stages)) {
+		return planner.Make<MongoServerInsert>(op, *this, std::move(target), std::move(source_database),
+		                                       std::move(source_collection), std::move(stages));
+	}
+	auto &insert = planner.Make<MongoInsert>(op, *this, std::move(target));
+	insert.children.push_back(plan);
+	return insert;
 }
 
 PhysicalOperator &MongoCatalog::PlanInsert(ClientContext &context, PhysicalPlanGenerator &planner, LogicalInsert &op,
@@ -6,6 +6,8 @@
 #include "duckdb/main/database_manager.hpp"
 #include "duckdb/main/attached_database.hpp"
 #include "mongo_catalog.hpp"
+#include "mongo_partition_summary.hpp"
+#include "mongo_instance.hpp"
 
 namespace duckdb {
 
@@ -31,6 +33,8 @@ void MongoClearCacheFunction::ClearMongoCaches(ClientContext &context) {
 		}
 		catalog.Cast<MongoCatalog>().ClearCache();
 	}
+	MongoPartitionSummaryCache::Get().Clear();
+	ClearMongoClientPools();
 }
 
 static void ClearCacheFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
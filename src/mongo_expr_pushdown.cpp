@@ -12,12 +12,17 @@
 #include "duckdb/planner/expression/bound_comparison_expression.hpp"
 #include "duckdb/planner/expression/bound_constant_expression.hpp"
 #include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/planner/expression_iterator.hpp"
 #include "duckdb/planner/operator/logical_get.hpp"
 
 #include <bsoncxx/builder/basic/array.hpp>
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/types.hpp>
 
+#include <algorithm>
+#include <initializer_list>
+
 namespace duckdb {
 namespace {
 
@@ -420,12 +425,397 @@ static bool ConvertExpressionToMongoExpr(const Expression &expr, const vector<st
 	return false;
 }
 
+// Matches map_col['key'] (map_extract_value) or element_at(map_col, 'key')[1] on a MAP(VARCHAR, T) column and
+// returns the MongoDB dotted path of that key
+static bool GetMapKeyPath(const Expression &expr, const LogicalGet &get, const MongoScanData &data, string &out_path,
+                          LogicalType &out_value_type) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &func_expr = expr.Cast<BoundFunctionExpression>();
+	const auto func_name = StringUtil::Lower(MONGO_FUNCTION_NAME(MongoFuncFunction(func_expr)));
+	const BoundFunctionExpression *lookup = nullptr;
+	if (func_name == "map_extract_value") {
+		lookup = &func_expr;
+	} else if (func_name == "array_extract" || func_name == "list_extract") {
+		// element_at/map_extract return a list holding the value
+		const auto &children = MongoFuncChildren(func_expr);
+		if (children.size() != 2 || children[0]->GetExpressionClass() != ExpressionClass::BOUND_FUNCTION ||
+		    children[1]->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+			return false;
+		}
+		auto index = MongoConstantValue(children[1]->Cast<BoundConstantExpression>());
+		if (index.IsNull() || index.GetValue<int64_t>() != 1) {
+			return false;
+		}
+		auto &inner_expr = children[0]->Cast<BoundFunctionExpression>();
+		const auto inner_name = StringUtil::Lower(MONGO_FUNCTION_NAME(MongoFuncFunction(inner_expr)));
+		if (inner_name == "element_at" || inner_name == "map_extract") {
+			lookup = &inner_expr;
+		}
+	}
+	if (!lookup) {
+		return false;
+	}
+
+	const auto &args = MongoFuncChildren(*lookup);
+	if (args.size() != 2 || args[0]->GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF ||
+	    args[1]->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		return false;
+	}
+	const auto &binding = MongoColumnBinding(args[0]->Cast<BoundColumnRefExpression>());
+	auto &column_ids = get.GetColumnIds();
+	if (binding.table_index != get.table_index || binding.column_index >= column_ids.size()) {
+		return false;
+	}
+	idx_t col_idx = column_ids[binding.column_index].GetPrimaryIndex();
+	if (col_idx >= data.column_names.size()) {
+		return false;
+	}
+	const auto &column_type = data.column_types[col_idx];
+	if (column_type.id() != LogicalTypeId::MAP || MapType::KeyType(column_type).id() != LogicalTypeId::VARCHAR) {
+		return false;
+	}
+
+	// Keys that MongoDB would read as a nested path or an operator can't be expressed with dot notation
+	auto key = MongoConstantValue(args[1]->Cast<BoundConstantExpression>());
+	if (key.IsNull() || key.type().id() != LogicalTypeId::VARCHAR) {
+		return false;
+	}
+	auto key_str = key.GetValue<string>();
+	if (key_str.empty() || key_str.find('.') != string::npos || key_str[0] == '$') {
+		return false;
+	}
+
+	const auto &column_name = data.column_names[col_idx];
+	auto path_it = data.column_name_to_mongo_path.find(column_name);
+	const string &column_path = path_it != data.column_name_to_mongo_path.end() ? path_it->second : column_name;
+	out_path = column_path + "." + key_str;
+	out_value_type = MapType::ValueType(column_type);
+	return true;
+}
+
+// BSON types of a map value that the server compares like DuckDB compares the decoded value. The scan decodes the
+// others differently (VARCHAR maps stringify numbers, BIGINT maps truncate doubles), so they are not filtered.
+static vector<const char *> MapValueComparableTypes(LogicalTypeId type_id) {
+	switch (type_id) {
+	case LogicalTypeId::VARCHAR:
+		return {"string"};
+	case LogicalTypeId::BIGINT:
+		return {"int", "long"};
+	case LogicalTypeId::DOUBLE:
+		return {"int", "long", "double", "decimal"};
+	case LogicalTypeId::BOOLEAN:
+		return {"bool"};
+	case LogicalTypeId::DATE:
+	case LogicalTypeId::TIMESTAMP:
+		return {"date"};
+	default:
+		return {};
+	}
+}
+
+// Converts `map_col['key'] <op> constant` into a native query on "path.key". The result is used as a prefilter only
+// (the expression stays in the plan), so it only needs to match a superset of the qualifying documents: values of a
+// type the server compares differently are always kept, {$or: [<comparison>, {path: {$not: {$type: [...]}}}]}.
+static bool ConvertMapKeyComparison(const Expression &expr, const LogicalGet &get, const MongoScanData &data,
+                                    vector<bsoncxx::document::value> &map_filters) {
+	if (!MongoIsComparisonExpr(expr) || expr.IsVolatile()) {
+		return false;
+	}
+	auto comparison_type = expr.GetExpressionType();
+	const Expression *lookup_expr = &MongoComparisonLeft(expr);
+	const Expression *constant_expr = &MongoComparisonRight(expr);
+	if (constant_expr->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		std::swap(lookup_expr, constant_expr);
+		comparison_type = FlipComparisonExpression(comparison_type);
+	}
+	if (constant_expr->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		return false;
+	}
+	switch (comparison_type) {
+	case ExpressionType::COMPARE_EQUAL:
+	case ExpressionType::COMPARE_NOTEQUAL:
+	case ExpressionType::COMPARE_LESSTHAN:
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+	case ExpressionType::COMPARE_GREATERTHAN:
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		break;
+	default:
+		return false;
+	}
+
+	string mongo_path;
+	LogicalType value_type;
+	if (!GetMapKeyPath(*lookup_expr, get, data, mongo_path, value_type)) {
+		return false;
+	}
+	auto constant = MongoConstantValue(constant_expr->Cast<BoundConstantExpression>());
+	Value casted_constant;
+	string error_message;
+	if (constant.IsNull() || !constant.DefaultTryCastAs(value_type, casted_constant, &error_message, true)) {
+		return false;
+	}
+	auto comparable_types = MapValueComparableTypes(value_type.id());
+	if (comparable_types.empty()) {
+		return false;
+	}
+	auto filter_doc = BuildMongoPathComparison(comparison_type, casted_constant, mongo_path, value_type);
+	if (filter_doc.view().empty()) {
+		return false;
+	}
+	using bsoncxx::builder::basic::kvp;
+	bsoncxx::builder::basic::array type_names;
+	for (auto type_name : comparable_types) {
+		type_names.append(type_name);
+	}
+	auto other_type = bsoncxx::builder::basic::make_document(kvp("$type", type_names.extract()));
+	auto other_type_value =
+	    bsoncxx::builder::basic::make_document(kvp(mongo_path, bsoncxx::builder::basic::make_document(
+	                                                               kvp("$not", other_type.view()))));
+	bsoncxx::builder::basic::array alternatives;
+	alternatives.append(filter_doc.view());
+	alternatives.append(other_type_value.view());
+	map_filters.push_back(bsoncxx::builder::basic::make_document(kvp("$or", alternatives.extract())));
+	return true;
+}
+
+// Computed-field operator of a DuckDB function, with the argument and result types it is pushed for
+struct MongoComputedFunction {
+	const char *duckdb_name;
+	const char *mongo_operator;
+	LogicalTypeId arg_type;
+	LogicalTypeId return_type;
+};
+
+static const MongoComputedFunction MONGO_COMPUTED_FUNCTIONS[] = {
+    {"+", "$add", LogicalTypeId::DOUBLE, LogicalTypeId::DOUBLE},
+    {"-", "$subtract", LogicalTypeId::DOUBLE, LogicalTypeId::DOUBLE},
+    {"*", "$multiply", LogicalTypeId::DOUBLE, LogicalTypeId::DOUBLE},
+    {"||", "$concat", LogicalTypeId::VARCHAR, LogicalTypeId::VARCHAR},
+    {"concat", "$concat", LogicalTypeId::VARCHAR, LogicalTypeId::VARCHAR},
+};
+
+// {$cond: [{$in: [{$type: <field>}, [<types>]]}, <value>, null]}
+template <class VALUE>
+static bsoncxx::document::value BuildTypeGuard(const string &field, std::initializer_list<const char *> types,
+                                               VALUE &&value) {
+	using bsoncxx::builder::basic::kvp;
+	bsoncxx::builder::basic::array type_names;
+	for (auto type : types) {
+		type_names.append(type);
+	}
+	bsoncxx::builder::basic::array in_args;
+	in_args.append(bsoncxx::builder::basic::make_document(kvp("$type", field)));
+	in_args.append(type_names.extract());
+	bsoncxx::builder::basic::array cond_args;
+	cond_args.append(bsoncxx::builder::basic::make_document(kvp("$in", in_args.extract())));
+	cond_args.append(std::forward<VALUE>(value));
+	cond_args.append(bsoncxx::types::b_null {});
+	return bsoncxx::builder::basic::make_document(kvp("$cond", cond_args.extract()));
+}
+
+// A column is read as the value the scan would decode, so that the server computes what DuckDB would: DOUBLE from
+// the numeric BSON types, VARCHAR from strings only. The scan decodes other types as NULL for DOUBLE columns, but as
+// text for VARCHAR columns, which only matters for values of a type the schema sample didn't see. Other column types
+// are not read: the server doesn't reproduce their decoding (for example doubles truncated in BIGINT columns).
+static bool ConvertComputedColumn(const BoundColumnRefExpression &colref, const LogicalGet &get,
+                                  const MongoScanData &data, bsoncxx::document::value &out) {
+	using bsoncxx::builder::basic::kvp;
+	const auto &binding = MongoColumnBinding(colref);
+	if (binding.table_index != get.table_index) {
+		return false;
+	}
+	idx_t position = binding.column_index;
+	if (!get.projection_ids.empty()) {
+		if (position >= get.projection_ids.size()) {
+			return false;
+		}
+		position = get.projection_ids[position];
+	}
+	auto &column_ids = get.GetColumnIds();
+	if (position >= column_ids.size()) {
+		return false;
+	}
+	idx_t col_idx = column_ids[position].GetPrimaryIndex();
+	if (col_idx >= data.column_names.size()) {
+		return false;
+	}
+	const auto &column_name = data.column_names[col_idx];
+	if (data.conflicted_columns.count(column_name) || data.computed_columns.count(column_name)) {
+		return false;
+	}
+	auto path_it = data.column_name_to_mongo_path.find(column_name);
+	const string &path = path_it != data.column_name_to_mongo_path.end() ? path_it->second : column_name;
+	if (path.empty() || path[0] == '$') {
+		return false;
+	}
+	auto field = "$" + path;
+
+	switch (data.column_types[col_idx].id()) {
+	case LogicalTypeId::DOUBLE: {
+		auto to_double = bsoncxx::builder::basic::make_document(kvp("$toDouble", field));
+		out = BuildTypeGuard(field, {"double", "int", "long", "decimal"}, to_double.view());
+		return true;
+	}
+	case LogicalTypeId::VARCHAR:
+		// ObjectIds are decoded as hex strings
+		if (data.objectid_columns.count(path)) {
+			return false;
+		}
+		out = BuildTypeGuard(field, {"string"}, field);
+		return true;
+	default:
+		return false;
+	}
+}
+
+// Constants are wrapped in $literal, so that strings starting with '$' are not read as field paths
+static bool ConvertComputedConstant(const BoundConstantExpression &constant, bsoncxx::document::value &out) {
+	using bsoncxx::builder::basic::kvp;
+	const Value &value = MongoConstantValue(constant);
+	if (value.IsNull()) {
+		return false;
+	}
+	switch (value.type().id()) {
+	case LogicalTypeId::VARCHAR:
+		out = bsoncxx::builder::basic::make_document(kvp("$literal", StringValue::Get(value)));
+		return true;
+	case LogicalTypeId::INTEGER:
+	case LogicalTypeId::BIGINT:
+		out = bsoncxx::builder::basic::make_document(kvp("$literal", value.GetValue<int64_t>()));
+		return true;
+	case LogicalTypeId::DOUBLE:
+		out = bsoncxx::builder::basic::make_document(kvp("$literal", value.GetValue<double>()));
+		return true;
+	default:
+		return false;
+	}
+}
+
+static bool ConvertComputedNode(const Expression &expr, const LogicalGet &get, const MongoScanData &data,
+                                bsoncxx::document::value &out) {
+	using bsoncxx::builder::basic::kvp;
+	switch (expr.GetExpressionClass()) {
+	case ExpressionClass::BOUND_COLUMN_REF:
+		return ConvertComputedColumn(expr.Cast<BoundColumnRefExpression>(), get, data, out);
+	case ExpressionClass::BOUND_CONSTANT:
+		return ConvertComputedConstant(expr.Cast<BoundConstantExpression>(), out);
+	case ExpressionClass::BOUND_CAST: {
+		// Integer constants widened to DOUBLE for arithmetic (integer columns are not read)
+		auto &child = *MongoCastChild(expr.Cast<BoundCastExpression>());
+		auto child_type = MONGO_EXPR_RETURN_TYPE(child).id();
+		if (MONGO_EXPR_RETURN_TYPE(expr).id() != LogicalTypeId::DOUBLE ||
+		    (child_type != LogicalTypeId::INTEGER && child_type != LogicalTypeId::BIGINT)) {
+			return false;
+		}
+		bsoncxx::document::value operand = bsoncxx::builder::basic::document {}.extract();
+		if (!ConvertComputedNode(child, get, data, operand)) {
+			return false;
+		}
+		out = bsoncxx::builder::basic::make_document(kvp("$toDouble", operand.view()));
+		return true;
+	}
+	case ExpressionClass::BOUND_FUNCTION:
+		break;
+	default:
+		return false;
+	}
+
+	auto &func_expr = expr.Cast<BoundFunctionExpression>();
+	const auto func_name = StringUtil::Lower(MONGO_FUNCTION_NAME(MongoFuncFunction(func_expr)));
+	const auto &children = MongoFuncChildren(func_expr);
+	const MongoComputedFunction *function = nullptr;
+	for (auto &candidate : MONGO_COMPUTED_FUNCTIONS) {
+		if (func_name == candidate.duckdb_name) {
+			function = &candidate;
+			break;
+		}
+	}
+	if (!function || children.empty() || MONGO_EXPR_RETURN_TYPE(expr).id() != function->return_type) {
+		return false;
+	}
+	const bool concat = function->mongo_operator == string("$concat");
+	if (!concat && children.size() != 2) {
+		return false;
+	}
+
+	bsoncxx::builder::basic::array args;
+	for (auto &child : children) {
+		auto child_type = MONGO_EXPR_RETURN_TYPE(*child).id();
+		if (child_type != function->arg_type) {
+			return false;
+		}
+		bsoncxx::document::value operand = bsoncxx::builder::basic::document {}.extract();
+		if (!ConvertComputedNode(*child, get, data, operand)) {
+			return false;
+		}
+		if (func_name == "concat") {
+			// concat() skips NULL arguments, where $concat (like ||) returns null
+			bsoncxx::builder::basic::array if_null_args;
+			if_null_args.append(operand.view());
+			if_null_args.append("");
+			args.append(bsoncxx::builder::basic::make_document(kvp("$ifNull", if_null_args.extract())));
+		} else {
+			args.append(operand.view());
+		}
+	}
+	out = bsoncxx::builder::basic::make_document(kvp(function->mongo_operator, args.extract()));
+	return true;
+}
+
 } // namespace
 
+bool ConvertMongoComputedExpression(const Expression &expr, const LogicalGet &get, const MongoScanData &data,
+                                    bsoncxx::document::value &out) {
+	// Columns and constants are read as they are
+	if (expr.IsVolatile() || expr.GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF ||
+	    expr.GetExpressionClass() == ExpressionClass::BOUND_CONSTANT) {
+		return false;
+	}
+	return ConvertComputedNode(expr, get, data, out);
+}
+
 // Main complex filter pushdown function
 // This is called before TableFilter conversion. We intentionally skip simple
 // column-to-constant comparisons here so they can be handled by TableFilter conversion,
 // which produces faster MongoDB native queries.
+// Rewrites the column references of a filter into BoundReferenceExpressions over `columns` (schema column indices,
+// extended with the columns seen for the first time). Fails for references to other tables, virtual columns and
+// subqueries.
+static bool BindLateFilterColumns(unique_ptr<Expression> &expr, LogicalGet &get, idx_t column_count,
+                                  vector<idx_t> &columns) {
+	if (expr->GetExpressionClass() == ExpressionClass::BOUND_SUBQUERY) {
+		return false;
+	}
+	if (expr->GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF) {
+		const auto &binding = MongoColumnBinding(expr->Cast<BoundColumnRefExpression>());
+		auto &column_ids = get.GetColumnIds();
+		if (binding.table_index != get.table_index || binding.column_index >= column_ids.size()) {
+			return false;
+		}
+		idx_t col_idx = column_ids[binding.column_index].GetPrimaryIndex();
+		if (col_idx >= column_count) {
+			return false;
+		}
+		auto position = std::find(columns.begin(), columns.end(), col_idx);
+		if (position == columns.end()) {
+			columns.push_back(col_idx);
+			position = columns.end() - 1;
+		}
+		auto return_type = MONGO_EXPR_RETURN_TYPE(*expr);
+		expr = make_uniq<BoundReferenceExpression>(return_type, idx_t(position - columns.begin()));
+		return true;
+	}
+	bool bound = true;
+	ExpressionIterator::EnumerateChildren(*expr, [&](unique_ptr<Expression> &child) {
+		if (bound) {
+			bound = BindLateFilterColumns(child, get, column_count, columns);
+		}
+	});
+	return bound;
+}
+
 void MongoPushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data,
                                 vector<unique_ptr<Expression>> &filters) {
 	auto &mongo_data = bind_data->Cast<MongoScanData>();
@@ -433,11 +823,18 @@ void MongoPushdownComplexFilter(ClientContext &context, LogicalGet &get, Functio
 	// Build MongoDB $expr document for complex filters
 	bsoncxx::builder::basic::document expr_builder;
 	bool has_complex_filter = false;
+	vector<bsoncxx::document::value> map_filters;
 
 	// Process each filter expression
 	for (auto it = filters.begin(); it != filters.end();) {
 		auto &filter_expr = *it;
 
+		// MAP key lookups become a dotted-path prefilter; the filter itself is kept for DuckDB
+		if (ConvertMapKeyComparison(*filter_expr, get, mongo_data, map_filters)) {
+			++it;
+			continue;
+		}
+
 		// Early exit for simple filters - skip expensive conversion attempt
 		// This avoids overhead from ConvertExpressionToMongoExpr for filters that
 		// will be handled by TableFilter conversion anyway
@@ -483,6 +880,47 @@ void MongoPushdownComplexFilter(ClientContext &context, LogicalGet &get, Functio
 	if (has_complex_filter) {
 		mongo_data.complex_filter_expr = expr_builder.extract();
 	}
+
+	if (map_filters.size() == 1) {
+		mongo_data.map_filter_query = std::move(map_filters[0]);
+	} else if (map_filters.size() > 1) {
+		bsoncxx::builder::basic::array and_terms;
+		for (auto &map_filter : map_filters) {
+			and_terms.append(map_filter.view());
+		}
+		bsoncxx::builder::basic::document and_query;
+		and_query.append(bsoncxx::builder::basic::kvp("$and", and_terms.extract()));
+		mongo_data.map_filter_query = and_query.extract();
+	}
+
+	// Late materialization: the filters DuckDB keeps are also evaluated while decoding, on their own columns first.
+	// Volatile filters would give different answers the second time, so they are only evaluated by DuckDB.
+	if (!mongo_data.late_materialization || !mongo_data.pipeline_json.empty()) {
+		return;
+	}
+	unique_ptr<Expression> late_filter;
+	vector<idx_t> late_columns;
+	for (auto &filter_expr : filters) {
+		if (filter_expr->IsVolatile()) {
+			continue;
+		}
+		auto late_expr = filter_expr->Copy();
+		auto columns = late_columns;
+		if (!BindLateFilterColumns(late_expr, get, mongo_data.column_names.size(), columns)) {
+			continue;
+		}
+		late_columns = std::move(columns);
+		if (late_filter) {
+			late_filter = make_uniq<BoundConjunctionExpression>(ExpressionType::CONJUNCTION_AND,
+			                                                     std::move(late_filter), std::move(late_expr));
+		} else {
+			late_filter = std::move(late_expr);
+		}
+	}
+	if (late_filter) {
+		mongo_data.late_filter = shared_ptr<Expression>(std::move(late_filter));
+		mongo_data.late_filter_columns = std::move(late_columns);
+	}
 }
 
 } // namespace duckdb
@@ -3,7 +3,10 @@
 #include "mongo_extension.hpp"
 #include "mongo_storage_extension.hpp"
 #include "mongo_instance.hpp"
+#include "mongo_insert.hpp"
 #include "mongo_table_function.hpp"
+#include "mongo_query_log.hpp"
+#include "mongo_admission_control.hpp"
 #include "mongo_expr_pushdown.hpp"
 #include "mongo_optimizer.hpp"
 #include "mongo_secrets.hpp"
@@ -26,6 +29,7 @@ namespace duckdb {
 // Forward declarations (functions are defined in mongo_table_function.cpp)
 unique_ptr<FunctionData> MongoScanBind(ClientContext &context, TableFunctionBindInput &input,
                                        vector<LogicalType> &return_types, vector<string> &names);
+unique_ptr<GlobalTableFunctionState> MongoScanInitGlobal(ClientContext &context, TableFunctionInitInput &input);
 unique_ptr<LocalTableFunctionState> MongoScanInitLocal(ExecutionContext &context, TableFunctionInitInput &input,
                                                        GlobalTableFunctionState *global_state);
 void MongoScanFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output);
@@ -34,7 +38,7 @@ InsertionOrderPreservingMap<string> MongoScanToString(TableFunctionToStringInput
 static void LoadInternal(ExtensionLoader &loader) {
 	// Register MongoDB table function
 	TableFunction mongo_scan("mongo_scan", {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR},
-	                         MongoScanFunction, MongoScanBind, nullptr, MongoScanInitLocal);
+	                         MongoScanFunction, MongoScanBind, MongoScanInitGlobal, MongoScanInitLocal);
 
 	// Add optional parameters
 	mongo_scan.named_parameters["filter"] = LogicalType::VARCHAR;
@@ -42,6 +46,21 @@ static void LoadInternal(ExtensionLoader &loader) {
 	mongo_scan.named_parameters["columns"] = LogicalType::ANY;
 	mongo_scan.named_parameters["pipeline"] = LogicalType::VARCHAR;
 	mongo_scan.named_parameters["schema_mode"] = LogicalType::VARCHAR;
+	mongo_scan.named_parameters["max_depth"] = LogicalType::BIGINT;
+	mongo_scan.named_parameters["max_fields_per_level"] = LogicalType::BIGINT;
+	mongo_scan.named_parameters["map_key_threshold"] = LogicalType::BIGINT;
+	mongo_scan.named_parameters["include_paths"] = LogicalType::LIST(LogicalType::VARCHAR);
+	mongo_scan.named_parameters["use_validator"] = LogicalType::BOOLEAN;
+	mongo_scan.named_parameters["type_coercion"] = LogicalType::VARCHAR;
+	mongo_scan.named_parameters["decode_threads"] = LogicalType::BIGINT;
+	mongo_scan.named_parameters["late_materialization"] = LogicalType::BOOLEAN;
+	mongo_scan.named_parameters["shared_scans"] = LogicalType::BOOLEAN;
+	mongo_scan.named_parameters["max_docs_per_second"] = LogicalType::BIGINT;
+	mongo_scan.named_parameters["max_bytes_per_second"] = LogicalType::BIGINT;
+	mongo_scan.named_parameters["batch_size"] = LogicalType::BIGINT;
+	mongo_scan.named_parameters["native_cursor"] = LogicalType::BOOLEAN;
+	mongo_scan.named_parameters["partition_summary"] = LogicalType::LIST(LogicalType::VARCHAR);
+	mongo_scan.named_parameters["partition_count"] = LogicalType::BIGINT;
 
 	// Enable filter pushdown
 	mongo_scan.filter_pushdown = true;
@@ -97,6 +116,49 @@ static void LoadInternal(ExtensionLoader &loader) {
 	// Register the table function
 	loader.RegisterFunction(std::move(clear_cache_info));
 
+	// Register MongoDB slow-query log function
+	MongoQueryLogFunction query_log_func;
+	TableFunctionSet query_log_set("mongo_query_log");
+	query_log_set.AddFunction(std::move(query_log_func));
+	CreateTableFunctionInfo query_log_info(std::move(query_log_set));
+
+	// Set description
+	FunctionDescription query_log_desc;
+	query_log_desc.description = "Lists MongoDB commands issued by mongo_scan that exceeded "
+	                             "mongo_slow_query_threshold_ms, with server/client timings and volumes.";
+	query_log_desc.examples.push_back("SET mongo_slow_query_threshold_ms = 100");
+	query_log_desc.examples.push_back("SELECT * FROM mongo_query_log() ORDER BY start_time DESC");
+	query_log_info.descriptions.push_back(std::move(query_log_desc));
+
+	// Set comment
+	query_log_info.comment = Value("Slow-query log for MongoDB commands generated by mongo_scan and ATTACH.");
+
+	// Register the table function
+	loader.RegisterFunction(std::move(query_log_info));
+
+	// Register MongoDB connections function
+	MongoConnectionsFunction connections_func;
+	TableFunctionSet connections_set("mongo_connections");
+	connections_set.AddFunction(std::move(connections_func));
+	CreateTableFunctionInfo connections_info(std::move(connections_set));
+
+	// Set description
+	FunctionDescription connections_desc;
+	connections_desc.description = "Lists the connection strings mongo_scan opened cursors on, with active and "
+	                               "waiting cursors under mongo_max_concurrent_cursors and mongo_max_in_flight_bytes.";
+	connections_desc.examples.push_back("SET mongo_max_concurrent_cursors = 16");
+	connections_desc.examples.push_back("SELECT * FROM mongo_connections()");
+	connections_info.descriptions.push_back(std::move(connections_desc));
+
+	// Set comment
+	connections_info.comment = Value("Admission control state of MongoDB cursors, per connection string.");
+
+	// Register the table function
+	loader.RegisterFunction(std::move(connections_info));
+
+	// Register COPY ... TO (FORMAT mongo)
+	loader.RegisterFunction(GetMongoCopyFunction());
+
 	// Register MongoDB secret type
 	SecretType secret_type;
 	secret_type.name = "mongo";
@@ -112,6 +174,10 @@ static void LoadInternal(ExtensionLoader &loader) {
 	// Register MongoDB storage extension for ATTACH support
 	auto &db = loader.GetDatabaseInstance();
 	auto &config = DBConfig::GetConfig(db);
+	RegisterMongoQueryLogSettings(config);
+	RegisterMongoAdmissionSettings(config);
+	RegisterMongoScanSettings(config);
+	RegisterMongoOptimizerSettings(config);
 #if DUCKDB_HAS_EXTENSION_CALLBACK_MANAGER
 	auto storage_extension = MongoStorageExtension::Create();
 	shared_ptr<StorageExtension> storage_extension_ptr = std::move(storage_extension);
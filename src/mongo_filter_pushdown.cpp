@@ -8,6 +8,7 @@
 #include "duckdb/planner/filter/null_filter.hpp"
 #include "duckdb/planner/filter/optional_filter.hpp"
 #include "duckdb/planner/filter/struct_filter.hpp"
+#include "duckdb/common/string_util.hpp"
 #include "duckdb/common/types/date.hpp"
 #include "duckdb/common/types/time.hpp"
 #include "duckdb/common/types/timestamp.hpp"
@@ -282,9 +283,11 @@ static bsoncxx::document::value ConvertSingleFilterToMongo(const TableFilter &fi
 				}
 			}
 			auto child_doc = ConvertSingleFilterToMongo(*child_filter, column_name, column_type, objectid_columns);
-			if (!child_doc.view().empty()) {
-				or_array.append(child_doc.view());
+			if (child_doc.view().empty()) {
+				// Dropping an alternative would make the $or stricter: leave the whole OR to the residual filter
+				return doc.extract();
 			}
+			or_array.append(child_doc.view());
 		}
 		if (!or_array.view().empty()) {
 			doc.append(bsoncxx::builder::basic::kvp("$or", or_array.extract()));
@@ -308,10 +311,12 @@ static bsoncxx::document::value ConvertSingleFilterToMongo(const TableFilter &fi
 	}
 	case TableFilterType::DYNAMIC_FILTER: {
 		const auto &dyn_filter = filter.Cast<DynamicFilter>();
-		if (!dyn_filter.filter_data || !dyn_filter.filter_data->initialized) {
+		if (!dyn_filter.filter_data) {
 			break;
 		}
-		if (!dyn_filter.filter_data->filter) {
+		// Top-N boundaries keep changing while the query runs
+		lock_guard<mutex> guard(dyn_filter.filter_data->lock);
+		if (!dyn_filter.filter_data->initialized || !dyn_filter.filter_data->filter) {
 			break;
 		}
 		return ConvertSingleFilterToMongo(*dyn_filter.filter_data->filter, column_name, column_type, objectid_columns);
@@ -394,9 +399,10 @@ static bsoncxx::document::value ConvertSingleFilterToMongo(const TableFilter &fi
 				for (auto &child : MongoConjunctionChildren(conj)) {
 					ExpressionFilter child_ef(child->Copy());
 					auto child_doc = ConvertSingleFilterToMongo(child_ef, column_name, column_type, objectid_columns);
-					if (!child_doc.view().empty()) {
-						or_array.append(child_doc.view());
+					if (child_doc.view().empty()) {
+						return doc.extract();
 					}
+					or_array.append(child_doc.view());
 				}
 				if (!or_array.view().empty()) {
 					doc.append(bsoncxx::builder::basic::kvp("$or", or_array.extract()));
@@ -428,13 +434,60 @@ static bsoncxx::document::value ConvertSingleFilterToMongo(const TableFilter &fi
 	return doc.extract();
 }
 
+// Whether ConvertSingleFilterToMongo expresses the whole filter. AND/OR children it can't convert are dropped,
+// which makes the MongoDB query looser (AND) or stricter (OR) than the filter. Optional and dynamic filters only
+// prune, so skipping them never changes the result.
+static bool IsFilterFullyConverted(const TableFilter &filter, const string &column_name,
+                                   const LogicalType &column_type, const unordered_set<string> &objectid_columns) {
+	switch (filter.filter_type) {
+#ifndef DUCKDB_MAIN_VECTOR_API
+	case TableFilterType::OPTIONAL_FILTER:
+	case TableFilterType::DYNAMIC_FILTER:
+		return true;
+	case TableFilterType::CONJUNCTION_AND:
+	case TableFilterType::CONJUNCTION_OR: {
+		const auto &conj_filter = static_cast<const ConjunctionFilter &>(filter);
+		for (const auto &child_filter : conj_filter.child_filters) {
+			if (!IsFilterFullyConverted(*child_filter, column_name, column_type, objectid_columns)) {
+				return false;
+			}
+		}
+		if (conj_filter.child_filters.empty()) {
+			return false;
+		}
+		if (filter.filter_type == TableFilterType::CONJUNCTION_AND) {
+			return true;
+		}
+		// Optional children are fully converted but may produce nothing, which leaves the whole OR out
+		break;
+	}
+	case TableFilterType::STRUCT_EXTRACT: {
+		const auto &struct_filter = filter.Cast<StructFilter>();
+		return struct_filter.child_filter &&
+		       IsFilterFullyConverted(*struct_filter.child_filter, column_name + "." + struct_filter.child_name,
+		                              column_type, objectid_columns);
+	}
+#else
+	case TableFilterType::EXPRESSION_FILTER:
+		if (ExpressionFilter::IsOptionalFilter(filter)) {
+			return true;
+		}
+		break;
+#endif
+	default:
+		break;
+	}
+	return !ConvertSingleFilterToMongo(filter, column_name, column_type, objectid_columns).view().empty();
+}
+
 } // namespace
 
 bsoncxx::document::value ConvertFiltersToMongoQuery(optional_ptr<TableFilterSet> filters,
                                                     const std::vector<string> &column_names,
                                                     const std::vector<LogicalType> &column_types,
                                                     const std::unordered_map<string, string> &column_name_to_mongo_path,
-                                                    const std::unordered_set<string> &objectid_columns) {
+                                                    const std::unordered_set<string> &objectid_columns,
+                                                    const std::unordered_set<string> &client_filter_columns) {
 	if (!filters || !MongoHasFilters(*filters)) {
 		return bsoncxx::builder::basic::document {}.extract();
 	}
@@ -445,7 +498,7 @@ bsoncxx::document::value ConvertFiltersToMongoQuery(optional_ptr<TableFilterSet>
 
 	// Process each filter
 	MongoForEachFilter(*filters, [&](idx_t col_idx, TableFilter &filter_ref) {
-		if (col_idx >= column_names.size()) {
+		if (col_idx >= column_names.size() || client_filter_columns.count(column_names[col_idx])) {
 			return;
 		}
 
@@ -542,4 +595,158 @@ bsoncxx::document::value ConvertFiltersToMongoQuery(optional_ptr<TableFilterSet>
 	return and_query.extract();
 }
 
+vector<idx_t> GetResidualFilterColumns(TableFilterSet &filters, const std::vector<string> &column_names,
+                                       const std::vector<LogicalType> &column_types,
+                                       const std::unordered_map<string, string> &column_name_to_mongo_path,
+                                       const std::unordered_set<string> &objectid_columns,
+                                       const std::unordered_set<string> &client_filter_columns) {
+	vector<idx_t> result;
+	MongoForEachFilter(filters, [&](idx_t col_idx, TableFilter &filter_ref) {
+		if (col_idx >= column_names.size()) {
+			return;
+		}
+		if (client_filter_columns.count(column_names[col_idx])) {
+			result.push_back(col_idx);
+			return;
+		}
+		auto path_it = column_name_to_mongo_path.find(column_names[col_idx]);
+		const string &mongo_column_name =
+		    path_it != column_name_to_mongo_path.end() ? path_it->second : column_names[col_idx];
+		if (!IsFilterFullyConverted(filter_ref, mongo_column_name, column_types[col_idx], objectid_columns)) {
+			result.push_back(col_idx);
+		}
+	});
+	return result;
+}
+
+bool IsPendingDynamicFilter(const TableFilter &filter) {
+#ifndef DUCKDB_MAIN_VECTOR_API
+	switch (filter.filter_type) {
+	case TableFilterType::OPTIONAL_FILTER: {
+		const auto &opt_filter = filter.Cast<OptionalFilter>();
+		return opt_filter.child_filter && IsPendingDynamicFilter(*opt_filter.child_filter);
+	}
+	case TableFilterType::DYNAMIC_FILTER: {
+		const auto &dyn_filter = filter.Cast<DynamicFilter>();
+		if (!dyn_filter.filter_data) {
+			return false;
+		}
+		lock_guard<mutex> guard(dyn_filter.filter_data->lock);
+		return !dyn_filter.filter_data->initialized || !dyn_filter.filter_data->filter;
+	}
+	default:
+		return false;
+	}
+#else
+	// DuckDB main wraps runtime filters in ExpressionFilter; they are converted (or skipped) at init
+	return false;
+#endif
+}
+
+bsoncxx::document::value BuildMongoPathComparison(ExpressionType comparison_type, const Value &constant,
+                                                  const std::string &mongo_path, const LogicalType &value_type) {
+	return BuildComparisonFilterDoc(comparison_type, constant, mongo_path, value_type, {});
+}
+
+// BSON type names (as returned by the $type aggregation operator) accepted by a column; mirrors IsBSONTypeCompatible.
+// Missing, null and undefined values are always accepted because they decode to NULL.
+static vector<const char *> SchemaColumnTypeNames(LogicalTypeId type_id) {
+	switch (type_id) {
+	case LogicalTypeId::BIGINT:
+		return {"int", "long", "double"};
+	case LogicalTypeId::HUGEINT:
+	case LogicalTypeId::DOUBLE:
+		return {"int", "long", "double", "decimal"};
+	case LogicalTypeId::BOOLEAN:
+		return {"bool"};
+	case LogicalTypeId::DATE:
+	case LogicalTypeId::TIMESTAMP:
+		return {"date"};
+	default:
+		return {};
+	}
+}
+
+bsoncxx::document::value
+BuildSchemaTypeFilter(const std::vector<std::string> &column_names, const std::vector<LogicalType> &column_types,
+                      const std::unordered_map<std::string, std::string> &column_name_to_mongo_path, bool &exact) {
+	using bsoncxx::builder::basic::kvp;
+	exact = true;
+	bsoncxx::builder::basic::array checks;
+	idx_t check_count = 0;
+	for (idx_t col_idx = 0; col_idx < column_names.size(); col_idx++) {
+		auto type_id = column_types[col_idx].id();
+		// VARCHAR accepts every type; nested types are not validated by the client either
+		if (type_id == LogicalTypeId::VARCHAR || type_id == LogicalTypeId::LIST ||
+		    type_id == LogicalTypeId::STRUCT || type_id == LogicalTypeId::MAP) {
+			continue;
+		}
+		auto path_it = column_name_to_mongo_path.find(column_names[col_idx]);
+		if (path_it == column_name_to_mongo_path.end()) {
+			// Unmapped columns fall back to underscore-split lookups on the client
+			exact = false;
+			continue;
+		}
+		auto &mongo_path = path_it->second;
+		auto segments = StringUtil::Split(mongo_path, '.');
+		bool valid_path = !mongo_path.empty() && mongo_path.back() != '.';
+		for (auto &segment : segments) {
+			valid_path = valid_path && !segment.empty() && segment[0] != '$';
+		}
+		if (!valid_path) {
+			// Not expressible as an aggregation field path
+			exact = false;
+			continue;
+		}
+
+		bsoncxx::builder::basic::array allowed;
+		for (auto type_name : SchemaColumnTypeNames(type_id)) {
+			allowed.append(type_name);
+		}
+		allowed.append("null");
+		allowed.append("undefined");
+		allowed.append("missing");
+		bsoncxx::builder::basic::document type_of_field;
+		type_of_field.append(kvp("$type", "$" + mongo_path));
+		bsoncxx::builder::basic::array in_args;
+		in_args.append(type_of_field.extract());
+		in_args.append(allowed.extract());
+		bsoncxx::builder::basic::document type_check;
+		type_check.append(kvp("$in", in_args.extract()));
+
+		if (segments.size() == 1) {
+			checks.append(type_check.extract());
+			check_count++;
+			continue;
+		}
+		// The client only follows sub-documents, so a field below a non-document value counts as missing
+		bsoncxx::builder::basic::array alternatives;
+		alternatives.append(type_check.extract());
+		string prefix;
+		for (idx_t i = 0; i + 1 < segments.size(); i++) {
+			prefix += (i == 0 ? "" : ".") + segments[i];
+			bsoncxx::builder::basic::document type_of_prefix;
+			type_of_prefix.append(kvp("$type", "$" + prefix));
+			bsoncxx::builder::basic::array ne_args;
+			ne_args.append(type_of_prefix.extract());
+			ne_args.append("object");
+			bsoncxx::builder::basic::document not_document;
+			not_document.append(kvp("$ne", ne_args.extract()));
+			alternatives.append(not_document.extract());
+		}
+		bsoncxx::builder::basic::document any_alternative;
+		any_alternative.append(kvp("$or", alternatives.extract()));
+		checks.append(any_alternative.extract());
+		check_count++;
+	}
+
+	bsoncxx::builder::basic::document result;
+	if (check_count > 0) {
+		bsoncxx::builder::basic::document all_checks;
+		all_checks.append(kvp("$and", checks.extract()));
+		result.append(kvp("$expr", all_checks.extract()));
+	}
+	return result.extract();
+}
+
 } // namespace duckdb
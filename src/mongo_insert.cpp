@@ -0,0 +1,867 @@
+#include "mongo_insert.hpp"
+#include "mongo_catalog.hpp"
+#include "mongo_compat.hpp"
+#include "mongo_instance.hpp"
+#include "mongo_optimizer.hpp"
+#include "mongo_table_function.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/date.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/parser/parsed_data/copy_info.hpp"
+#include "duckdb/execution/operator/projection/physical_projection.hpp"
+#include "duckdb/execution/operator/scan/physical_table_scan.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/decimal128.hpp>
+#include <bsoncxx/json.hpp>
+#include <bsoncxx/oid.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/exception/exception.hpp>
+#include <mongocxx/model/insert_one.hpp>
+#include <mongocxx/model/replace_one.hpp>
+#include <mongocxx/model/update_one.hpp>
+#include <mongocxx/model/write.hpp>
+#include <mongocxx/options/bulk_write.hpp>
+#include <mongocxx/options/insert.hpp>
+#include <mongocxx/pipeline.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+
+namespace duckdb {
+
+using bsoncxx::builder::basic::kvp;
+using BsonValue = bsoncxx::types::bson_value::value;
+
+// Documents a thread buffers before sending them with one insert_many
+static constexpr idx_t MONGO_INSERT_BATCH_SIZE = 10000;
+// Decimal128 holds 34 significant digits
+static constexpr uint8_t MONGO_DECIMAL128_MAX_WIDTH = 34;
+
+static BsonValue MongoTimestampToBson(timestamp_t timestamp, const Value &value) {
+	if (!Timestamp::IsFinite(timestamp)) {
+		return BsonValue(bsoncxx::types::b_string {value.ToString()});
+	}
+	return BsonValue(
+	    bsoncxx::types::b_date {std::chrono::milliseconds(Timestamp::GetEpochMs(timestamp))});
+}
+
+bsoncxx::types::bson_value::value MongoValueToBson(const Value &value) {
+	if (value.IsNull()) {
+		return BsonValue(bsoncxx::types::b_null {});
+	}
+	auto &type = value.type();
+	switch (type.id()) {
+	case LogicalTypeId::BOOLEAN:
+		return BsonValue(bsoncxx::types::b_bool {value.GetValue<bool>()});
+	case LogicalTypeId::TINYINT:
+	case LogicalTypeId::SMALLINT:
+	case LogicalTypeId::INTEGER:
+	case LogicalTypeId::UTINYINT:
+	case LogicalTypeId::USMALLINT:
+		return BsonValue(bsoncxx::types::b_int32 {value.GetValue<int32_t>()});
+	case LogicalTypeId::BIGINT:
+	case LogicalTypeId::UINTEGER:
+		return BsonValue(bsoncxx::types::b_int64 {value.GetValue<int64_t>()});
+	case LogicalTypeId::UBIGINT:
+	case LogicalTypeId::HUGEINT:
+	case LogicalTypeId::UHUGEINT: {
+		Value bigint;
+		if (value.DefaultTryCastAs(LogicalType::BIGINT, bigint, nullptr, true)) {
+			return BsonValue(bsoncxx::types::b_int64 {bigint.GetValue<int64_t>()});
+		}
+		return BsonValue(bsoncxx::types::b_double {value.GetValue<double>()});
+	}
+	case LogicalTypeId::FLOAT:
+	case LogicalTypeId::DOUBLE:
+		return BsonValue(bsoncxx::types::b_double {value.GetValue<double>()});
+	case LogicalTypeId::DECIMAL:
+		if (DecimalType::GetWidth(type) > MONGO_DECIMAL128_MAX_WIDTH) {
+			return BsonValue(bsoncxx::types::b_double {value.GetValue<double>()});
+		}
+		return BsonValue(bsoncxx::types::b_decimal128 {bsoncxx::decimal128(value.ToString())});
+	case LogicalTypeId::VARCHAR:
+		return BsonValue(bsoncxx::types::b_string {StringValue::Get(value)});
+	case LogicalTypeId::BLOB: {
+		auto &bytes = StringValue::Get(value);
+		return BsonValue(bsoncxx::types::b_binary {bsoncxx::binary_sub_type::k_binary, uint32_t(bytes.size()),
+		                                       reinterpret_cast<const uint8_t *>(bytes.data())});
+	}
+	case LogicalTypeId::DATE: {
+		auto date = value.GetValue<date_t>();
+		if (!Date::IsFinite(date)) {
+			return BsonValue(bsoncxx::types::b_string {value.ToString()});
+		}
+		return BsonValue(bsoncxx::types::b_date {std::chrono::milliseconds(Date::Epoch(date) * 1000)});
+	}
+	case LogicalTypeId::TIMESTAMP:
+	case LogicalTypeId::TIMESTAMP_TZ:
+		// Both hold microseconds since the epoch (UTC)
+		return MongoTimestampToBson(value.GetValueUnsafe<timestamp_t>(), value);
+	case LogicalTypeId::TIMESTAMP_SEC:
+	case LogicalTypeId::TIMESTAMP_MS:
+	case LogicalTypeId::TIMESTAMP_NS:
+		return MongoTimestampToBson(value.DefaultCastAs(LogicalType::TIMESTAMP).GetValue<timestamp_t>(), value);
+	case LogicalTypeId::LIST:
+	case LogicalTypeId::ARRAY: {
+		auto &children =
+		    type.id() == LogicalTypeId::LIST ? ListValue::GetChildren(value) : ArrayValue::GetChildren(value);
+		bsoncxx::builder::basic::array array;
+		for (auto &child : children) {
+			array.append(MongoValueToBson(child).view());
+		}
+		auto array_value = array.extract();
+		return BsonValue(bsoncxx::types::b_array {array_value.view()});
+	}
+	case LogicalTypeId::STRUCT: {
+		auto &children = StructValue::GetChildren(value);
+		bsoncxx::builder::basic::document document;
+		for (idx_t i = 0; i < children.size(); i++) {
+			document.append(kvp(MongoStructChildName(type, i), MongoValueToBson(children[i]).view()));
+		}
+		auto document_value = document.extract();
+		return BsonValue(bsoncxx::types::b_document {document_value.view()});
+	}
+	case LogicalTypeId::MAP: {
+		bsoncxx::builder::basic::document document;
+		for (auto &entry : MapValue::GetChildren(value)) {
+			auto &key_value = StructValue::GetChildren(entry);
+			document.append(kvp(key_value[0].ToString(), MongoValueToBson(key_value[1]).view()));
+		}
+		auto document_value = document.extract();
+		return BsonValue(bsoncxx::types::b_document {document_value.view()});
+	}
+	default:
+		return BsonValue(bsoncxx::types::b_string {value.ToString()});
+	}
+}
+
+static bool IsObjectIdHex(const string &str) {
+	if (str.size() != 24) {
+		return false;
+	}
+	for (char c : str) {
+		if (!std::isxdigit(static_cast<unsigned char>(c))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bsoncxx::document::value MongoRowToDocument(DataChunk &chunk, idx_t row, const vector<string> &column_names,
+                                            const unordered_set<string> &objectid_columns) {
+	bsoncxx::builder::basic::document document;
+	for (idx_t col_idx = 0; col_idx < chunk.ColumnCount(); col_idx++) {
+		auto value = chunk.GetValue(col_idx, row);
+		auto &name = column_names[col_idx];
+		if (name == "_id") {
+			if (value.IsNull()) {
+				continue;
+			}
+			if (value.type().id() == LogicalTypeId::VARCHAR && objectid_columns.count(name) &&
+			    IsObjectIdHex(StringValue::Get(value))) {
+				document.append(kvp(name, bsoncxx::oid(StringValue::Get(value))));
+				continue;
+			}
+		}
+		document.append(kvp(name, MongoValueToBson(value).view()));
+	}
+	return document.extract();
+}
+
+// Applies the ON CONFLICT clause to an existing target collection; returns false when nothing is to be written.
+// `create` creates the (empty) collection, which the rows are then inserted into; $out creates or replaces it itself.
+static bool MongoPrepareTargetCollection(mongocxx::database &database, const MongoInsertTarget &target, bool create) {
+	if (database.has_collection(target.collection_name)) {
+		switch (target.on_conflict) {
+		case OnCreateConflict::ERROR_ON_CONFLICT:
+			throw CatalogException("Table with name \"%s\" already exists", target.collection_name);
+		case OnCreateConflict::IGNORE_ON_CONFLICT:
+			return false;
+		case OnCreateConflict::REPLACE_ON_CONFLICT:
+			if (!create) {
+				return true;
+			}
+			database[target.collection_name].drop();
+			break;
+		default:
+			throw NotImplementedException("Unsupported ON CONFLICT clause for CREATE TABLE AS in MongoDB catalogs");
+		}
+	}
+	if (create) {
+		database.create_collection(target.collection_name);
+	}
+	return true;
+}
+
+static InsertionOrderPreservingMap<string> MongoInsertParams(const MongoInsertTarget &target) {
+	InsertionOrderPreservingMap<string> result;
+	result["database"] = target.database_name;
+	result["collection"] = target.collection_name;
+	return result;
+}
+
+//===--------------------------------------------------------------------===//
+// MongoInsert
+//===--------------------------------------------------------------------===//
+MongoInsert::MongoInsert(PhysicalPlan &physical_plan, LogicalOperator &op, MongoCatalog &catalog,
+                         MongoInsertTarget target_p)
+    : PhysicalOperator(physical_plan, PhysicalOperatorType::EXTENSION, op.types, 1), catalog(catalog),
+      target(std::move(target_p)) {
+}
+
+class MongoInsertGlobalState : public GlobalSinkState {
+public:
+	//! Whether the target exists and CREATE TABLE IF NOT EXISTS leaves it alone
+	bool skip = false;
+	std::atomic<idx_t> insert_count {0};
+};
+
+class MongoInsertLocalState : public LocalSinkState {
+public:
+	unique_ptr<MongoConnection> connection;
+	vector<bsoncxx::document::value> documents;
+};
+
+unique_ptr<GlobalSinkState> MongoInsert::GetGlobalSinkState(ClientContext &context) const {
+	auto result = make_uniq<MongoInsertGlobalState>();
+	auto client = catalog.GetClient();
+	auto database = client[target.database_name];
+	result->skip = !MongoPrepareTargetCollection(database, target, true);
+	return std::move(result);
+}
+
+unique_ptr<LocalSinkState> MongoInsert::GetLocalSinkState(ExecutionContext &context) const {
+	auto result = make_uniq<MongoInsertLocalState>();
+	GetMongoInstance();
+	result->connection = make_uniq<MongoConnection>(catalog.connection_string);
+	return std::move(result);
+}
+
+static void MongoFlushDocuments(MongoInsertLocalState &lstate, MongoInsertGlobalState &gstate,
+                                const MongoInsertTarget &target) {
+	if (lstate.documents.empty()) {
+		return;
+	}
+	auto collection = lstate.connection->client[target.database_name][target.collection_name];
+	mongocxx::options::insert opts;
+	opts.ordered(false);
+	try {
+		auto result = collection.insert_many(lstate.documents, opts);
+		if (result) {
+			gstate.insert_count += NumericCast<idx_t>(result->inserted_count());
+		}
+	} catch (const mongocxx::exception &e) {
+		throw IOException("Failed to insert into MongoDB collection \"%s.%s\": %s", target.database_name,
+		                  target.collection_name, e.what());
+	}
+	lstate.documents.clear();
+}
+
+SinkResultType MongoInsert::Sink(ExecutionContext &context, DataChunk &chunk, OperatorSinkInput &input) const {
+	auto &gstate = input.global_state.Cast<MongoInsertGlobalState>();
+	auto &lstate = input.local_state.Cast<MongoInsertLocalState>();
+	if (gstate.skip) {
+		return SinkResultType::FINISHED;
+	}
+	for (idx_t row = 0; row < chunk.size(); row++) {
+		lstate.documents.push_back(MongoRowToDocument(chunk, row, target.column_names, target.objectid_columns));
+	}
+	if (lstate.documents.size() >= MONGO_INSERT_BATCH_SIZE) {
+		MongoFlushDocuments(lstate, gstate, target);
+	}
+	return SinkResultType::NEED_MORE_INPUT;
+}
+
+SinkCombineResultType MongoInsert::Combine(ExecutionContext &context, OperatorSinkCombineInput &input) const {
+	auto &gstate = input.global_state.Cast<MongoInsertGlobalState>();
+	auto &lstate = input.local_state.Cast<MongoInsertLocalState>();
+	MongoFlushDocuments(lstate, gstate, target);
+	return SinkCombineResultType::FINISHED;
+}
+
+SinkFinalizeType MongoInsert::Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
+                                       OperatorSinkFinalizeInput &input) const {
+	// The new collection shows up in the catalog
+	catalog.ClearCache();
+	return SinkFinalizeType::READY;
+}
+
+SourceResultType MongoInsert::GetData(ExecutionContext &context, DataChunk &chunk, OperatorSourceInput &input) const {
+	auto &gstate = sink_state->Cast<MongoInsertGlobalState>();
+	chunk.SetCardinality(1);
+	chunk.SetValue(0, 0, Value::BIGINT(NumericCast<int64_t>(gstate.insert_count.load())));
+	return SourceResultType::FINISHED;
+}
+
+string MongoInsert::GetName() const {
+	return "MONGO_INSERT";
+}
+
+InsertionOrderPreservingMap<string> MongoInsert::ParamsToString() const {
+	return MongoInsertParams(target);
+}
+
+//===--------------------------------------------------------------------===//
+// MongoServerInsert
+//===--------------------------------------------------------------------===//
+MongoServerInsert::MongoServerInsert(PhysicalPlan &physical_plan, LogicalOperator &op, MongoCatalog &catalog,
+                                     MongoInsertTarget target_p, string source_database_p,
+                                     string source_collection_p, vector<bsoncxx::document::value> stages_p)
+    : PhysicalOperator(physical_plan, PhysicalOperatorType::EXTENSION, op.types, 1), catalog(catalog),
+      target(std::move(target_p)), source_database(std::move(source_database_p)),
+      source_collection(std::move(source_collection_p)), stages(std::move(stages_p)) {
+}
+
+SourceResultType MongoServerInsert::GetData(ExecutionContext &context, DataChunk &chunk,
+                                            OperatorSourceInput &input) const {
+	auto client = catalog.GetClient();
+	auto database = client[target.database_name];
+	int64_t insert_count = 0;
+	if (MongoPrepareTargetCollection(database, target, false)) {
+		mongocxx::pipeline pipeline;
+		for (auto &stage : stages) {
+			pipeline.append_stage(stage.view());
+		}
+		try {
+			// $out runs when the cursor is read; it returns no documents
+			auto cursor = client[source_database][source_collection].aggregate(pipeline);
+			for (auto it = cursor.begin(); it != cursor.end(); ++it) {
+			}
+			insert_count = database[target.collection_name].count_documents({});
+		} catch (const mongocxx::exception &e) {
+			throw IOException("Failed to write MongoDB collection \"%s.%s\" with $out: %s", target.database_name,
+			                  target.collection_name, e.what());
+		}
+		catalog.ClearCache();
+	}
+	chunk.SetCardinality(1);
+	chunk.SetValue(0, 0, Value::BIGINT(insert_count));
+	return SourceResultType::FINISHED;
+}
+
+string MongoServerInsert::GetName() const {
+	return "MONGO_SERVER_INSERT";
+}
+
+InsertionOrderPreservingMap<string> MongoServerInsert::ParamsToString() const {
+	auto result = MongoInsertParams(target);
+	result["source"] = source_database + "." + source_collection;
+	string pipeline;
+	for (auto &stage : stages) {
+		pipeline += (pipeline.empty() ? "[" : ",") + bsoncxx::to_json(stage.view());
+	}
+	result["pipeline"] = pipeline + "]";
+	return result;
+}
+
+// Resolves output column i of `plan` to schema column schema_columns[i] of a mongo_scan, through projections that
+// only select or reorder columns. Returns nullptr when `plan` isn't such a scan.
+static const MongoScanData *MongoResolveInsertSource(PhysicalOperator &plan, idx_t column_count,
+                                                     optional_ptr<PhysicalTableScan> &scan_out,
+                                                     vector<idx_t> &schema_columns) {
+	// Output column i of the plan is output column column_map[i] of the operator being looked at
+	vector<idx_t> column_map;
+	for (idx_t i = 0; i < column_count; i++) {
+		column_map.push_back(i);
+	}
+	reference<PhysicalOperator> op = plan;
+	while (op.get().type == PhysicalOperatorType::PROJECTION && op.get().children.size() == 1) {
+		auto &projection = op.get().Cast<PhysicalProjection>();
+		for (auto &column : column_map) {
+			if (column >= projection.select_list.size() ||
+			    projection.select_list[column]->GetExpressionClass() != ExpressionClass::BOUND_REF) {
+				return nullptr;
+			}
+			column = projection.select_list[column]->Cast<BoundReferenceExpression>().index;
+		}
+		op = op.get().children[0];
+	}
+	if (op.get().type != PhysicalOperatorType::TABLE_SCAN) {
+		return nullptr;
+	}
+	auto &scan = op.get().Cast<PhysicalTableScan>();
+	if (!scan.bind_data || !StringUtil::CIEquals(MONGO_FUNCTION_NAME(scan.function), "mongo_scan")) {
+		return nullptr;
+	}
+	auto data = dynamic_cast<const MongoScanData *>(scan.bind_data.get());
+	if (!data) {
+		return nullptr;
+	}
+	for (auto position : column_map) {
+		if (!scan.projection_ids.empty()) {
+			if (position >= scan.projection_ids.size()) {
+				return nullptr;
+			}
+			position = scan.projection_ids[position];
+		}
+		if (position >= scan.column_ids.size()) {
+			return nullptr;
+		}
+		idx_t col_idx = scan.column_ids[position].GetPrimaryIndex();
+		if (col_idx >= data->column_names.size()) {
+			return nullptr;
+		}
+		schema_columns.push_back(col_idx);
+	}
+	scan_out = &scan;
+	return data;
+}
+
+static const string &MongoInsertSourcePath(const MongoScanData &data, idx_t col_idx) {
+	auto &column_name = data.column_names[col_idx];
+	auto path_it = data.column_name_to_mongo_path.find(column_name);
+	return path_it != data.column_name_to_mongo_path.end() ? path_it->second : column_name;
+}
+
+unordered_set<string> MongoInsertObjectIdColumns(PhysicalOperator &plan, const vector<string> &column_names) {
+	unordered_set<string> result;
+	optional_ptr<PhysicalTableScan> scan;
+	vector<idx_t> schema_columns;
+	auto data = MongoResolveInsertSource(plan, column_names.size(), scan, schema_columns);
+	if (!data) {
+		return result;
+	}
+	for (idx_t i = 0; i < column_names.size(); i++) {
+		if (data->objectid_columns.count(MongoInsertSourcePath(*data, schema_columns[i]))) {
+			result.insert(column_names[i]);
+		}
+	}
+	return result;
+}
+
+// {$cond: [{$in: [{$type: input}, types]}, then, null]}
+template <class T>
+static bsoncxx::document::value MongoTypeGuard(const string &input, std::initializer_list<const char *> types,
+                                               const T &then) {
+	bsoncxx::builder::basic::array type_names;
+	for (auto type : types) {
+		type_names.append(type);
+	}
+	bsoncxx::builder::basic::array in_args;
+	in_args.append(bsoncxx::builder::basic::make_document(kvp("$type", input)));
+	in_args.append(type_names.extract());
+	bsoncxx::builder::basic::array cond_args;
+	cond_args.append(bsoncxx::builder::basic::make_document(kvp("$in", in_args.extract())));
+	cond_args.append(then);
+	cond_args.append(bsoncxx::types::b_null {});
+	return bsoncxx::builder::basic::make_document(kvp("$cond", cond_args.extract()));
+}
+
+// {$convert: {input: input, to: to, onError: on_error}}
+template <class T>
+static bsoncxx::document::value MongoConvertValue(const string &input, const char *to, const T &on_error) {
+	return bsoncxx::builder::basic::make_document(
+	    kvp("$convert", bsoncxx::builder::basic::make_document(kvp("input", input), kvp("to", to),
+	                                                           kvp("onError", on_error))));
+}
+
+// Server expression writing the field at `path` the way MONGO_INSERT writes the value the scan decodes from it, so
+// that both paths create the same documents: values of BSON types the column type doesn't decode become null, and
+// other values are converted to the BSON type MongoValueToBson writes. VARCHAR columns decode strings and ObjectIds
+// (as hex digits) the same way on both paths; their other values are decoded as JSON by the scan, which the server
+// can't reproduce, so `varchar_paths` collects them to be checked. Returns false for other column types.
+static bool MongoServerInsertValue(const string &path, const LogicalType &type, bool objectid_id,
+                                   bsoncxx::document::value &result, vector<string> &varchar_paths) {
+	auto input = "$" + path;
+	bsoncxx::types::b_null null_value;
+	switch (type.id()) {
+	case LogicalTypeId::BIGINT: {
+		// Doubles are truncated, like the scan's cast
+		auto convert = MongoConvertValue(input, "long", null_value);
+		result = MongoTypeGuard(input, {"int", "long", "double"}, convert.view());
+		return true;
+	}
+	case LogicalTypeId::DOUBLE: {
+		auto convert = MongoConvertValue(input, "double", null_value);
+		result = MongoTypeGuard(input, {"int", "long", "double", "decimal"}, convert.view());
+		return true;
+	}
+	case LogicalTypeId::BOOLEAN:
+		result = MongoTypeGuard(input, {"bool"}, input);
+		return true;
+	case LogicalTypeId::TIMESTAMP:
+		// Dates hold milliseconds, which TIMESTAMP keeps
+		result = MongoTypeGuard(input, {"date"}, input);
+		return true;
+	case LogicalTypeId::VARCHAR: {
+		varchar_paths.push_back(path);
+		// The _id of an ObjectId column becomes an ObjectId again when it holds 24 hex digits, like in
+		// MongoRowToDocument; other values are written as strings
+		auto convert = objectid_id ? MongoConvertValue(input, "objectId", input)
+		                           : MongoConvertValue(input, "string", null_value);
+		result = MongoTypeGuard(input, {"string", "objectId"}, convert.view());
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+// Whether a document at the end of `stages` holds a value of another type than strings and ObjectIds in one of
+// `varchar_paths`. Such a value would be written differently by the server, so the statement then runs in DuckDB.
+static bool MongoHasNonStringValues(const string &connection_string, const string &database_name,
+                                    const string &collection_name, const vector<bsoncxx::document::value> &stages,
+                                    const vector<string> &varchar_paths) {
+	bsoncxx::builder::basic::array conditions;
+	for (auto &path : varchar_paths) {
+		bsoncxx::builder::basic::array allowed;
+		allowed.append("string", "objectId", "null", "undefined");
+		auto not_allowed = bsoncxx::builder::basic::make_document(
+		    kvp("$exists", true),
+		    kvp("$not", bsoncxx::builder::basic::make_document(kvp("$type", allowed.extract()))));
+		conditions.append(bsoncxx::builder::basic::make_document(kvp(path, not_allowed.view())));
+	}
+	mongocxx::pipeline pipeline;
+	for (auto &stage : stages) {
+		pipeline.append_stage(stage.view());
+	}
+	pipeline.match(bsoncxx::builder::basic::make_document(kvp("$or", conditions.extract())));
+	pipeline.limit(1);
+	pipeline.project(bsoncxx::builder::basic::make_document(kvp("_id", 1)));
+	auto client = GetMongoClientPool(connection_string)->acquire();
+	auto cursor = (*client)[database_name][collection_name].aggregate(pipeline);
+	return cursor.begin() != cursor.end();
+}
+
+bool BuildMongoServerInsertPipeline(PhysicalOperator &plan, const string &connection_string,
+                                    const MongoInsertTarget &target, string &source_database,
+                                    string &source_collection, vector<bsoncxx::document::value> &stages) {
+	optional_ptr<PhysicalTableScan> scan;
+	vector<idx_t> schema_columns;
+	auto data = MongoResolveInsertSource(plan, target.column_names.size(), scan, schema_columns);
+	// Throttled scans keep their read rate
+	if (!data || data->connection_string != connection_string || data->max_docs_per_second > 0 ||
+	    data->max_bytes_per_second > 0) {
+		return false;
+	}
+
+	bsoncxx::builder::basic::document project_spec;
+	vector<string> varchar_paths;
+	bool has_id = false;
+	for (idx_t i = 0; i < schema_columns.size(); i++) {
+		idx_t col_idx = schema_columns[i];
+		auto &path = MongoInsertSourcePath(*data, col_idx);
+		// Names MongoDB would read as a nested path or an operator can't be $project outputs
+		auto &name = target.column_names[i];
+		if (name.empty() || name.find('.') != string::npos || name[0] == '$' || path.empty() || path[0] == '$') {
+			return false;
+		}
+		bool is_id = name == "_id";
+		auto value = bsoncxx::builder::basic::document {}.extract();
+		if (!MongoServerInsertValue(path, data->column_types[col_idx], is_id && data->objectid_columns.count(path),
+		                            value, varchar_paths)) {
+			return false;
+		}
+		// Missing values are written as null, like NULLs are by MONGO_INSERT; a NULL _id is left out instead
+		bsoncxx::builder::basic::array if_null_args;
+		if_null_args.append(value.view());
+		if (is_id) {
+			if_null_args.append("$$REMOVE");
+		} else {
+			if_null_args.append(bsoncxx::types::b_null {});
+		}
+		auto if_null = bsoncxx::builder::basic::make_document(kvp("$ifNull", if_null_args.extract()));
+		project_spec.append(kvp(name, if_null.view()));
+		has_id = has_id || is_id;
+	}
+	if (!has_id) {
+		project_spec.append(kvp("_id", 0));
+	}
+
+	if (!BuildMongoScanPipeline(*data, scan->table_filters.get(), scan->column_ids, stages)) {
+		return false;
+	}
+	for (auto &stage : stages) {
+		auto stage_view = stage.view();
+		if (stage_view.empty()) {
+			return false;
+		}
+		// A COUNT(*) pipeline returns a 0 row from the scan when the server returns nothing
+		auto stage_name = stage_view.begin()->key();
+		if (stage_name == "$count" || stage_name == "$out" || stage_name == "$merge") {
+			return false;
+		}
+	}
+	if (!varchar_paths.empty() && MongoHasNonStringValues(connection_string, data->database_name,
+	                                                      data->collection_name, stages, varchar_paths)) {
+		return false;
+	}
+	bsoncxx::builder::basic::document project_stage;
+	project_stage.append(kvp("$project", project_spec.extract()));
+	stages.push_back(project_stage.extract());
+	bsoncxx::builder::basic::document out_spec;
+	out_spec.append(kvp("db", target.database_name));
+	out_spec.append(kvp("coll", target.collection_name));
+	bsoncxx::builder::basic::document out_stage;
+	out_stage.append(kvp("$out", out_spec.extract()));
+	stages.push_back(out_stage.extract());
+	source_database = data->database_name;
+	source_collection = data->collection_name;
+	return true;
+}
+
+//===--------------------------------------------------------------------===//
+// COPY ... TO '<catalog>.<database>.<collection>' (FORMAT mongo)
+//===--------------------------------------------------------------------===//
+struct MongoCopyBindData : public FunctionData {
+	string catalog_name;
+	string connection_string;
+	string database_name;
+	string collection_name;
+	vector<string> column_names;
+	//! Columns identifying a document (KEY); empty = rows are inserted as new documents
+	vector<string> key_columns;
+	//! Whether an upsert replaces the whole document (REPLACE) instead of setting the copied fields
+	bool replace = false;
+	//! Copied columns whose field holds ObjectIds in the target collection (only _id is checked)
+	unordered_set<string> objectid_columns;
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<MongoCopyBindData>(*this);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<MongoCopyBindData>();
+		return catalog_name == other.catalog_name && database_name == other.database_name &&
+		       collection_name == other.collection_name && column_names == other.column_names &&
+		       key_columns == other.key_columns && replace == other.replace;
+	}
+};
+
+class MongoCopyGlobalState : public GlobalFunctionData {
+public:
+	mutex lock;
+	//! BSON of the KEY fields of every row copied so far, shared by all threads
+	unordered_set<string> keys;
+};
+
+class MongoCopyLocalState : public LocalFunctionData {
+public:
+	unique_ptr<MongoConnection> connection;
+	vector<mongocxx::model::write> writes;
+};
+
+static unique_ptr<FunctionData> MongoCopyBind(ClientContext &context, CopyFunctionBindInput &input,
+                                              const vector<string> &names, const vector<LogicalType> &sql_types) {
+	auto result = make_uniq<MongoCopyBindData>();
+	auto &path = input.info.file_path;
+	auto catalog_end = path.find('.');
+	if (catalog_end == string::npos) {
+		throw BinderException("COPY TO MongoDB expects '<catalog>.<database>.<collection>', got \"%s\"", path);
+	}
+	result->catalog_name = path.substr(0, catalog_end);
+	auto &catalog = Catalog::GetCatalog(context, result->catalog_name);
+	if (catalog.GetCatalogType() != "mongo") {
+		throw BinderException("COPY TO MongoDB: \"%s\" is not an attached MongoDB database", result->catalog_name);
+	}
+	auto &mongo_catalog = catalog.Cast<MongoCatalog>();
+	result->connection_string = mongo_catalog.connection_string;
+	// With dbname in the ATTACH string, everything after the catalog is the collection name
+	auto collection_start = catalog_end + 1;
+	if (mongo_catalog.database_name.empty()) {
+		auto database_end = path.find('.', collection_start);
+		if (database_end == string::npos) {
+			throw BinderException("COPY TO MongoDB expects '<catalog>.<database>.<collection>', got \"%s\"", path);
+		}
+		result->database_name = path.substr(collection_start, database_end - collection_start);
+		collection_start = database_end + 1;
+	} else {
+		result->database_name = mongo_catalog.database_name;
+	}
+	result->collection_name = path.substr(collection_start);
+	if (result->database_name.empty() || result->collection_name.empty()) {
+		throw BinderException("COPY TO MongoDB expects '<catalog>.<database>.<collection>', got \"%s\"", path);
+	}
+	result->column_names = names;
+
+	for (auto &option : input.info.options) {
+		auto option_name = StringUtil::Lower(option.first);
+		if (option_name == "key") {
+			for (auto &key : option.second) {
+				auto key_name = key.ToString();
+				if (std::find(names.begin(), names.end(), key_name) == names.end()) {
+					throw BinderException("COPY TO MongoDB: KEY column \"%s\" is not in the copied columns", key_name);
+				}
+				result->key_columns.push_back(key_name);
+			}
+		} else if (option_name == "replace") {
+			result->replace =
+			    option.second.empty() || BooleanValue::Get(option.second[0].DefaultCastAs(LogicalType::BOOLEAN));
+		} else {
+			throw BinderException("Unrecognized option for COPY TO MongoDB: \"%s\"", option.first);
+		}
+	}
+	if (result->replace && result->key_columns.empty()) {
+		throw BinderException("COPY TO MongoDB: REPLACE needs the KEY columns identifying a document");
+	}
+
+	// The rows don't tell where they come from, so a VARCHAR _id is only written as an ObjectId when the target
+	// collection already holds ObjectId _ids
+	if (std::find(names.begin(), names.end(), "_id") != names.end()) {
+		auto client = mongo_catalog.GetClient();
+		auto is_objectid = bsoncxx::builder::basic::make_document(kvp("$type", "objectId"));
+		auto filter = bsoncxx::builder::basic::make_document(kvp("_id", is_objectid.view()));
+		if (client[result->database_name][result->collection_name].find_one(filter.view())) {
+			result->objectid_columns.insert("_id");
+		}
+	}
+	return std::move(result);
+}
+
+static unique_ptr<GlobalFunctionData> MongoCopyInitGlobal(ClientContext &context, FunctionData &bind_data,
+                                                          const string &file_path) {
+	return make_uniq<MongoCopyGlobalState>();
+}
+
+static unique_ptr<LocalFunctionData> MongoCopyInitLocal(ExecutionContext &context, FunctionData &bind_data) {
+	auto &data = bind_data.Cast<MongoCopyBindData>();
+	auto result = make_uniq<MongoCopyLocalState>();
+	GetMongoInstance();
+	result->connection = make_uniq<MongoConnection>(data.connection_string);
+	return std::move(result);
+}
+
+// The key fields of a row, the filter of its upsert
+static bsoncxx::document::value MongoCopyKey(const MongoCopyBindData &data, const bsoncxx::document::view &view) {
+	bsoncxx::builder::basic::document filter;
+	for (auto &key : data.key_columns) {
+		auto element = view[key];
+		if (!element || element.type() == bsoncxx::type::k_null) {
+			throw InvalidInputException("COPY TO MongoDB: KEY column \"%s\" is NULL", key);
+		}
+		filter.append(kvp(key, element.get_value()));
+	}
+	return filter.extract();
+}
+
+// Every key may appear only once: two upserts of one key race when they run on different threads (both may insert,
+// as nothing makes the key unique), and which row wins would depend on the order the bulk writes reach the server
+static void MongoCopyCheckUniqueKey(MongoCopyGlobalState &gstate, const bsoncxx::document::view &filter) {
+	string key(reinterpret_cast<const char *>(filter.data()), filter.length());
+	lock_guard<mutex> guard(gstate.lock);
+	if (!gstate.keys.insert(std::move(key)).second) {
+		throw InvalidInputException("COPY TO MongoDB: KEY %s appears in more than one copied row",
+		                            bsoncxx::to_json(filter));
+	}
+}
+
+// Write model of one row: an insert without KEY, otherwise an upsert matching the key fields. An update sets the
+// copied fields and leaves the others alone; a non-key _id is only written when the upsert inserts the document.
+static mongocxx::model::write MongoCopyWrite(const MongoCopyBindData &data, bsoncxx::document::value document,
+                                             bsoncxx::document::value filter) {
+	if (data.key_columns.empty()) {
+		return mongocxx::model::insert_one(std::move(document));
+	}
+	auto view = document.view();
+	if (data.replace) {
+		mongocxx::model::replace_one replace(std::move(filter), std::move(document));
+		replace.upsert(true);
+		return replace;
+	}
+	bsoncxx::builder::basic::document set_fields;
+	bsoncxx::builder::basic::document insert_fields;
+	bool has_set_fields = false;
+	bool has_insert_fields = false;
+	for (auto &element : view) {
+		auto name = string(element.key());
+		if (std::find(data.key_columns.begin(), data.key_columns.end(), name) != data.key_columns.end()) {
+			continue;
+		}
+		if (name == "_id") {
+			insert_fields.append(kvp(name, element.get_value()));
+			has_insert_fields = true;
+		} else {
+			set_fields.append(kvp(name, element.get_value()));
+			has_set_fields = true;
+		}
+	}
+	if (!has_set_fields && !has_insert_fields) {
+		// Only key columns: the upsert inserts the missing documents and leaves existing ones alone
+		for (auto &key : data.key_columns) {
+			insert_fields.append(kvp(key, view[key].get_value()));
+		}
+		has_insert_fields = true;
+	}
+	bsoncxx::builder::basic::document update;
+	if (has_set_fields) {
+		update.append(kvp("$set", set_fields.extract()));
+	}
+	if (has_insert_fields) {
+		update.append(kvp("$setOnInsert", insert_fields.extract()));
+	}
+	mongocxx::model::update_one update_one(std::move(filter), update.extract());
+	update_one.upsert(true);
+	return update_one;
+}
+
+static void MongoCopyFlush(const MongoCopyBindData &data, MongoCopyLocalState &lstate) {
+	if (lstate.writes.empty()) {
+		return;
+	}
+	auto collection = lstate.connection->client[data.database_name][data.collection_name];
+	mongocxx::options::bulk_write opts;
+	opts.ordered(false);
+	try {
+		collection.bulk_write(lstate.writes, opts);
+	} catch (const mongocxx::exception &e) {
+		throw IOException("Failed to write MongoDB collection \"%s.%s\": %s", data.database_name, data.collection_name,
+		                  e.what());
+	}
+	lstate.writes.clear();
+}
+
+static void MongoCopySink(ExecutionContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
+                          LocalFunctionData &lstate_p, DataChunk &input) {
+	auto &data = bind_data.Cast<MongoCopyBindData>();
+	auto &lstate = lstate_p.Cast<MongoCopyLocalState>();
+	for (idx_t row = 0; row < input.size(); row++) {
+		auto document = MongoRowToDocument(input, row, data.column_names, data.objectid_columns);
+		bsoncxx::document::value filter(bsoncxx::document::view {});
+		if (!data.key_columns.empty()) {
+			filter = MongoCopyKey(data, document.view());
+			MongoCopyCheckUniqueKey(gstate.Cast<MongoCopyGlobalState>(), filter.view());
+		}
+		lstate.writes.push_back(MongoCopyWrite(data, std::move(document), std::move(filter)));
+	}
+	if (lstate.writes.size() >= MONGO_INSERT_BATCH_SIZE) {
+		MongoCopyFlush(data, lstate);
+	}
+}
+
+static void MongoCopyCombine(ExecutionContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
+                             LocalFunctionData &lstate) {
+	MongoCopyFlush(bind_data.Cast<MongoCopyBindData>(), lstate.Cast<MongoCopyLocalState>());
+}
+
+static void MongoCopyFinalize(ClientContext &context, FunctionData &bind_data, GlobalFunctionData &gstate) {
+	// The collection may be new
+	auto &data = bind_data.Cast<MongoCopyBindData>();
+	Catalog::GetCatalog(context, data.catalog_name).Cast<MongoCatalog>().ClearCache();
+}
+
+static CopyFunctionExecutionMode MongoCopyExecutionMode(bool preserve_insertion_order, bool supports_batch_index) {
+	// Unordered bulk writes: the order of the rows is not kept anyway
+	return CopyFunctionExecutionMode::PARALLEL_COPY_TO_FILE;
+}
+
+CopyFunction GetMongoCopyFunction() {
+	CopyFunction function("mongo");
+	function.copy_to_bind = MongoCopyBind;
+	function.copy_to_initialize_global = MongoCopyInitGlobal;
+	function.copy_to_initialize_local = MongoCopyInitLocal;
+	function.copy_to_sink = MongoCopySink;
+	function.copy_to_combine = MongoCopyCombine;
+	function.copy_to_finalize = MongoCopyFinalize;
+	function.execution_mode = MongoCopyExecutionMode;
+	return function;
+}
+
+} // namespace duckdb
@@ -1,4 +1,10 @@
 #include "mongo_instance.hpp"
+#include "duckdb/common/exception.hpp"
+
+#include <mongocxx/uri.hpp>
+
+#include <mutex>
+#include <unordered_map>
 
 namespace duckdb {
 
@@ -11,4 +17,48 @@ mongocxx::instance &GetMongoInstance() {
 	return g_mongo_instance;
 }
 
+static std::mutex pools_lock;
+static std::unordered_map<std::string, std::shared_ptr<mongocxx::pool>> pools;
+static std::unordered_map<std::string, std::shared_ptr<mongoc_client_pool_t>> native_pools;
+
+std::shared_ptr<mongocxx::pool> GetMongoClientPool(const std::string &connection_string) {
+	std::lock_guard<std::mutex> guard(pools_lock);
+	auto it = pools.find(connection_string);
+	if (it != pools.end()) {
+		return it->second;
+	}
+	auto pool = std::make_shared<mongocxx::pool>(mongocxx::uri(connection_string));
+	pools.emplace(connection_string, pool);
+	return pool;
+}
+
+std::shared_ptr<mongoc_client_pool_t> GetMongoNativeClientPool(const std::string &connection_string) {
+	std::lock_guard<std::mutex> guard(pools_lock);
+	auto it = native_pools.find(connection_string);
+	if (it != native_pools.end()) {
+		return it->second;
+	}
+	bson_error_t error;
+	auto uri = mongoc_uri_new_with_error(connection_string.c_str(), &error);
+	if (!uri) {
+		throw IOException("Invalid MongoDB connection string: %s", error.message);
+	}
+	auto native_pool = mongoc_client_pool_new(uri);
+	mongoc_uri_destroy(uri);
+	if (!native_pool) {
+		throw IOException("Failed to create a MongoDB client pool");
+	}
+	mongoc_client_pool_set_error_api(native_pool, MONGOC_ERROR_API_VERSION_2);
+	// Cursors keep a reference, so the pool is only destroyed once their clients are back
+	std::shared_ptr<mongoc_client_pool_t> pool(native_pool, mongoc_client_pool_destroy);
+	native_pools.emplace(connection_string, pool);
+	return pool;
+}
+
+void ClearMongoClientPools() {
+	std::lock_guard<std::mutex> guard(pools_lock);
+	pools.clear();
+	native_pools.clear();
+}
+
 } // namespace duckdb
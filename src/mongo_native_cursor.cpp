@@ -0,0 +1,98 @@
+#include "mongo_native_cursor.hpp"
+#include "mongo_instance.hpp"
+#include "duckdb/common/exception.hpp"
+
+namespace duckdb {
+
+// Appends `view` as a subdocument; bson_init_static only points at the view's data
+static void MongoNativeAppendDocument(bson_t &target, const char *key, const bsoncxx::document::view &view) {
+	bson_t child;
+	if (!bson_init_static(&child, view.data(), view.length()) || !bson_append_document(&target, key, -1, &child)) {
+		throw IOException("mongo_scan could not build the \"%s\" option of its find command", key);
+	}
+}
+
+// The options of a find command, as set up by the scan (projection, sort, limit, batch size)
+static void MongoNativeFindOptions(const mongocxx::options::find &options, bson_t &opts) {
+	if (options.projection()) {
+		MongoNativeAppendDocument(opts, "projection", options.projection()->view());
+	}
+	if (options.sort()) {
+		MongoNativeAppendDocument(opts, "sort", options.sort()->view());
+	}
+	if (options.limit()) {
+		BSON_APPEND_INT64(&opts, "limit", *options.limit());
+	}
+	if (options.batch_size()) {
+		BSON_APPEND_INT32(&opts, "batchSize", *options.batch_size());
+	}
+}
+
+MongoNativeCursor::MongoNativeCursor(const std::string &connection_string, const std::string &database_name,
+                                     const std::string &collection_name, const bsoncxx::document::view &filter,
+                                     const mongocxx::options::find &options)
+    : pool(GetMongoNativeClientPool(connection_string)) {
+	client = mongoc_client_pool_pop(pool.get());
+	collection = mongoc_client_get_collection(client, database_name.c_str(), collection_name.c_str());
+
+	bson_t filter_bson;
+	if (!bson_init_static(&filter_bson, filter.data(), filter.length())) {
+		Close();
+		throw IOException("mongo_scan could not build the filter of its find command");
+	}
+	bson_t opts = BSON_INITIALIZER;
+	try {
+		MongoNativeFindOptions(options, opts);
+	} catch (...) {
+		bson_destroy(&opts);
+		Close();
+		throw;
+	}
+	// The command is sent, and the first batch received, by the first mongoc_cursor_next
+	cursor = mongoc_collection_find_with_opts(collection, &filter_bson, &opts, nullptr);
+	bson_destroy(&opts);
+	try {
+		Advance();
+	} catch (...) {
+		Close();
+		throw;
+	}
+}
+
+MongoNativeCursor::~MongoNativeCursor() {
+	Close();
+}
+
+void MongoNativeCursor::Close() {
+	current = nullptr;
+	if (cursor) {
+		mongoc_cursor_destroy(cursor);
+		cursor = nullptr;
+	}
+	if (collection) {
+		mongoc_collection_destroy(collection);
+		collection = nullptr;
+	}
+	if (client) {
+		mongoc_client_pool_push(pool.get(), client);
+		client = nullptr;
+	}
+}
+
+bsoncxx::document::view MongoNativeCursor::Document() const {
+	D_ASSERT(current);
+	return bsoncxx::document::view(bson_get_data(current), current->len);
+}
+
+void MongoNativeCursor::Advance() {
+	if (mongoc_cursor_next(cursor, &current)) {
+		return;
+	}
+	current = nullptr;
+	bson_error_t error;
+	if (mongoc_cursor_error(cursor, &error)) {
+		throw IOException("MongoDB find on a native cursor failed: %s", error.message);
+	}
+}
+
+} // namespace duckdb
@@ -1,31 +1,45 @@
 #include "mongo_optimizer.hpp"
 
 #include "mongo_table_function.hpp"
+#include "mongo_expr_pushdown.hpp"
 #include "mongo_filter_pushdown.hpp"
 #include "mongo_compat.hpp"
 
 #include "duckdb/common/string_util.hpp"
+#include "duckdb/main/config.hpp"
 #include "duckdb/optimizer/optimizer.hpp"
 #include "duckdb/planner/expression/bound_aggregate_expression.hpp"
 #include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_unnest_expression.hpp"
 #include "duckdb/planner/expression_iterator.hpp"
+#include "duckdb/planner/logical_operator_visitor.hpp"
 #include "duckdb/planner/operator/logical_aggregate.hpp"
+#include "duckdb/planner/operator/logical_comparison_join.hpp"
+#include "duckdb/planner/operator/logical_filter.hpp"
 #include "duckdb/planner/operator/logical_get.hpp"
 #include "duckdb/planner/operator/logical_limit.hpp"
 #include "duckdb/planner/operator/logical_order.hpp"
 #include "duckdb/planner/operator/logical_projection.hpp"
+#include "duckdb/planner/operator/logical_set_operation.hpp"
 #include "duckdb/planner/operator/logical_top_n.hpp"
+#include "duckdb/planner/operator/logical_unnest.hpp"
 #include "duckdb/planner/expression/bound_cast_expression.hpp"
 
 #include <bsoncxx/builder/basic/array.hpp>
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/json.hpp>
 
+#include <algorithm>
+#include <map>
 #include <sstream>
 #include <utility>
 
 namespace duckdb {
 
+static constexpr const char *EAGER_AGGREGATION_SETTING = "mongo_eager_aggregation";
+
 struct BindingMapRule {
 	mongo_table_index_t from_table_index;
 	mongo_table_index_t to_table_index;
@@ -61,9 +75,10 @@ static void ApplyBindingRulesToExpression(unique_ptr<Expression> &expr, const ve
 	});
 }
 
-static void ApplyBindingRulesToOperator(LogicalOperator &op, const vector<BindingMapRule> &rules);
-
-static void ApplyBindingRulesToOperatorChildren(LogicalOperator &op, const vector<BindingMapRule> &rules) {
+// Rewrites every expression of the plan, including ORDER BY keys, GROUP BY keys and join conditions
+static void ApplyBindingRulesToOperator(LogicalOperator &op, const vector<BindingMapRule> &rules) {
+	LogicalOperatorVisitor::EnumerateExpressions(
+	    op, [&](unique_ptr<Expression> *expr) { ApplyBindingRulesToExpression(*expr, rules); });
 	for (auto &child : op.children) {
 		if (child) {
 			ApplyBindingRulesToOperator(*child, rules);
@@ -71,35 +86,6 @@ static void ApplyBindingRulesToOperatorChildren(LogicalOperator &op, const vecto
 	}
 }
 
-static void ApplyBindingRulesToOrderNodes(vector<BoundOrderByNode> &orders, const vector<BindingMapRule> &rules) {
-	for (auto &order : orders) {
-		ApplyBindingRulesToExpression(order.expression, rules);
-	}
-}
-
-static void ApplyBindingRulesToOperator(LogicalOperator &op, const vector<BindingMapRule> &rules) {
-	for (auto &expr : op.expressions) {
-		ApplyBindingRulesToExpression(expr, rules);
-	}
-
-	switch (op.type) {
-	case LogicalOperatorType::LOGICAL_ORDER_BY: {
-		auto &order = op.Cast<LogicalOrder>();
-		ApplyBindingRulesToOrderNodes(order.orders, rules);
-		break;
-	}
-	case LogicalOperatorType::LOGICAL_TOP_N: {
-		auto &topn = op.Cast<LogicalTopN>();
-		ApplyBindingRulesToOrderNodes(topn.orders, rules);
-		break;
-	}
-	default:
-		break;
-	}
-
-	ApplyBindingRulesToOperatorChildren(op, rules);
-}
-
 static string JoinJsonArray(const vector<bsoncxx::document::value> &stages) {
 	std::stringstream ss;
 	ss << "[";
@@ -117,7 +103,75 @@ static bool DocIsEmpty(const bsoncxx::document::view &v) {
 	return v.begin() == v.end();
 }
 
-static bsoncxx::document::value BuildMatchFromExistingFilters(const LogicalGet &get, const MongoScanData &data) {
+// Appends an $addFields stage converting conflicted columns when type_coercion := 'server' is set
+static void AppendServerConversionStage(const MongoScanData &data, vector<bsoncxx::document::value> &stages) {
+	auto conversions = GetServerTypeConversions(data);
+	if (conversions.empty()) {
+		return;
+	}
+	std::map<string, string> sorted_conversions(conversions.begin(), conversions.end());
+	bsoncxx::builder::basic::document fields;
+	for (auto &conversion : sorted_conversions) {
+		fields.append(bsoncxx::builder::basic::kvp(
+		    conversion.first, BuildMongoConvertExpression(conversion.first, conversion.second)));
+	}
+	bsoncxx::builder::basic::document stage;
+	stage.append(bsoncxx::builder::basic::kvp("$addFields", fields.extract()));
+	stages.push_back(stage.extract());
+}
+
+// Whether a pipeline built from BuildMatchFromExistingFilters drops the same documents as the scan's schema checks
+static bool SchemaEnforcementPushable(const MongoScanData &data) {
+	if (!data.has_explicit_schema || data.schema_mode == SchemaMode::PERMISSIVE) {
+		return true;
+	}
+	return data.schema_mode == SchemaMode::DROPMALFORMED && data.schema_type_filter_exact;
+}
+
+// Copy of the scan's pushed-down table filters over `column_ids`, keyed by schema column index
+static unique_ptr<TableFilterSet> CopyFiltersBySchemaIndex(const TableFilterSet &filters,
+                                                           const vector<ColumnIndex> &column_ids) {
+#ifdef DUCKDB_MAIN_VECTOR_API
+	// DuckDB main: filters are keyed by ProjectionIndex (position within column_ids).
+	// Remap to schema column indices before converting to MongoDB query.
+	auto remapped_filters = make_uniq<TableFilterSet>();
+	auto filters_copy = filters.Copy();
+	MongoForEachFilter(*filters_copy, [&](idx_t proj_idx, TableFilter &filter) {
+		if (proj_idx < column_ids.size()) {
+			idx_t schema_idx = column_ids[proj_idx].GetPrimaryIndex();
+			MongoSetFilter(*remapped_filters, schema_idx, MongoCopyFilter(filter));
+		}
+	});
+	return remapped_filters;
+#else
+	// DuckDB v1.5.x: filters are already keyed by schema column index.
+	return filters.Copy();
+#endif
+}
+
+// Whether BuildMatchFromExistingFilters expresses all of `filters`. A rewrite that replaces the scan's query with a
+// pipeline drops the table filters, so a filter the query only partly converts (see GetResidualFilterColumns) would
+// be lost; such rewrites are skipped.
+static bool FiltersFullyPushable(optional_ptr<const TableFilterSet> filters, const vector<ColumnIndex> &column_ids,
+                                 const MongoScanData &data) {
+	if (!filters || !MongoHasFilters(*filters)) {
+		return true;
+	}
+	auto schema_filters = CopyFiltersBySchemaIndex(*filters, column_ids);
+	return GetResidualFilterColumns(*schema_filters, data.column_names, data.column_types,
+	                                data.column_name_to_mongo_path, data.objectid_columns,
+	                                GetServerConvertedColumns(data))
+	    .empty();
+}
+
+static bool FiltersFullyPushable(const LogicalGet &get, const MongoScanData &data) {
+	return FiltersFullyPushable(&get.table_filters, get.GetColumnIds(), data);
+}
+
+// `filters` are the scan's pushed-down table filters over `column_ids`
+static bsoncxx::document::value BuildMatchFromExistingFilters(optional_ptr<const TableFilterSet> filters,
+                                                              const vector<ColumnIndex> &column_ids,
+                                                              const MongoScanData &data) {
 	vector<bsoncxx::document::value> conjuncts;
 
 	// Manual filter := '{}' parameter (if any)
@@ -126,28 +180,12 @@ static bsoncxx::document::value BuildMatchFromExistingFilters(const LogicalGet &
 	}
 
 	// TableFilterSet pushdown (simple comparisons).
-	if (MongoHasFilters(get.table_filters)) {
-#ifdef DUCKDB_MAIN_VECTOR_API
-		// DuckDB main: filters are keyed by ProjectionIndex (position within column_ids).
-		// Remap to schema column indices before converting to MongoDB query.
-		auto remapped_filters = make_uniq<TableFilterSet>();
-		auto &col_ids = get.GetColumnIds();
-		auto filters_copy = get.table_filters.Copy();
-		MongoForEachFilter(*filters_copy, [&](idx_t proj_idx, TableFilter &filter) {
-			if (proj_idx < col_ids.size()) {
-				idx_t schema_idx = col_ids[proj_idx].GetPrimaryIndex();
-				MongoSetFilter(*remapped_filters, schema_idx, MongoCopyFilter(filter));
-			}
-		});
-		auto *filters_to_use = remapped_filters.get();
-#else
-		// DuckDB v1.5.x: filters are already keyed by schema column index.
-		auto filters_copy = get.table_filters.Copy();
-		auto *filters_to_use = filters_copy.get();
-#endif
+	if (filters && MongoHasFilters(*filters)) {
+		auto filters_to_use = CopyFiltersBySchemaIndex(*filters, column_ids);
 		auto simple =
-		    ConvertFiltersToMongoQuery(optional_ptr<TableFilterSet>(filters_to_use), data.column_names,
-		                               data.column_types, data.column_name_to_mongo_path, data.objectid_columns);
+		    ConvertFiltersToMongoQuery(optional_ptr<TableFilterSet>(filters_to_use.get()), data.column_names,
+		                               data.column_types, data.column_name_to_mongo_path, data.objectid_columns,
+		                               GetServerConvertedColumns(data));
 		if (!DocIsEmpty(simple.view())) {
 			conjuncts.push_back(std::move(simple));
 		}
@@ -160,6 +198,16 @@ static bsoncxx::document::value BuildMatchFromExistingFilters(const LogicalGet &
 		conjuncts.push_back(expr_doc.extract());
 	}
 
+	// MAP key prefilter (dotted paths)
+	if (!data.map_filter_query.view().empty()) {
+		conjuncts.push_back(bsoncxx::document::value(data.map_filter_query.view()));
+	}
+
+	// DROPMALFORMED type checks
+	if (!data.schema_type_filter.view().empty()) {
+		conjuncts.push_back(bsoncxx::document::value(data.schema_type_filter.view()));
+	}
+
 	if (conjuncts.empty()) {
 		return bsoncxx::builder::basic::document {}.extract();
 	}
@@ -176,6 +224,10 @@ static bsoncxx::document::value BuildMatchFromExistingFilters(const LogicalGet &
 	return match.extract();
 }
 
+static bsoncxx::document::value BuildMatchFromExistingFilters(const LogicalGet &get, const MongoScanData &data) {
+	return BuildMatchFromExistingFilters(&get.table_filters, get.GetColumnIds(), data);
+}
+
 static bool IsSimpleColumnRef(const Expression &expr, mongo_table_index_t expected_table_index, idx_t &out_col_idx) {
 	if (expr.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
 		return false;
@@ -318,6 +370,7 @@ static string BuildTopNPipelineJson(const LogicalGet &get, const MongoScanData &
 		match_stage.append(bsoncxx::builder::basic::kvp("$match", match_doc.view()));
 		stages.push_back(match_stage.extract());
 	}
+	AppendServerConversionStage(data, stages);
 
 	bsoncxx::builder::basic::document sort_spec;
 	sort_spec.append(bsoncxx::builder::basic::kvp("_id", order == OrderType::ASCENDING ? 1 : -1));
@@ -369,7 +422,14 @@ static bool RewriteMongoTopN(unique_ptr<LogicalOperator> &node) {
 		return false;
 	}
 	auto bind = GetMongoBindData(get);
-	if (!bind) {
+	if (!bind || !bind->pipeline_json.empty()) {
+		return false;
+	}
+	// Rows dropped after the server's $limit would leave fewer than LIMIT rows
+	if (bind->schema_mode == SchemaMode::DROPMALFORMED && !SchemaEnforcementPushable(*bind)) {
+		return false;
+	}
+	if (!FiltersFullyPushable(get, *bind)) {
 		return false;
 	}
 
@@ -396,27 +456,82 @@ static bool RewriteMongoTopN(unique_ptr<LogicalOperator> &node) {
 	return true;
 }
 
-static string BuildAggregatePipelineJson(const LogicalGet &get, const MongoScanData &data,
-                                         const vector<pair<string, string>> &group_fields,
-                                         const vector<pair<string, bsoncxx::document::value>> &aggs,
-                                         bool ungrouped_count_only) {
-	vector<bsoncxx::document::value> stages;
+// ORDER BY _id above a find scan: the scan requests an _id sort from the server (served by the _id index) and the
+// ORDER BY is removed, so the result streams in order instead of being fully sorted in DuckDB. Only the first sort
+// key matters, _id being unique. The scan is then read by a single thread and insertion order must be preserved.
+static bool RewriteMongoOrderById(ClientContext &context, unique_ptr<LogicalOperator> &node) {
+	if (!node || node->type != LogicalOperatorType::LOGICAL_ORDER_BY || node->children.size() != 1) {
+		return false;
+	}
+	auto &order_by = node->Cast<LogicalOrder>();
+	if (order_by.orders.empty() || !order_by.orders[0].expression) {
+		return false;
+	}
+	if (!DBConfig::GetConfig(context).options.preserve_insertion_order) {
+		return false;
+	}
 
-	auto match_doc = BuildMatchFromExistingFilters(get, data);
-	if (!DocIsEmpty(match_doc.view())) {
-		bsoncxx::builder::basic::document match_stage;
-		match_stage.append(bsoncxx::builder::basic::kvp("$match", match_doc.view()));
-		stages.push_back(match_stage.extract());
+	// Projections and filters between the ORDER BY and the scan keep the scan's order
+	vector<LogicalProjection *> projections;
+	LogicalOperator *scan_child = node->children[0].get();
+	while (scan_child && scan_child->children.size() == 1 &&
+	       (scan_child->type == LogicalOperatorType::LOGICAL_PROJECTION ||
+	        scan_child->type == LogicalOperatorType::LOGICAL_FILTER)) {
+		if (scan_child->type == LogicalOperatorType::LOGICAL_PROJECTION) {
+			projections.push_back(&scan_child->Cast<LogicalProjection>());
+		}
+		scan_child = scan_child->children[0].get();
+	}
+	if (!scan_child || scan_child->type != LogicalOperatorType::LOGICAL_GET) {
+		return false;
+	}
+	auto &get = scan_child->Cast<LogicalGet>();
+	if (!IsMongoScan(get)) {
+		return false;
+	}
+	auto bind = GetMongoBindData(get);
+	if (!bind || !bind->pipeline_json.empty() || bind->sort_by_id != 0) {
+		return false;
 	}
 
-	if (ungrouped_count_only) {
-		// Use $count for COUNT(*) queries
-		bsoncxx::builder::basic::document count_stage;
-		count_stage.append(bsoncxx::builder::basic::kvp("$count", "count"));
-		stages.push_back(count_stage.extract());
-		return JoinJsonArray(stages);
+	auto &order = order_by.orders[0];
+	idx_t order_col_idx;
+	if (!ResolveColumnRefToScanWithName(*order.expression, projections, *bind, get.table_index, order_col_idx)) {
+		return false;
+	}
+	if (order_col_idx >= bind->column_names.size() || !StringUtil::CIEquals(bind->column_names[order_col_idx], "_id")) {
+		return false;
+	}
+	// MongoDB orders mixed BSON types by type first; DuckDB's order only matches for a single scalar type
+	if (bind->conflicted_columns.count(bind->column_names[order_col_idx])) {
+		return false;
+	}
+	switch (bind->column_types[order_col_idx].id()) {
+	case LogicalTypeId::VARCHAR:
+	case LogicalTypeId::BIGINT:
+	case LogicalTypeId::HUGEINT:
+	case LogicalTypeId::DOUBLE:
+	case LogicalTypeId::DATE:
+	case LogicalTypeId::TIMESTAMP:
+		break;
+	default:
+		return false;
 	}
 
+	auto new_bind = make_uniq<MongoScanData>();
+	*new_bind = *bind;
+	new_bind->sort_by_id = order.type == OrderType::DESCENDING ? -1 : 1;
+	// Threads decoding batches of one cursor emit them out of order
+	new_bind->decode_threads = 1;
+	get.bind_data = std::move(new_bind);
+	node = std::move(order_by.children[0]);
+	return true;
+}
+
+// $group on group_fields (or on nothing) followed by a $project flattening _id
+static void AppendGroupStages(const vector<pair<string, string>> &group_fields,
+                              const vector<pair<string, bsoncxx::document::value>> &aggs,
+                              vector<bsoncxx::document::value> &stages) {
 	// $group stage
 	bsoncxx::builder::basic::document group_spec;
 	if (group_fields.empty()) {
@@ -448,7 +563,112 @@ static string BuildAggregatePipelineJson(const LogicalGet &get, const MongoScanD
 	bsoncxx::builder::basic::document project_stage;
 	project_stage.append(bsoncxx::builder::basic::kvp("$project", project_spec.extract()));
 	stages.push_back(project_stage.extract());
+}
+
+// {$facet: {<name>: [stages...], ...}} followed by the stages turning its single output document back into one
+// document per row of every branch. That document is limited to 16 MB, so fallback_pipeline_json gets the same rows
+// without it: the first branch after the stages so far, and every other branch after them again in a $unionWith
+// (reading the collection once per branch).
+static void AppendFacetStages(const string &collection_name,
+                              const vector<pair<string, vector<bsoncxx::document::value>>> &branches,
+                              vector<bsoncxx::document::value> &stages, string &fallback_pipeline_json) {
+	vector<bsoncxx::document::value> fallback = stages;
+	for (idx_t branch_idx = 0; branch_idx < branches.size(); branch_idx++) {
+		auto &branch_stages = branches[branch_idx].second;
+		if (branch_idx == 0) {
+			fallback.insert(fallback.end(), branch_stages.begin(), branch_stages.end());
+			continue;
+		}
+		bsoncxx::builder::basic::array union_pipeline;
+		for (const auto &stage : stages) {
+			union_pipeline.append(stage.view());
+		}
+		for (const auto &stage : branch_stages) {
+			union_pipeline.append(stage.view());
+		}
+		bsoncxx::builder::basic::document union_spec;
+		union_spec.append(bsoncxx::builder::basic::kvp("coll", collection_name));
+		union_spec.append(bsoncxx::builder::basic::kvp("pipeline", union_pipeline.extract()));
+		bsoncxx::builder::basic::document union_stage;
+		union_stage.append(bsoncxx::builder::basic::kvp("$unionWith", union_spec.extract()));
+		fallback.push_back(union_stage.extract());
+	}
+	fallback_pipeline_json = JoinJsonArray(fallback);
+
+	bsoncxx::builder::basic::document facet_spec;
+	bsoncxx::builder::basic::array concat_args;
+	for (const auto &branch : branches) {
+		bsoncxx::builder::basic::array branch_stages;
+		for (const auto &stage : branch.second) {
+			branch_stages.append(stage.view());
+		}
+		facet_spec.append(bsoncxx::builder::basic::kvp(branch.first, branch_stages.extract()));
+		concat_args.append(StringUtil::Format("$%s", branch.first));
+	}
+	bsoncxx::builder::basic::document facet_stage;
+	facet_stage.append(bsoncxx::builder::basic::kvp("$facet", facet_spec.extract()));
+	stages.push_back(facet_stage.extract());
+
+	// {$project: {rows: {$concatArrays: [...]}}}, {$unwind: "$rows"}, {$replaceRoot: {newRoot: "$rows"}}
+	bsoncxx::builder::basic::document concat;
+	concat.append(bsoncxx::builder::basic::kvp("$concatArrays", concat_args.extract()));
+	bsoncxx::builder::basic::document rows_spec;
+	rows_spec.append(bsoncxx::builder::basic::kvp("rows", concat.extract()));
+	bsoncxx::builder::basic::document rows_stage;
+	rows_stage.append(bsoncxx::builder::basic::kvp("$project", rows_spec.extract()));
+	stages.push_back(rows_stage.extract());
+
+	bsoncxx::builder::basic::document unwind_stage;
+	unwind_stage.append(bsoncxx::builder::basic::kvp("$unwind", "$rows"));
+	stages.push_back(unwind_stage.extract());
+
+	bsoncxx::builder::basic::document root_spec;
+	root_spec.append(bsoncxx::builder::basic::kvp("newRoot", "$rows"));
+	bsoncxx::builder::basic::document root_stage;
+	root_stage.append(bsoncxx::builder::basic::kvp("$replaceRoot", root_spec.extract()));
+	stages.push_back(root_stage.extract());
+}
+
+// grouping_sets holds indexes into group_fields; with more than one set (GROUPING SETS, ROLLUP, CUBE) every set
+// becomes a $facet branch grouping on its own keys, and the keys of other sets are missing (NULL) in its rows
+static string BuildAggregatePipelineJson(const LogicalGet &get, const MongoScanData &data,
+                                         const vector<pair<string, string>> &group_fields,
+                                         const vector<pair<string, bsoncxx::document::value>> &aggs,
+                                         bool ungrouped_count_only, const vector<vector<idx_t>> &grouping_sets,
+                                         string &facet_fallback_json) {
+	vector<bsoncxx::document::value> stages;
+
+	auto match_doc = BuildMatchFromExistingFilters(get, data);
+	if (!DocIsEmpty(match_doc.view())) {
+		bsoncxx::builder::basic::document match_stage;
+		match_stage.append(bsoncxx::builder::basic::kvp("$match", match_doc.view()));
+		stages.push_back(match_stage.extract());
+	}
+
+	if (ungrouped_count_only) {
+		// Use $count for COUNT(*) queries
+		bsoncxx::builder::basic::document count_stage;
+		count_stage.append(bsoncxx::builder::basic::kvp("$count", "count"));
+		stages.push_back(count_stage.extract());
+		return JoinJsonArray(stages);
+	}
+	AppendServerConversionStage(data, stages);
 
+	if (grouping_sets.size() <= 1) {
+		AppendGroupStages(group_fields, aggs, stages);
+		return JoinJsonArray(stages);
+	}
+	vector<pair<string, vector<bsoncxx::document::value>>> branches;
+	for (idx_t set_idx = 0; set_idx < grouping_sets.size(); set_idx++) {
+		vector<pair<string, string>> set_fields;
+		for (auto group_idx : grouping_sets[set_idx]) {
+			set_fields.push_back(group_fields[group_idx]);
+		}
+		vector<bsoncxx::document::value> branch_stages;
+		AppendGroupStages(set_fields, aggs, branch_stages);
+		branches.emplace_back(StringUtil::Format("set%llu", set_idx), std::move(branch_stages));
+	}
+	AppendFacetStages(data.collection_name, branches, stages, facet_fallback_json);
 	return JoinJsonArray(stages);
 }
 
@@ -460,7 +680,8 @@ static bool RewriteMongoAggregate(unique_ptr<LogicalOperator> &node, vector<Bind
 	if (aggr.children.size() != 1) {
 		return false;
 	}
-	if (aggr.grouping_sets.size() > 1 || !aggr.grouping_functions.empty()) {
+	// GROUPING SETS / ROLLUP / CUBE become $facet branches; GROUPING() has no pipeline equivalent
+	if (!aggr.grouping_functions.empty()) {
 		return false;
 	}
 
@@ -481,13 +702,16 @@ static bool RewriteMongoAggregate(unique_ptr<LogicalOperator> &node, vector<Bind
 		return false;
 	}
 	auto bind = GetMongoBindData(get);
-	if (!bind) {
+	if (!bind || !bind->pipeline_json.empty()) {
 		return false;
 	}
 
-	// Disable aggregate pushdown when schema enforcement is needed
-	// (non-PERMISSIVE mode with explicit schema requires DuckDB-side validation)
-	if (bind->has_explicit_schema && bind->schema_mode != SchemaMode::PERMISSIVE) {
+	// Disable aggregate pushdown when schema enforcement needs DuckDB-side validation: FAILFAST must see every
+	// document, and DROPMALFORMED only when its server-side type filter is not exact
+	if (!SchemaEnforcementPushable(*bind)) {
+		return false;
+	}
+	if (!FiltersFullyPushable(get, *bind)) {
 		return false;
 	}
 
@@ -598,7 +822,15 @@ static bool RewriteMongoAggregate(unique_ptr<LogicalOperator> &node, vector<Bind
 		out_types = {LogicalType::BIGINT};
 	}
 
-	auto pipeline_json = BuildAggregatePipelineJson(get, *bind, group_fields, agg_specs, count_star_only);
+	vector<vector<idx_t>> grouping_sets;
+	if (aggr.grouping_sets.size() > 1) {
+		for (auto &grouping_set : aggr.grouping_sets) {
+			grouping_sets.emplace_back(grouping_set.begin(), grouping_set.end());
+		}
+	}
+	string facet_fallback_json;
+	auto pipeline_json = BuildAggregatePipelineJson(get, *bind, group_fields, agg_specs, count_star_only,
+	                                                grouping_sets, facet_fallback_json);
 
 	// Build new bind data for the pipeline output schema
 	auto new_bind = make_uniq<MongoScanData>();
@@ -608,6 +840,9 @@ static bool RewriteMongoAggregate(unique_ptr<LogicalOperator> &node, vector<Bind
 	new_bind->collection_name = bind->collection_name;
 	new_bind->filter_query = ""; // folded into pipeline
 	new_bind->pipeline_json = pipeline_json;
+	// $facet can't be nested, so grouping sets (already a $facet) are not merged
+	new_bind->facet_mergeable = !count_star_only && grouping_sets.empty();
+	new_bind->facet_fallback_pipeline_json = facet_fallback_json;
 	new_bind->sample_size = bind->sample_size;
 	new_bind->column_names = out_names;
 	new_bind->column_types = out_types;
@@ -641,33 +876,1079 @@ static bool RewriteMongoAggregate(unique_ptr<LogicalOperator> &node, vector<Bind
 	return true;
 }
 
-static void RewriteMongoPlans(unique_ptr<LogicalOperator> &node, vector<BindingMapRule> &binding_rules) {
-	if (!node) {
-		return;
+// Number of references to any column of `table_index` in the expressions of `op` and its descendants
+static idx_t CountTableReferences(LogicalOperator &op, mongo_table_index_t table_index) {
+	idx_t count = 0;
+	LogicalOperatorVisitor::EnumerateExpressions(op, [&](unique_ptr<Expression> *expr) {
+		ExpressionIterator::VisitExpression<BoundColumnRefExpression>(
+		    **expr, [&](const BoundColumnRefExpression &colref) {
+			    if (MongoColumnBinding(colref).table_index == table_index) {
+				    count++;
+			    }
+		    });
+	});
+	for (auto &child : op.children) {
+		if (child) {
+			count += CountTableReferences(*child, table_index);
+		}
 	}
+	return count;
+}
 
-	// Try rewriting this node first (may replace it entirely)
-	if (RewriteMongoTopN(node)) {
-		// node replaced, continue rewriting at this node
-		RewriteMongoPlans(node, binding_rules);
-		return;
+// Schema column read at output position `position` of a scan (through its projection_ids, if any)
+static bool ResolveScanOutputColumn(const LogicalGet &get, const MongoScanData &data, idx_t position,
+                                    idx_t &out_col_idx) {
+	if (!get.projection_ids.empty()) {
+		if (position >= get.projection_ids.size()) {
+			return false;
+		}
+		position = get.projection_ids[position];
 	}
-	if (RewriteMongoAggregate(node, binding_rules)) {
+	auto &column_ids = get.GetColumnIds();
+	if (position >= column_ids.size()) {
+		return false;
+	}
+	out_col_idx = column_ids[position].GetPrimaryIndex();
+	return out_col_idx < data.column_names.size();
+}
+
+// Partial aggregate computed below the join for one aggregate of the query
+struct EagerAggregate {
+	//! "sum", "min" or "max"
+	string kind;
+	//! Schema column of the aggregated column
+	idx_t col_idx;
+};
+
+// Column types whose $min/$max order in MongoDB matches DuckDB's min/max of the scanned values
+static bool EagerMinMaxType(const LogicalType &type) {
+	switch (type.id()) {
+	case LogicalTypeId::BOOLEAN:
+	case LogicalTypeId::BIGINT:
+	case LogicalTypeId::DOUBLE:
+	case LogicalTypeId::VARCHAR:
+	case LogicalTypeId::DATE:
+	case LogicalTypeId::TIMESTAMP:
+		return true;
+	default:
+		return false;
+	}
+}
+
+// $match on the scan's filters, then a $group on the keys computing every partial aggregate. A partial $sum of a
+// group without numbers is 0 in MongoDB, so it is turned into null, which DuckDB's sum skips like the missing rows.
+static string BuildEagerAggregatePipelineJson(const LogicalGet &get, const MongoScanData &data,
+                                              const vector<idx_t> &key_cols, const vector<EagerAggregate> &aggregates) {
+	using bsoncxx::builder::basic::kvp;
+	vector<bsoncxx::document::value> stages;
+	auto match_doc = BuildMatchFromExistingFilters(get, data);
+	if (!DocIsEmpty(match_doc.view())) {
+		bsoncxx::builder::basic::document match_stage;
+		match_stage.append(kvp("$match", match_doc.view()));
+		stages.push_back(match_stage.extract());
+	}
+	AppendServerConversionStage(data, stages);
+
+	vector<pair<string, string>> group_fields;
+	for (idx_t i = 0; i < key_cols.size(); i++) {
+		auto &col_name = data.column_names[key_cols[i]];
+		group_fields.emplace_back(StringUtil::Format("__key%llu", i), data.column_name_to_mongo_path.at(col_name));
+	}
+	vector<pair<string, bsoncxx::document::value>> aggs;
+	bsoncxx::builder::basic::document null_sums;
+	for (idx_t i = 0; i < aggregates.size(); i++) {
+		auto &col_name = data.column_names[aggregates[i].col_idx];
+		auto field = StringUtil::Format("$%s", data.column_name_to_mongo_path.at(col_name));
+		auto out_field = StringUtil::Format("__agg%llu", i);
+		bsoncxx::builder::basic::document spec;
+		spec.append(kvp(StringUtil::Format("$%s", aggregates[i].kind), field));
+		aggs.emplace_back(out_field, spec.extract());
+		if (aggregates[i].kind != "sum") {
+			continue;
+		}
+		// __cntN: {$sum: {$cond: [{$isNumber: "$col"}, 1, 0]}}
+		auto count_field = StringUtil::Format("__cnt%llu", i);
+		bsoncxx::builder::basic::array cond_args;
+		cond_args.append(bsoncxx::builder::basic::make_document(kvp("$isNumber", field)));
+		cond_args.append(1);
+		cond_args.append(0);
+		bsoncxx::builder::basic::document count_spec;
+		count_spec.append(kvp("$sum", bsoncxx::builder::basic::make_document(kvp("$cond", cond_args.extract()))));
+		aggs.emplace_back(count_field, count_spec.extract());
+
+		// __aggN: {$cond: [{$gt: ["$__cntN", 0]}, "$__aggN", null]}
+		bsoncxx::builder::basic::array gt_args;
+		gt_args.append("$" + count_field);
+		gt_args.append(0);
+		bsoncxx::builder::basic::array null_args;
+		null_args.append(bsoncxx::builder::basic::make_document(kvp("$gt", gt_args.extract())));
+		null_args.append("$" + out_field);
+		null_args.append(bsoncxx::types::b_null {});
+		null_sums.append(kvp(out_field, bsoncxx::builder::basic::make_document(kvp("$cond", null_args.extract()))));
+	}
+	AppendGroupStages(group_fields, aggs, stages);
+	auto null_sums_doc = null_sums.extract();
+	if (!DocIsEmpty(null_sums_doc.view())) {
+		bsoncxx::builder::basic::document add_fields_stage;
+		add_fields_stage.append(kvp("$addFields", null_sums_doc.view()));
+		stages.push_back(add_fields_stage.extract());
+	}
+	return JoinJsonArray(stages);
+}
+
+// Eager aggregation: SUM, MIN and MAX of the columns of a find scan joined (inner equi-join) with another input are
+// computed partially below the join by a $group on the scan's join keys and GROUP BY columns. The scan then returns
+// one row per key instead of one per document, and the aggregate above the join combines the partial results (a
+// sum of sums, a min of mins), which is correct for any number of matches on the other side.
+static bool RewriteMongoEagerAggregate(ClientContext &context, LogicalOperator &node) {
+	if (node.type != LogicalOperatorType::LOGICAL_AGGREGATE_AND_GROUP_BY || node.children.size() != 1) {
+		return false;
+	}
+	auto &aggr = node.Cast<LogicalAggregate>();
+	if (aggr.grouping_sets.size() > 1 || !aggr.grouping_functions.empty() || aggr.expressions.empty()) {
+		return false;
+	}
+	auto &join_op = *aggr.children[0];
+	if (join_op.type != LogicalOperatorType::LOGICAL_COMPARISON_JOIN || join_op.children.size() != 2) {
+		return false;
+	}
+	auto &join = join_op.Cast<LogicalComparisonJoin>();
+	if (join.join_type != JoinType::INNER || join.conditions.empty()) {
+		return false;
+	}
+	for (auto &condition : join.conditions) {
+		if (condition.comparison != ExpressionType::COMPARE_EQUAL &&
+		    condition.comparison != ExpressionType::COMPARE_NOT_DISTINCT_FROM) {
+			return false;
+		}
+	}
+	Value enabled;
+	if (context.TryGetCurrentSetting(EAGER_AGGREGATION_SETTING, enabled) && !enabled.IsNull() &&
+	    !BooleanValue::Get(enabled)) {
+		return false;
+	}
+
+	for (idx_t side = 0; side < 2; side++) {
+		auto &child = join.children[side];
+		if (child->type != LogicalOperatorType::LOGICAL_GET) {
+			continue;
+		}
+		auto &get = child->Cast<LogicalGet>();
+		if (!IsMongoScan(get)) {
+			continue;
+		}
+		auto bind = GetMongoBindData(get);
+		if (!bind || !bind->pipeline_json.empty() || bind->sort_by_id != 0 || !SchemaEnforcementPushable(*bind)) {
+			continue;
+		}
+		// Every filter must be part of the $match: a residual filter needs the documents the $group merges
+		if (!FiltersFullyPushable(get, *bind)) {
+			continue;
+		}
+		const auto table_index = get.table_index;
+
+		// Every reference to the scan must be a join key, a GROUP BY key or the argument of a SUM, MIN or MAX
+		vector<idx_t> key_positions;
+		vector<idx_t> key_cols;
+		idx_t references = 0;
+		auto add_key = [&](const Expression &expr) {
+			idx_t position;
+			if (!IsSimpleColumnRef(expr, table_index, position)) {
+				return false;
+			}
+			idx_t col_idx;
+			if (!ResolveScanOutputColumn(get, *bind, position, col_idx) ||
+			    !bind->column_name_to_mongo_path.count(bind->column_names[col_idx])) {
+				return false;
+			}
+			references++;
+			if (std::find(key_positions.begin(), key_positions.end(), position) == key_positions.end()) {
+				key_positions.push_back(position);
+				key_cols.push_back(col_idx);
+			}
+			return true;
+		};
+		bool eligible = true;
+		for (auto &condition : join.conditions) {
+			auto &scan_side = side == 0 ? condition.left : condition.right;
+			eligible = eligible && add_key(*scan_side);
+		}
+		for (auto &group : aggr.groups) {
+			bool scan_column = false;
+			ExpressionIterator::VisitExpression<BoundColumnRefExpression>(
+			    *group, [&](const BoundColumnRefExpression &colref) {
+				    scan_column = scan_column || MongoColumnBinding(colref).table_index == table_index;
+			    });
+			if (scan_column) {
+				eligible = eligible && add_key(*group);
+			}
+		}
+		vector<EagerAggregate> aggregates;
+		for (auto &expr : aggr.expressions) {
+			if (!eligible || expr->GetExpressionClass() != ExpressionClass::BOUND_AGGREGATE) {
+				eligible = false;
+				break;
+			}
+			auto &aggregate = expr->Cast<BoundAggregateExpression>();
+			auto fname = StringUtil::Lower(MONGO_FUNCTION_NAME(MongoAggregateFunction(aggregate)));
+			if (fname == "sum_no_overflow") {
+				fname = "sum";
+			}
+			const auto &children = MongoAggregateChildren(aggregate);
+			idx_t position;
+			idx_t col_idx;
+			// Aggregates of the other input would need the number of documents behind every partial row
+			if ((fname != "sum" && fname != "min" && fname != "max") || aggregate.IsDistinct() ||
+			    MongoAggregateFilter(aggregate) || MongoAggregateOrderBys(aggregate) || children.size() != 1 ||
+			    !IsSimpleColumnRef(*children[0], table_index, position) ||
+			    !ResolveScanOutputColumn(get, *bind, position, col_idx) ||
+			    !bind->column_name_to_mongo_path.count(bind->column_names[col_idx]) ||
+			    bind->conflicted_columns.count(bind->column_names[col_idx])) {
+				eligible = false;
+				break;
+			}
+			auto &col_type = bind->column_types[col_idx];
+			if (fname == "sum" ? col_type.id() != LogicalTypeId::BIGINT && col_type.id() != LogicalTypeId::DOUBLE
+			                   : !EagerMinMaxType(col_type)) {
+				eligible = false;
+				break;
+			}
+			references++;
+			aggregates.push_back(EagerAggregate {fname, col_idx});
+		}
+		if (!eligible || CountTableReferences(node, table_index) != references) {
+			continue;
+		}
+
+		// The partial aggregation's output: the keys, then one column per aggregate
+		auto pipeline_json = BuildEagerAggregatePipelineJson(get, *bind, key_cols, aggregates);
+		vector<string> out_names;
+		vector<LogicalType> out_types;
+		for (idx_t i = 0; i < key_cols.size(); i++) {
+			out_names.push_back(StringUtil::Format("__key%llu", i));
+			out_types.push_back(bind->column_types[key_cols[i]]);
+		}
+		for (idx_t i = 0; i < aggregates.size(); i++) {
+			out_names.push_back(StringUtil::Format("__agg%llu", i));
+			out_types.push_back(bind->column_types[aggregates[i].col_idx]);
+		}
+
+		auto new_bind = make_uniq<MongoScanData>();
+		new_bind->connection_string = bind->connection_string;
+		new_bind->connection = bind->connection;
+		new_bind->database_name = bind->database_name;
+		new_bind->collection_name = bind->collection_name;
+		new_bind->pipeline_json = pipeline_json;
+		new_bind->sample_size = bind->sample_size;
+		new_bind->column_names = out_names;
+		new_bind->column_types = out_types;
+		for (auto &name : out_names) {
+			new_bind->column_name_to_mongo_path[name] = name;
+		}
+
+		// The scan is changed in place, as the join's filter pushdown may refer to it; its references move to the
+		// new column positions and its table filters are already part of the pipeline
+		get.bind_data = std::move(new_bind);
+		get.named_parameters["pipeline"] = Value(pipeline_json);
+		get.returned_types = out_types;
+		get.names = MongoMakeColumnNames(out_names);
+		get.table_filters = TableFilterSet();
+		get.projection_ids.clear();
+		vector<ColumnIndex> column_ids;
+		for (idx_t i = 0; i < out_names.size(); i++) {
+			column_ids.emplace_back(i);
+		}
+		get.SetColumnIds(std::move(column_ids));
+
+		auto move_key = [&](unique_ptr<Expression> &expr) {
+			ExpressionIterator::VisitExpressionMutable<BoundColumnRefExpression>(
+			    expr, [&](BoundColumnRefExpression &colref, unique_ptr<Expression> &ref) {
+				    (void)ref;
+				    auto &binding = MongoColumnBindingMutable(colref);
+				    if (binding.table_index == table_index) {
+					    auto it = std::find(key_positions.begin(), key_positions.end(), idx_t(binding.column_index));
+					    binding.column_index = decltype(binding.column_index)(idx_t(it - key_positions.begin()));
+				    }
+			    });
+		};
+		for (auto &condition : join.conditions) {
+			move_key(side == 0 ? condition.left : condition.right);
+		}
+		for (auto &group : aggr.groups) {
+			move_key(group);
+		}
+		for (idx_t i = 0; i < aggr.expressions.size(); i++) {
+			auto &aggregate = aggr.expressions[i]->Cast<BoundAggregateExpression>();
+			auto &argument = MongoAggregateChildren(aggregate)[0]->Cast<BoundColumnRefExpression>();
+			auto &binding = MongoColumnBindingMutable(argument);
+			binding.column_index = decltype(binding.column_index)(key_positions.size() + i);
+		}
+		// The projection map selected columns of the replaced scan; all columns of the new one pass the join
+		(side == 0 ? join.left_projection_map : join.right_projection_map).clear();
+		return true;
+	}
+	return false;
+}
+
+// One input of a UNION ALL that reads a pushed-down aggregation: its pipeline split into the shared $match and the
+// remaining stages, plus a $project mapping the union's columns onto the pipeline's output fields
+struct FacetBranch {
+	LogicalGet *get;
+	MongoScanData *bind;
+	string match_json;
+	vector<bsoncxx::document::value> stages;
+};
+
+// Collects the inputs of a (possibly nested) UNION ALL
+static void CollectUnionAllInputs(unique_ptr<LogicalOperator> &node, vector<unique_ptr<LogicalOperator> *> &inputs) {
+	if (node->type == LogicalOperatorType::LOGICAL_UNION && node->Cast<LogicalSetOperation>().setop_all &&
+	    node->children.size() == 2) {
+		CollectUnionAllInputs(node->children[0], inputs);
+		CollectUnionAllInputs(node->children[1], inputs);
 		return;
 	}
+	inputs.push_back(&node);
+}
 
-	// Recurse
-	for (auto &child : node->children) {
-		RewriteMongoPlans(child, binding_rules);
+// $project value producing a constant union column (NULL or a simple scalar). Only types the scan decodes are
+// accepted: an INTEGER literal would come back NULL.
+static bool AppendFacetConstant(bsoncxx::builder::basic::document &project_spec, const string &field,
+                                const Value &value) {
+	bsoncxx::builder::basic::document literal;
+	if (value.IsNull()) {
+		literal.append(bsoncxx::builder::basic::kvp("$literal", bsoncxx::types::b_null {}));
+	} else {
+		switch (value.type().id()) {
+		case LogicalTypeId::VARCHAR:
+			literal.append(bsoncxx::builder::basic::kvp("$literal", StringValue::Get(value)));
+			break;
+		case LogicalTypeId::BIGINT:
+			literal.append(bsoncxx::builder::basic::kvp("$literal", value.GetValue<int64_t>()));
+			break;
+		case LogicalTypeId::DOUBLE:
+			literal.append(bsoncxx::builder::basic::kvp("$literal", value.GetValue<double>()));
+			break;
+		case LogicalTypeId::BOOLEAN:
+			literal.append(bsoncxx::builder::basic::kvp("$literal", value.GetValue<bool>()));
+			break;
+		default:
+			return false;
+		}
 	}
+	project_spec.append(bsoncxx::builder::basic::kvp(field, literal.extract()));
+	return true;
 }
 
-void MongoOptimizerOptimize(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
-	(void)input;
-	vector<BindingMapRule> binding_rules;
-	RewriteMongoPlans(plan, binding_rules);
-	if (!binding_rules.empty() && plan) {
-		ApplyBindingRulesToOperator(*plan, binding_rules);
+// Resolves one UNION ALL input: a pushed-down aggregation scan, optionally under a projection of its columns and
+// constants. The stages get a final $project naming the fields after the union's columns.
+static bool ResolveFacetBranch(LogicalOperator &input, const vector<LogicalType> &union_types,
+                               const vector<string> &union_names, FacetBranch &branch) {
+	LogicalProjection *projection = nullptr;
+	LogicalOperator *scan_child = &input;
+	if (scan_child->type == LogicalOperatorType::LOGICAL_PROJECTION && scan_child->children.size() == 1) {
+		projection = &scan_child->Cast<LogicalProjection>();
+		scan_child = scan_child->children[0].get();
+	}
+	if (scan_child->type != LogicalOperatorType::LOGICAL_GET) {
+		return false;
+	}
+	auto &get = scan_child->Cast<LogicalGet>();
+	if (!IsMongoScan(get)) {
+		return false;
+	}
+	auto bind = GetMongoBindData(get);
+	if (!bind || !bind->facet_mergeable) {
+		return false;
+	}
+	auto &column_ids = get.GetColumnIds();
+
+	bsoncxx::builder::basic::document project_spec;
+	for (idx_t col_idx = 0; col_idx < union_types.size(); col_idx++) {
+		const Expression *expr = nullptr;
+		if (projection) {
+			if (projection->expressions.size() != union_types.size()) {
+				return false;
+			}
+			expr = projection->expressions[col_idx].get();
+			if (MONGO_EXPR_RETURN_TYPE(*expr) != union_types[col_idx]) {
+				return false;
+			}
+			if (expr->GetExpressionClass() == ExpressionClass::BOUND_CONSTANT) {
+				if (!AppendFacetConstant(project_spec, union_names[col_idx],
+				                         MongoConstantValue(expr->Cast<BoundConstantExpression>()))) {
+					return false;
+				}
+				continue;
+			}
+		}
+		idx_t get_col_idx = col_idx;
+		if (expr) {
+			if (!IsSimpleColumnRef(*expr, get.table_index, get_col_idx)) {
+				return false;
+			}
+		} else if (column_ids.size() != union_types.size()) {
+			return false;
+		}
+		if (get_col_idx >= column_ids.size()) {
+			return false;
+		}
+		idx_t field_idx = column_ids[get_col_idx].GetPrimaryIndex();
+		if (field_idx >= bind->column_names.size() || bind->column_types[field_idx] != union_types[col_idx]) {
+			return false;
+		}
+		project_spec.append(bsoncxx::builder::basic::kvp(
+		    union_names[col_idx], StringUtil::Format("$%s", bind->column_names[field_idx])));
+	}
+
+	// Split the pipeline into its leading $match (shared by all branches) and the branch stages
+	auto wrapped = bsoncxx::from_json(StringUtil::Format("{\"pipeline\": %s}", bind->pipeline_json));
+	auto pipeline = wrapped.view()["pipeline"].get_array().value;
+	bool first = true;
+	for (auto it = pipeline.begin(); it != pipeline.end(); ++it) {
+		auto stage_doc = it->get_document().value;
+		if (first && stage_doc["$match"]) {
+			branch.match_json = bsoncxx::to_json(stage_doc["$match"].get_document().value);
+		} else {
+			branch.stages.emplace_back(stage_doc);
+		}
+		first = false;
+	}
+	project_spec.append(bsoncxx::builder::basic::kvp("_id", 0));
+	bsoncxx::builder::basic::document project_stage;
+	project_stage.append(bsoncxx::builder::basic::kvp("$project", project_spec.extract()));
+	branch.stages.push_back(project_stage.extract());
+	branch.get = &get;
+	branch.bind = bind.get();
+	return true;
+}
+
+// UNION ALL of aggregations pushed down over the same collection and filter becomes one scan running every
+// aggregation as a branch of a single $facet, so the collection is read once
+static bool MergeMongoFacets(unique_ptr<LogicalOperator> &node) {
+	if (node->type != LogicalOperatorType::LOGICAL_UNION || !node->Cast<LogicalSetOperation>().setop_all) {
+		return false;
+	}
+	auto &setop = node->Cast<LogicalSetOperation>();
+	node->ResolveOperatorTypes();
+	auto union_types = node->types;
+	vector<string> union_names;
+	for (idx_t col_idx = 0; col_idx < union_types.size(); col_idx++) {
+		union_names.push_back(StringUtil::Format("__col%llu", col_idx));
+	}
+
+	vector<unique_ptr<LogicalOperator> *> inputs;
+	CollectUnionAllInputs(node, inputs);
+	vector<FacetBranch> branches(inputs.size());
+	for (idx_t i = 0; i < inputs.size(); i++) {
+		if (!ResolveFacetBranch(**inputs[i], union_types, union_names, branches[i])) {
+			return false;
+		}
+		auto &first = *branches[0].bind;
+		auto &bind = *branches[i].bind;
+		if (bind.connection_string != first.connection_string || bind.database_name != first.database_name ||
+		    bind.collection_name != first.collection_name || branches[i].match_json != branches[0].match_json) {
+			return false;
+		}
+	}
+
+	vector<bsoncxx::document::value> stages;
+	if (!branches[0].match_json.empty()) {
+		auto match_doc = bsoncxx::from_json(branches[0].match_json);
+		bsoncxx::builder::basic::document match_stage;
+		match_stage.append(bsoncxx::builder::basic::kvp("$match", match_doc.view()));
+		stages.push_back(match_stage.extract());
+	}
+	vector<pair<string, vector<bsoncxx::document::value>>> facet_branches;
+	for (idx_t i = 0; i < branches.size(); i++) {
+		facet_branches.emplace_back(StringUtil::Format("branch%llu", i), std::move(branches[i].stages));
+	}
+	string facet_fallback_json;
+	AppendFacetStages(branches[0].bind->collection_name, facet_branches, stages, facet_fallback_json);
+	auto pipeline_json = JoinJsonArray(stages);
+
+	auto &first_get = *branches[0].get;
+	auto new_bind = make_uniq<MongoScanData>();
+	new_bind->connection_string = branches[0].bind->connection_string;
+	new_bind->connection = branches[0].bind->connection;
+	new_bind->database_name = branches[0].bind->database_name;
+	new_bind->collection_name = branches[0].bind->collection_name;
+	new_bind->pipeline_json = pipeline_json;
+	new_bind->facet_fallback_pipeline_json = facet_fallback_json;
+	new_bind->sample_size = branches[0].bind->sample_size;
+	new_bind->column_names = union_names;
+	new_bind->column_types = union_types;
+	for (auto &name : union_names) {
+		new_bind->column_name_to_mongo_path[name] = name;
+	}
+
+	// The scan takes over the union's bindings
+	auto replacement = make_uniq<LogicalGet>(setop.table_index, first_get.function, std::move(new_bind), union_types,
+	                                         MongoMakeColumnNames(union_names));
+	replacement->named_parameters = first_get.named_parameters;
+	replacement->named_parameters["pipeline"] = Value(pipeline_json);
+	replacement->parameters = first_get.parameters;
+	vector<ColumnIndex> column_ids;
+	for (idx_t i = 0; i < union_names.size(); i++) {
+		column_ids.emplace_back(i);
+	}
+	replacement->SetColumnIds(std::move(column_ids));
+	node = std::move(replacement);
+	return true;
+}
+
+static void MergeMongoFacetPlans(unique_ptr<LogicalOperator> &node) {
+	if (!node || MergeMongoFacets(node)) {
+		return;
+	}
+	for (auto &child : node->children) {
+		MergeMongoFacetPlans(child);
+	}
+}
+
+// Resolves an UNNEST element, or a field of it reached through struct_extract, to its MongoDB path below the
+// unwound array and its type
+static bool ResolveUnwoundElementPath(const Expression &expr, mongo_table_index_t unnest_index,
+                                      const string &array_path, const LogicalType &element_type, string &out_path,
+                                      LogicalType &out_type) {
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF) {
+		const auto &binding = MongoColumnBinding(expr.Cast<BoundColumnRefExpression>());
+		if (binding.table_index != unnest_index || binding.column_index != 0) {
+			return false;
+		}
+		out_path = array_path;
+		out_type = element_type;
+		return true;
+	}
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &func_expr = expr.Cast<BoundFunctionExpression>();
+	const auto func_name = StringUtil::Lower(MONGO_FUNCTION_NAME(MongoFuncFunction(func_expr)));
+	const auto &children = MongoFuncChildren(func_expr);
+	if ((func_name != "struct_extract" && func_name != "struct_extract_at") || children.size() != 2 ||
+	    children[1]->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		return false;
+	}
+	string parent_path;
+	LogicalType parent_type;
+	if (!ResolveUnwoundElementPath(*children[0], unnest_index, array_path, element_type, parent_path, parent_type) ||
+	    parent_type.id() != LogicalTypeId::STRUCT) {
+		return false;
+	}
+	auto key = MongoConstantValue(children[1]->Cast<BoundConstantExpression>());
+	if (key.IsNull()) {
+		return false;
+	}
+	auto child_count = StructType::GetChildCount(parent_type);
+	idx_t child_idx = DConstants::INVALID_INDEX;
+	if (func_name == "struct_extract_at") {
+		auto position = key.GetValue<int64_t>();
+		if (position >= 1 && idx_t(position) <= child_count) {
+			child_idx = idx_t(position - 1);
+		}
+	} else {
+		auto key_str = key.GetValue<string>();
+		for (idx_t i = 0; i < child_count; i++) {
+			if (StringUtil::CIEquals(MongoStructChildName(parent_type, i), key_str)) {
+				child_idx = i;
+				break;
+			}
+		}
+	}
+	if (child_idx == DConstants::INVALID_INDEX) {
+		return false;
+	}
+	// Field names that MongoDB would read as a nested path or an operator can't be expressed with dot notation
+	auto &child_name = MongoStructChildName(parent_type, child_idx);
+	if (child_name.empty() || child_name.find('.') != string::npos || child_name[0] == '$') {
+		return false;
+	}
+	out_path = parent_path + "." + child_name;
+	out_type = StructType::GetChildType(parent_type, child_idx);
+	return true;
+}
+
+// Converts `element <op> constant` (or `element.field <op> constant`) into a query on the unwound array path. Used
+// as a prefilter: the FILTER stays in the plan, so it only needs to match a superset of the qualifying rows.
+static bool ConvertUnwoundElementComparison(const Expression &expr, mongo_table_index_t unnest_index,
+                                            const string &array_path, const LogicalType &element_type,
+                                            vector<bsoncxx::document::value> &element_filters) {
+	if (!MongoIsComparisonExpr(expr) || expr.IsVolatile()) {
+		return false;
+	}
+	auto comparison_type = expr.GetExpressionType();
+	const Expression *element_expr = &MongoComparisonLeft(expr);
+	const Expression *constant_expr = &MongoComparisonRight(expr);
+	if (constant_expr->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		std::swap(element_expr, constant_expr);
+		comparison_type = FlipComparisonExpression(comparison_type);
+	}
+	if (constant_expr->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		return false;
+	}
+	switch (comparison_type) {
+	case ExpressionType::COMPARE_EQUAL:
+	case ExpressionType::COMPARE_NOTEQUAL:
+	case ExpressionType::COMPARE_LESSTHAN:
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+	case ExpressionType::COMPARE_GREATERTHAN:
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		break;
+	default:
+		return false;
+	}
+
+	string mongo_path;
+	LogicalType value_type;
+	if (!ResolveUnwoundElementPath(*element_expr, unnest_index, array_path, element_type, mongo_path, value_type)) {
+		return false;
+	}
+	auto constant = MongoConstantValue(constant_expr->Cast<BoundConstantExpression>());
+	Value casted_constant;
+	string error_message;
+	if (constant.IsNull() || !constant.DefaultTryCastAs(value_type, casted_constant, &error_message, true)) {
+		return false;
+	}
+	auto filter_doc = BuildMongoPathComparison(comparison_type, casted_constant, mongo_path, value_type);
+	if (filter_doc.view().empty()) {
+		return false;
+	}
+	element_filters.push_back(std::move(filter_doc));
+	return true;
+}
+
+// Number of references to a column binding in the plan, not counting the expressions of `skip`
+static idx_t CountBindingReferences(LogicalOperator &op, const LogicalOperator &skip, mongo_table_index_t table_index,
+                                    idx_t column_index) {
+	idx_t count = 0;
+	if (&op != &skip) {
+		LogicalOperatorVisitor::EnumerateExpressions(op, [&](unique_ptr<Expression> *expr) {
+			ExpressionIterator::VisitExpression<BoundColumnRefExpression>(
+			    **expr, [&](const BoundColumnRefExpression &colref) {
+				    const auto &binding = MongoColumnBinding(colref);
+				    if (binding.table_index == table_index && idx_t(binding.column_index) == column_index) {
+					    count++;
+				    }
+			    });
+		});
+	}
+	for (auto &child : op.children) {
+		if (child) {
+			count += CountBindingReferences(*child, skip, table_index, column_index);
+		}
+	}
+	return count;
+}
+
+// Whether the scan has a pushed-down table filter on the column at `column_index` of its column ids
+static bool HasTableFilterOnColumn(LogicalGet &get, idx_t column_index) {
+	if (!MongoHasFilters(get.table_filters)) {
+		return false;
+	}
+#ifdef DUCKDB_MAIN_VECTOR_API
+	// Filters are keyed by the position within column_ids
+	idx_t filter_key = column_index;
+#else
+	idx_t filter_key = get.GetColumnIds()[column_index].GetPrimaryIndex();
+#endif
+	bool found = false;
+	auto filters_copy = get.table_filters.Copy();
+	MongoForEachFilter(*filters_copy, [&](idx_t filter_idx, TableFilter &filter) {
+		(void)filter;
+		found = found || filter_idx == filter_key;
+	});
+	return found;
+}
+
+// $match on the scan's filters and on the array's type, $unwind of the array, $match on the element filters and a
+// $project of the scanned columns. Non-array values are dropped first: $unwind would return them as a single
+// element, while the LIST column reads them as NULL, which UNNEST drops.
+static string BuildUnwindPipelineJson(const LogicalGet &get, const MongoScanData &data, const string &array_path,
+                                      const vector<bsoncxx::document::value> &element_filters) {
+	using bsoncxx::builder::basic::kvp;
+	vector<bsoncxx::document::value> stages;
+
+	bsoncxx::builder::basic::document is_array;
+	is_array.append(kvp("$type", "array"));
+	bsoncxx::builder::basic::document array_check;
+	array_check.append(kvp(array_path, is_array.extract()));
+	bsoncxx::builder::basic::array and_terms;
+	auto match_doc = BuildMatchFromExistingFilters(get, data);
+	if (!DocIsEmpty(match_doc.view())) {
+		and_terms.append(match_doc.view());
+	}
+	and_terms.append(array_check.extract());
+	bsoncxx::builder::basic::document and_doc;
+	and_doc.append(kvp("$and", and_terms.extract()));
+	bsoncxx::builder::basic::document match_stage;
+	match_stage.append(kvp("$match", and_doc.extract()));
+	stages.push_back(match_stage.extract());
+	AppendServerConversionStage(data, stages);
+
+	bsoncxx::builder::basic::document unwind_stage;
+	unwind_stage.append(kvp("$unwind", "$" + array_path));
+	stages.push_back(unwind_stage.extract());
+
+	if (!element_filters.empty()) {
+		bsoncxx::builder::basic::document element_match;
+		if (element_filters.size() == 1) {
+			element_match.append(kvp("$match", element_filters[0].view()));
+		} else {
+			bsoncxx::builder::basic::array element_terms;
+			for (auto &filter : element_filters) {
+				element_terms.append(filter.view());
+			}
+			bsoncxx::builder::basic::document element_and;
+			element_and.append(kvp("$and", element_terms.extract()));
+			element_match.append(kvp("$match", element_and.extract()));
+		}
+		stages.push_back(element_match.extract());
+	}
+
+	vector<column_t> projection_ids;
+	for (auto &column_id : get.GetColumnIds()) {
+		projection_ids.push_back(column_id.GetPrimaryIndex());
+	}
+	auto projection = BuildMongoProjection(projection_ids, data.column_names, data.column_name_to_mongo_path, {}, {},
+	                                       data.sampled_paths);
+	if (!DocIsEmpty(projection.view())) {
+		bsoncxx::builder::basic::document project_stage;
+		project_stage.append(kvp("$project", projection.view()));
+		stages.push_back(project_stage.extract());
+	}
+	return JoinJsonArray(stages);
+}
+
+// UNNEST of a LIST column read directly from a find scan becomes a $unwind in a pipeline, so the server returns one
+// document per element. Comparisons on the element (or its fields) in the FILTERs right above the UNNEST also become
+// a $match after the $unwind. The scan's column then holds the element and takes over the UNNEST's binding.
+static bool RewriteMongoUnnest(LogicalOperator &root, unique_ptr<LogicalOperator> &node,
+                               const vector<LogicalFilter *> &filters, vector<BindingMapRule> &binding_rules) {
+	if (!node || node->type != LogicalOperatorType::LOGICAL_UNNEST || node->children.size() != 1 ||
+	    node->expressions.size() != 1) {
+		return false;
+	}
+	auto &unnest = node->Cast<LogicalUnnest>();
+	if (!unnest.children[0] || unnest.children[0]->type != LogicalOperatorType::LOGICAL_GET) {
+		return false;
+	}
+	auto &get = unnest.children[0]->Cast<LogicalGet>();
+	if (!IsMongoScan(get)) {
+		return false;
+	}
+	auto bind = GetMongoBindData(get);
+	if (!bind || !bind->pipeline_json.empty() || bind->sort_by_id != 0 || !SchemaEnforcementPushable(*bind) ||
+	    !FiltersFullyPushable(get, *bind)) {
+		return false;
+	}
+
+	auto &unnest_expr = *unnest.expressions[0];
+	if (unnest_expr.GetExpressionClass() != ExpressionClass::BOUND_UNNEST) {
+		return false;
+	}
+	auto &list_expr = *unnest_expr.Cast<BoundUnnestExpression>().child;
+	if (list_expr.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+		return false;
+	}
+	const auto &binding = MongoColumnBinding(list_expr.Cast<BoundColumnRefExpression>());
+	auto &column_ids = get.GetColumnIds();
+	if (binding.table_index != get.table_index || binding.column_index >= column_ids.size()) {
+		return false;
+	}
+	idx_t list_position = binding.column_index;
+	idx_t col_idx = column_ids[list_position].GetPrimaryIndex();
+	if (col_idx >= bind->column_names.size() || bind->column_types[col_idx].id() != LogicalTypeId::LIST) {
+		return false;
+	}
+	auto element_type = ListType::GetChildType(bind->column_types[col_idx]);
+	if (MONGO_EXPR_RETURN_TYPE(unnest_expr) != element_type) {
+		return false;
+	}
+	// The scan's column changes from the list to its element, so nothing else may read the list
+	if (CountBindingReferences(root, unnest, get.table_index, list_position) > 0 ||
+	    HasTableFilterOnColumn(get, list_position)) {
+		return false;
+	}
+	const auto &column_name = bind->column_names[col_idx];
+	auto path_it = bind->column_name_to_mongo_path.find(column_name);
+	const string array_path = path_it != bind->column_name_to_mongo_path.end() ? path_it->second : column_name;
+	if (array_path.empty() || array_path[0] == '$') {
+		return false;
+	}
+
+	vector<bsoncxx::document::value> element_filters;
+	for (auto *filter : filters) {
+		for (auto &expr : filter->expressions) {
+			ConvertUnwoundElementComparison(*expr, unnest.unnest_index, array_path, element_type, element_filters);
+		}
+	}
+	auto pipeline_json = BuildUnwindPipelineJson(get, *bind, array_path, element_filters);
+
+	auto new_bind = make_uniq<MongoScanData>();
+	*new_bind = *bind;
+	new_bind->pipeline_json = pipeline_json;
+	new_bind->column_types[col_idx] = element_type;
+	get.bind_data = std::move(new_bind);
+	get.named_parameters["pipeline"] = Value(pipeline_json);
+	get.returned_types[col_idx] = element_type;
+
+	binding_rules.push_back(BindingMapRule {unnest.unnest_index, get.table_index, list_position});
+	node = std::move(unnest.children[0]);
+	return true;
+}
+
+// `filters` holds the chain of FILTERs directly above `node`
+static void RewriteMongoUnnests(LogicalOperator &root, unique_ptr<LogicalOperator> &node,
+                                vector<LogicalFilter *> &filters, vector<BindingMapRule> &binding_rules) {
+	if (!node) {
+		return;
+	}
+	if (node->type == LogicalOperatorType::LOGICAL_FILTER && node->children.size() == 1) {
+		filters.push_back(&node->Cast<LogicalFilter>());
+		RewriteMongoUnnests(root, node->children[0], filters, binding_rules);
+		filters.pop_back();
+		return;
+	}
+	if (RewriteMongoUnnest(root, node, filters, binding_rules)) {
+		return;
+	}
+	for (auto &child : node->children) {
+		vector<LogicalFilter *> child_filters;
+		RewriteMongoUnnests(root, child, child_filters, binding_rules);
+	}
+}
+
+static void RewriteMongoPlans(ClientContext &context, unique_ptr<LogicalOperator> &node,
+                              vector<BindingMapRule> &binding_rules) {
+	if (!node) {
+		return;
+	}
+
+	// Try rewriting this node first (may replace it entirely)
+	if (RewriteMongoTopN(node) || RewriteMongoOrderById(context, node)) {
+		// node replaced, continue rewriting at this node
+		RewriteMongoPlans(context, node, binding_rules);
+		return;
+	}
+	if (RewriteMongoAggregate(node, binding_rules)) {
+		return;
+	}
+	// The join's other input may hold further rewritable plans
+	RewriteMongoEagerAggregate(context, *node);
+
+	// Recurse
+	for (auto &child : node->children) {
+		RewriteMongoPlans(context, child, binding_rules);
+	}
+}
+
+// Moves the references to output `position` of the operator with `table_index` to new_positions[position]
+static void RemapScanReferences(LogicalOperator &op, mongo_table_index_t table_index,
+                                const vector<idx_t> &new_positions) {
+	LogicalOperatorVisitor::EnumerateExpressions(op, [&](unique_ptr<Expression> *expr) {
+		ExpressionIterator::VisitExpressionMutable<BoundColumnRefExpression>(
+		    *expr, [&](BoundColumnRefExpression &colref, unique_ptr<Expression> &child) {
+			    (void)child;
+			    auto &binding = MongoColumnBindingMutable(colref);
+			    if (binding.table_index == table_index && idx_t(binding.column_index) < new_positions.size()) {
+				    binding.column_index = decltype(binding.column_index)(new_positions[idx_t(binding.column_index)]);
+			    }
+		    });
+	});
+	for (auto &child : op.children) {
+		if (child) {
+			RemapScanReferences(*child, table_index, new_positions);
+		}
+	}
+}
+
+// Projection expressions over a find scan that the server can compute (see ConvertMongoComputedExpression) become
+// computed fields of the cursor's projection: the scan returns them as extra columns, which the projection reads
+// instead. Source columns the plan no longer references are dropped from the scan's projection_ids, so they are
+// not fetched (their table filters stay pushed down).
+static bool RewriteMongoComputedColumns(LogicalOperator &root, LogicalOperator &node) {
+	if (node.type != LogicalOperatorType::LOGICAL_PROJECTION || node.children.size() != 1) {
+		return false;
+	}
+	auto &projection = node.Cast<LogicalProjection>();
+	LogicalOperator *scan_child = projection.children[0].get();
+	while (scan_child && scan_child->type == LogicalOperatorType::LOGICAL_FILTER && scan_child->children.size() == 1) {
+		// A filter's projection map selects the scan's output positions, which the rewrite renumbers
+		if (!scan_child->Cast<LogicalFilter>().projection_map.empty()) {
+			return false;
+		}
+		scan_child = scan_child->children[0].get();
+	}
+	if (!scan_child || scan_child->type != LogicalOperatorType::LOGICAL_GET) {
+		return false;
+	}
+	auto &get = scan_child->Cast<LogicalGet>();
+	if (!IsMongoScan(get)) {
+		return false;
+	}
+	auto bind = GetMongoBindData(get);
+	if (!bind || !bind->pipeline_json.empty() ||
+	    (bind->has_explicit_schema && bind->schema_mode != SchemaMode::PERMISSIVE)) {
+		return false;
+	}
+
+	// Projection expressions computed by the server, with a reference to the scan they are rebound from
+	vector<idx_t> computed_exprs;
+	vector<bsoncxx::document::value> computed_docs;
+	vector<ColumnBinding> computed_bindings;
+	for (idx_t expr_idx = 0; expr_idx < projection.expressions.size(); expr_idx++) {
+		auto &expr = *projection.expressions[expr_idx];
+		bsoncxx::document::value computed = bsoncxx::builder::basic::document {}.extract();
+		if (!ConvertMongoComputedExpression(expr, get, *bind, computed)) {
+			continue;
+		}
+		optional_ptr<const BoundColumnRefExpression> column;
+		ExpressionIterator::VisitExpression<BoundColumnRefExpression>(
+		    expr, [&](const BoundColumnRefExpression &colref) { column = &colref; });
+		if (!column) {
+			continue;
+		}
+		computed_exprs.push_back(expr_idx);
+		computed_docs.push_back(std::move(computed));
+		computed_bindings.push_back(MongoColumnBinding(*column));
+	}
+	if (computed_exprs.empty()) {
+		return false;
+	}
+
+	// Output positions of the scan still referenced once the computed expressions are replaced
+	vector<LogicalType> computed_types;
+	for (auto expr_idx : computed_exprs) {
+		computed_types.push_back(MONGO_EXPR_RETURN_TYPE(*projection.expressions[expr_idx]));
+		projection.expressions[expr_idx] = make_uniq<BoundConstantExpression>(Value());
+	}
+	auto column_ids = get.GetColumnIds();
+	idx_t output_count = get.projection_ids.empty() ? column_ids.size() : get.projection_ids.size();
+	decltype(get.projection_ids) projection_ids;
+	vector<idx_t> new_positions(output_count, DConstants::INVALID_INDEX);
+	for (idx_t position = 0; position < output_count; position++) {
+		if (CountBindingReferences(root, get, get.table_index, position) == 0) {
+			continue;
+		}
+		new_positions[position] = projection_ids.size();
+		projection_ids.emplace_back(get.projection_ids.empty() ? position : idx_t(get.projection_ids[position]));
+	}
+	RemapScanReferences(root, get.table_index, new_positions);
+
+	auto new_bind = make_uniq<MongoScanData>();
+	*new_bind = *bind;
+	for (idx_t i = 0; i < computed_exprs.size(); i++) {
+		auto name = StringUtil::Format("__computed%llu", new_bind->computed_columns.size());
+		new_bind->column_names.push_back(name);
+		new_bind->column_types.push_back(computed_types[i]);
+		new_bind->column_name_to_mongo_path[name] = name;
+		new_bind->computed_columns.emplace(name, std::move(computed_docs[i]));
+		get.returned_types.push_back(computed_types[i]);
+		column_ids.emplace_back(new_bind->column_names.size() - 1);
+
+		auto binding = computed_bindings[i];
+		binding.column_index = decltype(binding.column_index)(idx_t(projection_ids.size()));
+		projection_ids.emplace_back(column_ids.size() - 1);
+		projection.expressions[computed_exprs[i]] = make_uniq<BoundColumnRefExpression>(computed_types[i], binding);
+	}
+	get.names = MongoMakeColumnNames(new_bind->column_names);
+	get.bind_data = std::move(new_bind);
+	get.SetColumnIds(std::move(column_ids));
+	get.projection_ids = std::move(projection_ids);
+	return true;
+}
+
+static void RewriteMongoComputedColumnPlans(LogicalOperator &root, LogicalOperator &node) {
+	RewriteMongoComputedColumns(root, node);
+	for (auto &child : node.children) {
+		if (child) {
+			RewriteMongoComputedColumnPlans(root, *child);
+		}
+	}
+}
+
+bool BuildMongoScanPipeline(const MongoScanData &data, optional_ptr<const TableFilterSet> filters,
+                            const vector<ColumnIndex> &column_ids, vector<bsoncxx::document::value> &stages) {
+	if (!data.pipeline_json.empty()) {
+		// Filters are already part of the pipeline; the scan ignores its table filters
+		try {
+			auto wrapped = bsoncxx::from_json(StringUtil::Format("{\"pipeline\": %s}", data.pipeline_json));
+			auto pipeline = wrapped.view()["pipeline"];
+			if (!pipeline || pipeline.type() != bsoncxx::type::k_array) {
+				return false;
+			}
+			for (auto &stage : pipeline.get_array().value) {
+				if (stage.type() != bsoncxx::type::k_document) {
+					return false;
+				}
+				stages.emplace_back(stage.get_document().value);
+			}
+		} catch (const std::exception &) {
+			return false;
+		}
+		return true;
+	}
+	if (!SchemaEnforcementPushable(data) || !FiltersFullyPushable(filters, column_ids, data)) {
+		return false;
+	}
+	auto match_doc = BuildMatchFromExistingFilters(filters, column_ids, data);
+	if (!DocIsEmpty(match_doc.view())) {
+		bsoncxx::builder::basic::document match_stage;
+		match_stage.append(bsoncxx::builder::basic::kvp("$match", match_doc.view()));
+		stages.push_back(match_stage.extract());
+	}
+	if (data.sort_by_id != 0) {
+		bsoncxx::builder::basic::document sort_spec;
+		sort_spec.append(bsoncxx::builder::basic::kvp("_id", data.sort_by_id));
+		bsoncxx::builder::basic::document sort_stage;
+		sort_stage.append(bsoncxx::builder::basic::kvp("$sort", sort_spec.extract()));
+		stages.push_back(sort_stage.extract());
+	}
+	AppendServerConversionStage(data, stages);
+	if (!data.computed_columns.empty()) {
+		std::map<string, bsoncxx::document::view> sorted_columns;
+		for (auto &column : data.computed_columns) {
+			sorted_columns.emplace(column.first, column.second.view());
+		}
+		bsoncxx::builder::basic::document fields;
+		for (auto &column : sorted_columns) {
+			fields.append(bsoncxx::builder::basic::kvp(column.first, column.second));
+		}
+		bsoncxx::builder::basic::document stage;
+		stage.append(bsoncxx::builder::basic::kvp("$addFields", fields.extract()));
+		stages.push_back(stage.extract());
+	}
+	return true;
+}
+
+void RegisterMongoOptimizerSettings(DBConfig &config) {
+	config.AddExtensionOption(EAGER_AGGREGATION_SETTING,
+	                          "Compute SUM, MIN and MAX of a MongoDB collection joined with another input partially "
+	                          "in MongoDB, with a $group on the join keys below the join",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
+}
+
+void MongoOptimizerOptimize(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
+	// The other rewrites match the unwound scans with their final bindings
+	vector<BindingMapRule> unnest_rules;
+	vector<LogicalFilter *> filters;
+	if (plan) {
+		RewriteMongoUnnests(*plan, plan, filters, unnest_rules);
+	}
+	if (!unnest_rules.empty() && plan) {
+		ApplyBindingRulesToOperator(*plan, unnest_rules);
+	}
+
+	vector<BindingMapRule> binding_rules;
+	RewriteMongoPlans(input.context, plan, binding_rules);
+	if (!binding_rules.empty() && plan) {
+		ApplyBindingRulesToOperator(*plan, binding_rules);
+	}
+	// Runs on the rewritten plan: the union inputs must already be pipeline scans with their final bindings
+	MergeMongoFacetPlans(plan);
+	// Last, so that the other rewrites only see the collection's own fields
+	if (plan) {
+		RewriteMongoComputedColumnPlans(*plan, *plan);
 	}
 }
 
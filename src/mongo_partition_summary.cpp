@@ -0,0 +1,507 @@
+#include "mongo_partition_summary.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/oid.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/change_stream.hpp>
+#include <mongocxx/exception/exception.hpp>
+#include <mongocxx/exception/operation_exception.hpp>
+#include <mongocxx/options/aggregate.hpp>
+#include <mongocxx/options/change_stream.hpp>
+#include <mongocxx/pipeline.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+namespace duckdb {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+//! Change events read before a summary is rebuilt instead
+static constexpr idx_t MAX_SUMMARY_CHANGES = 10000;
+
+static bool CompareValues(const bsoncxx::types::bson_value::view &left, const bsoncxx::types::bson_value::view &right,
+                          int &result);
+
+MongoPartitionSummaryCache &MongoPartitionSummaryCache::Get() {
+	static MongoPartitionSummaryCache cache;
+	return cache;
+}
+
+// Document count and $min and $max accumulators of _id and of every summarized field
+static void AppendSummaryAccumulators(bsoncxx::builder::basic::document &output, const vector<string> &paths) {
+	output.append(kvp("count", make_document(kvp("$sum", 1))));
+	output.append(kvp("min_id", make_document(kvp("$min", "$_id"))));
+	output.append(kvp("max_id", make_document(kvp("$max", "$_id"))));
+	for (idx_t path_idx = 0; path_idx < paths.size(); path_idx++) {
+		output.append(kvp("min_" + std::to_string(path_idx), make_document(kvp("$min", "$" + paths[path_idx]))));
+		output.append(kvp("max_" + std::to_string(path_idx), make_document(kvp("$max", "$" + paths[path_idx]))));
+	}
+}
+
+static bsoncxx::types::bson_value::value SummaryValue(const bsoncxx::document::view &doc, const string &name) {
+	auto element = doc[name];
+	if (!element) {
+		return bsoncxx::types::bson_value::value(bsoncxx::types::b_null {});
+	}
+	return bsoncxx::types::bson_value::value(element.get_value());
+}
+
+static MongoPartition ReadPartition(const bsoncxx::document::view &doc, idx_t path_count) {
+	MongoPartition partition {SummaryValue(doc, "min_id"), SummaryValue(doc, "max_id"), {}, {}};
+	for (idx_t path_idx = 0; path_idx < path_count; path_idx++) {
+		partition.min_values.push_back(SummaryValue(doc, "min_" + std::to_string(path_idx)));
+		partition.max_values.push_back(SummaryValue(doc, "max_" + std::to_string(path_idx)));
+	}
+	return partition;
+}
+
+// _id range filters are type-bracketed: a summary is only used when every _id has the same type
+static bool HasUniformIdType(const vector<MongoPartition> &partitions) {
+	for (auto &partition : partitions) {
+		if (partition.min_id.view().type() != partitions[0].min_id.view().type() ||
+		    partition.max_id.view().type() != partitions[0].min_id.view().type()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static shared_ptr<const MongoPartitionSummary> BuildSummary(mongocxx::collection &collection,
+                                                            const vector<string> &paths, idx_t partition_count) {
+	auto result = make_shared_ptr<MongoPartitionSummary>();
+	result->paths = paths;
+
+	bsoncxx::builder::basic::document output;
+	AppendSummaryAccumulators(output, paths);
+	mongocxx::pipeline pipeline;
+	pipeline.append_stage(make_document(kvp(
+	    "$bucketAuto", make_document(kvp("groupBy", "$_id"), kvp("buckets", NumericCast<int32_t>(partition_count)),
+	                                 kvp("output", output.extract())))));
+	mongocxx::options::aggregate options;
+	options.allow_disk_use(true);
+	for (auto &doc : collection.aggregate(pipeline, options)) {
+		result->partitions.push_back(ReadPartition(doc, paths.size()));
+	}
+	if (!HasUniformIdType(result->partitions)) {
+		result->partitions.clear();
+	}
+	return std::move(result);
+}
+
+// Summarizes the documents past the last partition into a new one; returns nullptr when there are none
+static shared_ptr<const MongoPartitionSummary> ExtendSummary(mongocxx::collection &collection,
+                                                             const MongoPartitionSummary &summary) {
+	bsoncxx::builder::basic::document group;
+	group.append(kvp("_id", bsoncxx::types::b_null {}));
+	AppendSummaryAccumulators(group, summary.paths);
+	mongocxx::pipeline pipeline;
+	pipeline.match(
+	    make_document(kvp("_id", make_document(kvp("$gt", summary.partitions.back().max_id.view())))));
+	pipeline.group(group.extract());
+	auto cursor = collection.aggregate(pipeline);
+	auto it = cursor.begin();
+	if (it == cursor.end()) {
+		return nullptr;
+	}
+	auto result = make_shared_ptr<MongoPartitionSummary>(summary);
+	result->partitions.push_back(ReadPartition(*it, summary.paths.size()));
+	if (!HasUniformIdType(result->partitions)) {
+		result->partitions.clear();
+	}
+	return std::move(result);
+}
+
+// Opens a change stream on the collection and sets `resume_token` to its start, before the summary is built, so that
+// the next scan sees every write the summary may have missed. Returns false when the deployment has no change
+// streams (a standalone server).
+static bool StartSummaryChanges(mongocxx::collection &collection, bsoncxx::document::value &resume_token) {
+	mongocxx::options::change_stream options;
+	options.max_await_time(std::chrono::milliseconds(1));
+	try {
+		auto stream = collection.watch(options);
+		for (auto &event : stream) {
+			(void)event;
+		}
+		auto token = stream.get_resume_token();
+		if (!token) {
+			return false;
+		}
+		resume_token = bsoncxx::document::value(*token);
+		return true;
+	} catch (const mongocxx::operation_exception &) {
+		return false;
+	}
+}
+
+// Whether an update event may have changed a summarized field: a path, one of its parents or one of its children
+// was set, removed or truncated
+static bool UpdateTouchesPaths(const bsoncxx::document::element &description, const vector<string> &paths) {
+	if (!description || description.type() != bsoncxx::type::k_document) {
+		return true;
+	}
+	auto touches = [&](const string &field) {
+		for (auto &path : paths) {
+			if (field == path || StringUtil::StartsWith(field, path + ".") ||
+			    StringUtil::StartsWith(path, field + ".")) {
+				return true;
+			}
+		}
+		return false;
+	};
+	auto updated = description.get_document().value["updatedFields"];
+	if (updated && updated.type() == bsoncxx::type::k_document) {
+		for (auto &field : updated.get_document().value) {
+			if (touches(string(field.key()))) {
+				return true;
+			}
+		}
+	}
+	auto removed = description.get_document().value["removedFields"];
+	if (removed && removed.type() == bsoncxx::type::k_array) {
+		for (auto &field : removed.get_array().value) {
+			if (field.type() != bsoncxx::type::k_string || touches(string(field.get_string().value))) {
+				return true;
+			}
+		}
+	}
+	auto truncated = description.get_document().value["truncatedArrays"];
+	if (truncated && truncated.type() == bsoncxx::type::k_array) {
+		for (auto &array : truncated.get_array().value) {
+			auto field = array.type() == bsoncxx::type::k_document ? array.get_document().value["field"]
+			                                                       : bsoncxx::document::element();
+			if (!field || field.type() != bsoncxx::type::k_string || touches(string(field.get_string().value))) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// Reads the change events since `resume_token` and advances it. Deletes only narrow the values of a partition and
+// updates of other fields leave them unchanged; inserts past the last _id set `appended`. Returns false when the
+// summary must be rebuilt: any other event, too many events, or a token the oplog no longer holds.
+static bool ReadSummaryChanges(mongocxx::collection &collection, const MongoPartitionSummary &summary,
+                               bsoncxx::document::value &resume_token, bool &appended) {
+	mongocxx::options::change_stream options;
+	options.resume_after(resume_token.view());
+	options.max_await_time(std::chrono::milliseconds(1));
+	try {
+		auto stream = collection.watch(options);
+		idx_t change_count = 0;
+		bool polled_events = true;
+		while (polled_events) {
+			polled_events = false;
+			for (auto &event : stream) {
+				polled_events = true;
+				if (++change_count > MAX_SUMMARY_CHANGES) {
+					return false;
+				}
+				auto operation = event["operationType"];
+				auto operation_type = operation && operation.type() == bsoncxx::type::k_string
+				                          ? string(operation.get_string().value)
+				                          : string();
+				if (operation_type == "delete") {
+					continue;
+				}
+				if (operation_type == "update") {
+					if (UpdateTouchesPaths(event["updateDescription"], summary.paths)) {
+						return false;
+					}
+					continue;
+				}
+				if (operation_type != "insert" || summary.partitions.empty()) {
+					return false;
+				}
+				auto key = event["documentKey"];
+				auto id = key && key.type() == bsoncxx::type::k_document ? key.get_document().value["_id"]
+				                                                        : bsoncxx::document::element();
+				int compared;
+				if (!id || id.type() != summary.partitions.back().max_id.view().type() ||
+				    !CompareValues(id.get_value(), summary.partitions.back().max_id.view(), compared) ||
+				    compared <= 0) {
+					return false;
+				}
+				appended = true;
+			}
+		}
+		auto token = stream.get_resume_token();
+		if (!token) {
+			return false;
+		}
+		resume_token = bsoncxx::document::value(*token);
+		return true;
+	} catch (const mongocxx::operation_exception &) {
+		return false;
+	}
+}
+
+shared_ptr<const MongoPartitionSummary>
+MongoPartitionSummaryCache::GetSummary(const std::string &connection_string, const std::string &database_name,
+                                       mongocxx::collection &collection, const vector<string> &paths,
+                                       idx_t partition_count) {
+	auto key = connection_string + "\n" + database_name + "\n" + string(collection.name()) + "\n" +
+	           StringUtil::Join(paths, "\n") + "\n" + std::to_string(partition_count);
+	shared_ptr<Entry> entry;
+	{
+		lock_guard<mutex> guard(lock);
+		auto &slot = entries[key];
+		if (!slot) {
+			slot = make_shared_ptr<Entry>();
+		}
+		entry = slot;
+	}
+
+	// Concurrent scans of the collection wait for the one building or extending the summary
+	lock_guard<mutex> guard(entry->lock);
+	try {
+		if (entry->summary) {
+			bool appended = false;
+			if (!ReadSummaryChanges(collection, *entry->summary, entry->resume_token, appended)) {
+				entry->summary = nullptr;
+			} else if (appended) {
+				auto extended = ExtendSummary(collection, *entry->summary);
+				if (extended && extended->partitions.size() > 2 * partition_count) {
+					// Rebalances many small partitions of recent inserts
+					entry->summary = nullptr;
+				} else if (extended) {
+					entry->summary = std::move(extended);
+				}
+			}
+		}
+		if (!entry->summary) {
+			if (!StartSummaryChanges(collection, entry->resume_token)) {
+				return nullptr;
+			}
+			entry->summary = BuildSummary(collection, paths, partition_count);
+		}
+	} catch (const mongocxx::exception &e) {
+		entry->summary = nullptr;
+		throw IOException("Failed to build the partition summary of MongoDB collection \"%s.%s\": %s", database_name,
+		                  string(collection.name()), e.what());
+	}
+	return entry->summary;
+}
+
+void MongoPartitionSummaryCache::Clear() {
+	lock_guard<mutex> guard(lock);
+	entries.clear();
+}
+
+// Condition of a find filter on a summarized field
+struct MongoFieldCondition {
+	string op;
+	bsoncxx::types::bson_value::view value;
+};
+
+static void CollectConditions(const bsoncxx::document::view &filter, const vector<string> &paths,
+                              vector<vector<MongoFieldCondition>> &conditions) {
+	for (auto &element : filter) {
+		auto key = string(element.key());
+		if (key == "$and" && element.type() == bsoncxx::type::k_array) {
+			for (auto &term : element.get_array().value) {
+				if (term.type() == bsoncxx::type::k_document) {
+					CollectConditions(term.get_document().value, paths, conditions);
+				}
+			}
+			continue;
+		}
+		auto path = std::find(paths.begin(), paths.end(), key);
+		if (path == paths.end()) {
+			continue;
+		}
+		auto &field_conditions = conditions[idx_t(path - paths.begin())];
+		if (element.type() != bsoncxx::type::k_document) {
+			field_conditions.push_back({"$eq", element.get_value()});
+			continue;
+		}
+		// An embedded document literal is an equality on the whole document, which is never pruned
+		auto operators = element.get_document().value;
+		if (operators.empty() || operators.begin()->key().empty() || operators.begin()->key()[0] != '$') {
+			continue;
+		}
+		for (auto &op : operators) {
+			field_conditions.push_back({string(op.key()), op.get_value()});
+		}
+	}
+}
+
+// Compares two values like a query does, when both are numbers, strings, dates, ObjectIds or booleans. Between two
+// values of one of these types, the BSON order only has values of that type, so a partition whose min and max have
+// the type of a constant only holds values of that type.
+static bool CompareValues(const bsoncxx::types::bson_value::view &left, const bsoncxx::types::bson_value::view &right,
+                          int &result) {
+	auto is_number = [](bsoncxx::type type) {
+		return type == bsoncxx::type::k_int32 || type == bsoncxx::type::k_int64 || type == bsoncxx::type::k_double;
+	};
+	if (is_number(left.type()) && is_number(right.type())) {
+		if (left.type() != bsoncxx::type::k_double && right.type() != bsoncxx::type::k_double) {
+			auto l = left.type() == bsoncxx::type::k_int32 ? int64_t(left.get_int32().value) : left.get_int64().value;
+			auto r =
+			    right.type() == bsoncxx::type::k_int32 ? int64_t(right.get_int32().value) : right.get_int64().value;
+			result = l < r ? -1 : (l > r ? 1 : 0);
+			return true;
+		}
+		auto to_double = [](const bsoncxx::types::bson_value::view &value) {
+			switch (value.type()) {
+			case bsoncxx::type::k_int32:
+				return double(value.get_int32().value);
+			case bsoncxx::type::k_int64:
+				return double(value.get_int64().value);
+			default:
+				return value.get_double().value;
+			}
+		};
+		double l = to_double(left);
+		double r = to_double(right);
+		if (l != l || r != r) {
+			return false;
+		}
+		result = l < r ? -1 : (l > r ? 1 : 0);
+		return true;
+	}
+	if (left.type() != right.type()) {
+		return false;
+	}
+	switch (left.type()) {
+	case bsoncxx::type::k_string: {
+		auto compared = left.get_string().value.compare(right.get_string().value);
+		result = compared < 0 ? -1 : (compared > 0 ? 1 : 0);
+		return true;
+	}
+	case bsoncxx::type::k_date: {
+		auto l = left.get_date().to_int64();
+		auto r = right.get_date().to_int64();
+		result = l < r ? -1 : (l > r ? 1 : 0);
+		return true;
+	}
+	case bsoncxx::type::k_oid: {
+		auto compared = left.get_oid().value.compare(right.get_oid().value);
+		result = compared < 0 ? -1 : (compared > 0 ? 1 : 0);
+		return true;
+	}
+	case bsoncxx::type::k_bool:
+		result = int(left.get_bool().value) - int(right.get_bool().value);
+		return true;
+	default:
+		return false;
+	}
+}
+
+static bool ConditionMayMatch(const MongoFieldCondition &condition, const bsoncxx::types::bson_value::view &min,
+                              const bsoncxx::types::bson_value::view &max) {
+	if (condition.op == "$in") {
+		if (condition.value.type() != bsoncxx::type::k_array) {
+			return true;
+		}
+		for (auto &item : condition.value.get_array().value) {
+			if (ConditionMayMatch({"$eq", item.get_value()}, min, max)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	if (condition.op != "$eq" && condition.op != "$gt" && condition.op != "$gte" && condition.op != "$lt" &&
+	    condition.op != "$lte") {
+		return true;
+	}
+	int min_cmp;
+	int max_cmp;
+	if (min.type() == bsoncxx::type::k_null || max.type() == bsoncxx::type::k_null) {
+		// No document of the partition has a value, which only a null or unhandled constant matches
+		return !CompareValues(condition.value, condition.value, min_cmp);
+	}
+	if (!CompareValues(condition.value, min, min_cmp) || !CompareValues(condition.value, max, max_cmp)) {
+		return true;
+	}
+	if (condition.op == "$eq") {
+		return min_cmp >= 0 && max_cmp <= 0;
+	}
+	if (condition.op == "$gt") {
+		return max_cmp < 0;
+	}
+	if (condition.op == "$gte") {
+		return max_cmp <= 0;
+	}
+	if (condition.op == "$lt") {
+		return min_cmp > 0;
+	}
+	return min_cmp >= 0;
+}
+
+bool MongoPrunePartitions(const MongoPartitionSummary &summary, const bsoncxx::document::view &query_filter,
+                          bsoncxx::document::value &id_filter) {
+	id_filter = bsoncxx::builder::basic::document {}.extract();
+	if (summary.partitions.empty()) {
+		return true;
+	}
+	vector<vector<MongoFieldCondition>> conditions(summary.paths.size());
+	CollectConditions(query_filter, summary.paths, conditions);
+
+	vector<bool> may_match;
+	idx_t match_count = 0;
+	for (auto &partition : summary.partitions) {
+		bool partition_matches = true;
+		for (idx_t path_idx = 0; path_idx < summary.paths.size() && partition_matches; path_idx++) {
+			for (auto &condition : conditions[path_idx]) {
+				if (!ConditionMayMatch(condition, partition.min_values[path_idx].view(),
+				                       partition.max_values[path_idx].view())) {
+					partition_matches = false;
+					break;
+				}
+			}
+		}
+		may_match.push_back(partition_matches);
+		match_count += partition_matches ? 1 : 0;
+	}
+	if (match_count == 0) {
+		return false;
+	}
+	if (match_count == summary.partitions.size()) {
+		return true;
+	}
+
+	// One _id range per run of adjacent matching partitions. A partition reaches up to the first _id of the next one,
+	// and the first and last partitions are open-ended, so the ranges of all partitions cover every _id. The open ends
+	// are negated ranges, which unlike $lt and $gte also match _ids of other types.
+	bsoncxx::builder::basic::array ranges;
+	idx_t range_count = 0;
+	for (idx_t start = 0; start < may_match.size(); start++) {
+		if (!may_match[start]) {
+			continue;
+		}
+		idx_t end = start;
+		while (end + 1 < may_match.size() && may_match[end + 1]) {
+			end++;
+		}
+		bsoncxx::builder::basic::document range;
+		if (start == 0) {
+			auto upper = make_document(kvp("$gte", summary.partitions[end + 1].min_id.view()));
+			range.append(kvp("$not", upper.view()));
+		} else if (end + 1 == may_match.size()) {
+			auto lower = make_document(kvp("$lt", summary.partitions[start].min_id.view()));
+			range.append(kvp("$not", lower.view()));
+		} else {
+			range.append(kvp("$gte", summary.partitions[start].min_id.view()));
+			range.append(kvp("$lt", summary.partitions[end + 1].min_id.view()));
+		}
+		ranges.append(make_document(kvp("_id", range.extract())));
+		range_count++;
+		start = end;
+	}
+	auto range_array = ranges.extract();
+	if (range_count == 1) {
+		id_filter = bsoncxx::document::value(range_array.view()[0].get_document().value);
+	} else {
+		id_filter = make_document(kvp("$or", range_array.view()));
+	}
+	return true;
+}
+
+} // namespace duckdb
@@ -0,0 +1,144 @@
+#include "mongo_query_log.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/config.hpp"
+
+namespace duckdb {
+
+static constexpr const char *SLOW_QUERY_THRESHOLD_SETTING = "mongo_slow_query_threshold_ms";
+static constexpr const char *QUERY_LOG_SIZE_SETTING = "mongo_query_log_size";
+static constexpr int64_t DEFAULT_QUERY_LOG_SIZE = 1000;
+
+MongoQueryLog &MongoQueryLog::Get() {
+	static MongoQueryLog log;
+	return log;
+}
+
+void MongoQueryLog::Record(MongoQueryLogEntry entry, idx_t max_entries) {
+	lock_guard<mutex> guard(lock);
+	entries.push_back(std::move(entry));
+	while (entries.size() > max_entries) {
+		entries.pop_front();
+	}
+}
+
+vector<MongoQueryLogEntry> MongoQueryLog::GetEntries() {
+	lock_guard<mutex> guard(lock);
+	return vector<MongoQueryLogEntry>(entries.begin(), entries.end());
+}
+
+static double DurationToMs(MongoQueryStats::clock_t::duration duration) {
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+MongoQueryStats::~MongoQueryStats() {
+	if (threshold_ms < 0 || max_entries == 0) {
+		return;
+	}
+	entry.server_ms = DurationToMs(server_time);
+	entry.client_ms = DurationToMs(client_time);
+	if (entry.server_ms + entry.client_ms < double(threshold_ms)) {
+		return;
+	}
+	try {
+		MongoQueryLog::Get().Record(std::move(entry), max_entries);
+	} catch (...) {
+		// Logging must never turn a finished scan into a failure
+	}
+}
+
+static int64_t GetIntegerSetting(ClientContext &context, const char *name, int64_t default_value) {
+	Value value;
+	if (context.TryGetCurrentSetting(name, value) && !value.IsNull()) {
+		return value.GetValue<int64_t>();
+	}
+	return default_value;
+}
+
+unique_ptr<MongoQueryStats> MongoQueryStatsCreate(ClientContext &context, const std::string &database_name,
+                                                  const std::string &collection_name) {
+	auto threshold_ms = GetIntegerSetting(context, SLOW_QUERY_THRESHOLD_SETTING, -1);
+	auto log_size = GetIntegerSetting(context, QUERY_LOG_SIZE_SETTING, DEFAULT_QUERY_LOG_SIZE);
+	if (threshold_ms < 0 || log_size <= 0) {
+		return nullptr;
+	}
+	auto result = make_uniq<MongoQueryStats>();
+	result->threshold_ms = threshold_ms;
+	result->max_entries = NumericCast<idx_t>(log_size);
+	result->entry.start_time = Timestamp::GetCurrentTimestamp();
+	result->entry.database_name = database_name;
+	result->entry.collection_name = collection_name;
+	result->entry.query = context.GetCurrentQuery();
+	return result;
+}
+
+void RegisterMongoQueryLogSettings(DBConfig &config) {
+	config.AddExtensionOption(SLOW_QUERY_THRESHOLD_SETTING,
+	                          "Record MongoDB commands issued by mongo_scan that take at least this many milliseconds "
+	                          "in mongo_query_log() (-1 disables the log, 0 records every command)",
+	                          LogicalType::BIGINT, Value::BIGINT(-1));
+	config.AddExtensionOption(QUERY_LOG_SIZE_SETTING,
+	                          "Maximum number of entries kept by mongo_query_log() (oldest entries are evicted first)",
+	                          LogicalType::BIGINT, Value::BIGINT(DEFAULT_QUERY_LOG_SIZE));
+}
+
+struct QueryLogFunctionData : public TableFunctionData {
+	vector<MongoQueryLogEntry> entries;
+	idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> QueryLogBind(ClientContext &context, TableFunctionBindInput &input,
+                                             vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<QueryLogFunctionData>();
+	result->entries = MongoQueryLog::Get().GetEntries();
+
+	names.emplace_back("start_time");
+	return_types.push_back(LogicalType::TIMESTAMP);
+	names.emplace_back("database");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.emplace_back("collection");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.emplace_back("scan_method");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.emplace_back("command");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.emplace_back("projection");
+	return_types.push_back(LogicalType::VARCHAR);
+	names.emplace_back("server_ms");
+	return_types.push_back(LogicalType::DOUBLE);
+	names.emplace_back("client_ms");
+	return_types.push_back(LogicalType::DOUBLE);
+	names.emplace_back("documents");
+	return_types.push_back(LogicalType::BIGINT);
+	names.emplace_back("bytes");
+	return_types.push_back(LogicalType::BIGINT);
+	names.emplace_back("query");
+	return_types.push_back(LogicalType::VARCHAR);
+	return std::move(result);
+}
+
+static void QueryLogFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &data = data_p.bind_data->CastNoConst<QueryLogFunctionData>();
+	idx_t count = 0;
+	while (data.offset < data.entries.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &entry = data.entries[data.offset++];
+		output.SetValue(0, count, Value::TIMESTAMP(entry.start_time));
+		output.SetValue(1, count, Value(entry.database_name));
+		output.SetValue(2, count, Value(entry.collection_name));
+		output.SetValue(3, count, Value(entry.scan_method));
+		output.SetValue(4, count, entry.command.empty() ? Value() : Value(entry.command));
+		output.SetValue(5, count, entry.projection.empty() ? Value() : Value(entry.projection));
+		output.SetValue(6, count, Value::DOUBLE(entry.server_ms));
+		output.SetValue(7, count, Value::DOUBLE(entry.client_ms));
+		output.SetValue(8, count, Value::BIGINT(NumericCast<int64_t>(entry.documents)));
+		output.SetValue(9, count, Value::BIGINT(NumericCast<int64_t>(entry.bytes)));
+		output.SetValue(10, count, Value(entry.query));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+MongoQueryLogFunction::MongoQueryLogFunction() : TableFunction("mongo_query_log", {}, QueryLogFunction, QueryLogBind) {
+}
+
+} // namespace duckdb
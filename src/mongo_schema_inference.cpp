@@ -8,17 +8,25 @@
 #endif
 #endif
 #include "schema/mongo_schema_inference_internal.hpp"
+#include "mongo_bson_reader.hpp"
 
 #include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/storage/arena_allocator.hpp"
 
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/json.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
 #include <mongocxx/collection.hpp>
+#include <mongocxx/database.hpp>
 
 #include <mongocxx/pipeline.hpp>
 
 #include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
 #include <map>
 #include <sstream>
 #include <unordered_map>
@@ -225,13 +233,109 @@ LogicalType ResolveTypeConflict(const std::vector<LogicalType> &types) {
 	return LogicalType::VARCHAR;
 }
 
+static void RecordMapCandidateValue(MongoMapCandidate &candidate, const bsoncxx::document::element &element,
+                                    idx_t map_key_threshold) {
+	if (candidate.keys.size() < map_key_threshold) {
+		candidate.keys.emplace(element.key().data(), element.key().length());
+	}
+	switch (element.type()) {
+	case bsoncxx::type::k_null:
+	case bsoncxx::type::k_undefined:
+		return;
+	case bsoncxx::type::k_document:
+	case bsoncxx::type::k_array:
+		candidate.scalar_values = false;
+		return;
+	default:
+		break;
+	}
+	auto type = InferTypeFromBSON(element);
+	if (std::find(candidate.value_types.begin(), candidate.value_types.end(), type) == candidate.value_types.end()) {
+		candidate.value_types.push_back(type);
+	}
+}
+
+// Value type of a MAP column, or INVALID when the sampled values don't share a type
+static LogicalType ResolveMapValueType(const MongoMapCandidate &candidate) {
+	if (!candidate.scalar_values) {
+		return LogicalType::INVALID;
+	}
+	if (candidate.value_types.empty()) {
+		return LogicalType::VARCHAR;
+	}
+	if (candidate.value_types.size() == 1) {
+		return candidate.value_types[0];
+	}
+	// Mixed int/double values are still homogeneous numbers
+	for (const auto &type : candidate.value_types) {
+		if (type != LogicalType::BIGINT && type != LogicalType::DOUBLE) {
+			return LogicalType::INVALID;
+		}
+	}
+	return LogicalType::DOUBLE;
+}
+
+// Replaces the flattened columns of every dynamic-key sub-document with a single MAP (or JSON) column
+static void CollapseMapCandidates(const std::unordered_map<std::string, MongoMapCandidate> &map_candidates,
+                                  idx_t map_key_threshold,
+                                  std::unordered_map<std::string, std::vector<LogicalType>> &field_types,
+                                  std::unordered_map<std::string, std::string> &flattened_to_mongo_path) {
+	// Outermost paths first, so that candidates nested inside a collapsed sub-document are skipped
+	std::vector<std::string> collapsed_columns;
+	for (const auto &entry : map_candidates) {
+		if (entry.second.keys.size() >= map_key_threshold) {
+			collapsed_columns.push_back(entry.first);
+		}
+	}
+	std::sort(collapsed_columns.begin(), collapsed_columns.end(), [&](const std::string &a, const std::string &b) {
+		return map_candidates.at(a).mongo_path.size() < map_candidates.at(b).mongo_path.size();
+	});
+
+	std::vector<std::string> collapsed_prefixes;
+	for (const auto &column_name : collapsed_columns) {
+		const auto &candidate = map_candidates.at(column_name);
+		bool inside_collapsed = false;
+		for (const auto &prefix : collapsed_prefixes) {
+			if (StringUtil::StartsWith(candidate.mongo_path, prefix)) {
+				inside_collapsed = true;
+				break;
+			}
+		}
+		if (inside_collapsed) {
+			continue;
+		}
+
+		// Drop the per-key columns flattened from documents that had fewer keys than the threshold
+		auto child_name_prefix = column_name + "_";
+		auto child_path_prefix = candidate.mongo_path + ".";
+		for (auto it = field_types.begin(); it != field_types.end();) {
+			auto path_it = flattened_to_mongo_path.find(it->first);
+			if (StringUtil::StartsWith(it->first, child_name_prefix) && path_it != flattened_to_mongo_path.end() &&
+			    StringUtil::StartsWith(path_it->second, child_path_prefix)) {
+				flattened_to_mongo_path.erase(path_it);
+				it = field_types.erase(it);
+			} else {
+				++it;
+			}
+		}
+
+		auto value_type = ResolveMapValueType(candidate);
+		if (value_type.id() == LogicalTypeId::INVALID) {
+			field_types[column_name] = {LogicalType::VARCHAR};
+		} else {
+			field_types[column_name] = {LogicalType::MAP(LogicalType::VARCHAR, value_type)};
+		}
+		flattened_to_mongo_path[column_name] = candidate.mongo_path;
+		collapsed_prefixes.push_back(child_path_prefix);
+	}
+}
+
 void CollectFieldPaths(const bsoncxx::document::view &doc, const std::string &prefix, int depth,
                        std::unordered_map<std::string, std::vector<LogicalType>> &field_types,
                        std::unordered_map<std::string, std::string> &flattened_to_mongo_path,
-                       const std::string &mongo_prefix) {
-	const int MAX_DEPTH = 5;
-
-	if (depth > MAX_DEPTH) {
+                       const std::string &mongo_prefix, const MongoSchemaInferenceOptions &options,
+                       std::unordered_map<std::string, MongoMapCandidate> *map_candidates) {
+	if (depth > options.max_depth) {
 		// Store as JSON for deeply nested structures
 		if (!prefix.empty()) {
 			field_types[prefix].push_back(LogicalType::VARCHAR);
@@ -248,9 +352,36 @@ void CollectFieldPaths(const bsoncxx::document::view &doc, const std::string &pr
 
 		switch (element.type()) {
 		case bsoncxx::type::k_document: {
-			// Recursively process nested document to create flattened child columns.
 			auto nested_doc = element.get_document().value;
-			CollectFieldPaths(nested_doc, full_path, depth + 1, field_types, flattened_to_mongo_path, mongo_path);
+			if (map_candidates && options.map_key_threshold > 0) {
+				auto &candidate = (*map_candidates)[full_path];
+				candidate.mongo_path = mongo_path;
+				idx_t field_count = 0;
+				for (const auto &child : nested_doc) {
+					field_count++;
+					RecordMapCandidateValue(candidate, child, options.map_key_threshold);
+				}
+				if (field_count >= options.map_key_threshold) {
+					// Dynamic key set: InferSchemaFromDocuments turns it into a MAP or JSON column, never flatten it
+					break;
+				}
+			}
+			if (options.max_fields_per_level > 0) {
+				// Don't descend into sub-documents with unbounded key sets; keep them as one JSON column
+				idx_t field_count = 0;
+				auto it = nested_doc.begin();
+				while (it != nested_doc.end() && field_count <= options.max_fields_per_level) {
+					field_count++;
+					++it;
+				}
+				if (field_count > options.max_fields_per_level) {
+					field_types[full_path].push_back(LogicalType::VARCHAR);
+					break;
+				}
+			}
+			// Recursively process nested document to create flattened child columns.
+			CollectFieldPaths(nested_doc, full_path, depth + 1, field_types, flattened_to_mongo_path, mongo_path,
+			                  options, map_candidates);
 			// Also expose the parent document itself as a VARCHAR column containing JSON.
 			// This allows users to query the whole sub-document directly.
 			field_types[full_path].push_back(LogicalType::VARCHAR);
@@ -315,20 +446,28 @@ static LogicalType ParseLogicalTypeFromString(const std::string &type_str, Clien
 #endif
 }
 
-bool ParseSchemaFromAtlasDocument(ClientContext &context, mongocxx::collection &collection,
-                                  std::vector<string> &column_names, std::vector<LogicalType> &column_types,
-                                  std::unordered_map<string, string> &column_name_to_mongo_path) {
+bsoncxx::stdx::optional<bsoncxx::document::value> FetchAtlasSchemaDocument(mongocxx::collection &collection) {
 	// Check for __schema document in the collection (for Atlas SQL users)
 	bsoncxx::builder::basic::document filter_builder;
 	filter_builder.append(bsoncxx::builder::basic::kvp("_id", "__schema"));
 	auto filter = filter_builder.extract();
+	return collection.find_one(filter.view());
+}
 
-	auto schema_doc = collection.find_one(filter.view());
+bool ParseSchemaFromAtlasDocument(ClientContext &context, mongocxx::collection &collection,
+                                  std::vector<string> &column_names, std::vector<LogicalType> &column_types,
+                                  std::unordered_map<string, string> &column_name_to_mongo_path) {
+	auto schema_doc = FetchAtlasSchemaDocument(collection);
 	if (!schema_doc) {
 		return false;
 	}
+	return ParseSchemaFromAtlasDocument(context, schema_doc->view(), column_names, column_types,
+	                                    column_name_to_mongo_path);
+}
 
-	auto doc_view = schema_doc->view();
+bool ParseSchemaFromAtlasDocument(ClientContext &context, const bsoncxx::document::view &doc_view,
+                                  std::vector<string> &column_names, std::vector<LogicalType> &column_types,
+                                  std::unordered_map<string, string> &column_name_to_mongo_path) {
 	bsoncxx::document::view schema_doc_view;
 
 	// Check if schema is in a nested "schema" field, or directly in the document
@@ -400,6 +539,223 @@ bool ParseSchemaFromAtlasDocument(ClientContext &context, mongocxx::collection &
 	return !column_names.empty();
 }
 
+namespace {
+
+// Non-null type names of a $jsonSchema node ("bsonType" takes precedence over the JSON Schema "type")
+std::vector<std::string> GetJsonSchemaTypeNames(const bsoncxx::document::view &node) {
+	std::vector<std::string> type_names;
+	auto add_type_name = [&](const bsoncxx::types::bson_value::view &value) {
+		if (value.type() != bsoncxx::type::k_string) {
+			return;
+		}
+		std::string type_name(value.get_string().value.data(), value.get_string().value.length());
+		if (type_name != "null") {
+			type_names.push_back(std::move(type_name));
+		}
+	};
+	auto type_elem = node["bsonType"] ? node["bsonType"] : node["type"];
+	if (!type_elem) {
+		if (node["properties"]) {
+			type_names.push_back("object");
+		}
+		return type_names;
+	}
+	if (type_elem.type() == bsoncxx::type::k_array) {
+		for (const auto &entry : type_elem.get_array().value) {
+			add_type_name(entry.get_value());
+		}
+	} else {
+		add_type_name(type_elem.get_value());
+	}
+	return type_names;
+}
+
+// Scalar DuckDB type for a bsonType/type name; INVALID for "object" and "array"
+LogicalType JsonSchemaScalarType(const std::string &type_name) {
+	if (type_name == "int" || type_name == "long" || type_name == "integer") {
+		return LogicalType::BIGINT;
+	}
+	if (type_name == "double" || type_name == "decimal" || type_name == "number") {
+		return LogicalType::DOUBLE;
+	}
+	if (type_name == "bool" || type_name == "boolean") {
+		return LogicalType::BOOLEAN;
+	}
+	if (type_name == "date") {
+		return LogicalType::TIMESTAMP;
+	}
+	if (type_name == "object" || type_name == "array") {
+		return LogicalType::INVALID;
+	}
+	// string, objectId and the remaining BSON types are read as their string representation
+	return LogicalType::VARCHAR;
+}
+
+// Type of a scalar-only position (STRUCT fields, MAP values): unions of numeric types widen, anything else
+// that isn't a single scalar type is read as JSON VARCHAR
+LogicalType JsonSchemaScalarNodeType(const bsoncxx::document::view &node) {
+	auto type_names = GetJsonSchemaTypeNames(node);
+	if (type_names.empty()) {
+		return LogicalType::VARCHAR;
+	}
+	LogicalType result = JsonSchemaScalarType(type_names[0]);
+	for (idx_t i = 1; i < type_names.size(); i++) {
+		auto type = JsonSchemaScalarType(type_names[i]);
+		if (type == result) {
+			continue;
+		}
+		bool numeric = (type == LogicalType::BIGINT || type == LogicalType::DOUBLE) &&
+		               (result == LogicalType::BIGINT || result == LogicalType::DOUBLE);
+		result = numeric ? LogicalType::DOUBLE : LogicalType::VARCHAR;
+	}
+	return result.id() == LogicalTypeId::INVALID ? LogicalType::VARCHAR : result;
+}
+
+bsoncxx::document::view GetJsonSchemaSubdocument(const bsoncxx::document::view &node, const char *key) {
+	auto elem = node[key];
+	if (elem && elem.type() == bsoncxx::type::k_document) {
+		return elem.get_document().value;
+	}
+	return bsoncxx::document::view();
+}
+
+// Element type of a LIST column: scalars, STRUCTs of scalars, or nested lists
+LogicalType JsonSchemaListChildType(const bsoncxx::document::view &items) {
+	auto type_names = GetJsonSchemaTypeNames(items);
+	if (type_names.size() == 1 && type_names[0] == "object") {
+		auto properties = GetJsonSchemaSubdocument(items, "properties");
+		if (properties.empty()) {
+			return LogicalType::VARCHAR;
+		}
+		child_list_t<LogicalType> children;
+		for (const auto &property : properties) {
+			std::string name(property.key().data(), property.key().length());
+			auto field_type = property.type() == bsoncxx::type::k_document
+			                      ? JsonSchemaScalarNodeType(property.get_document().value)
+			                      : LogicalType::VARCHAR;
+			MongoChildListAppend(children, name, field_type);
+		}
+		return LogicalType::STRUCT(children);
+	}
+	if (type_names.size() == 1 && type_names[0] == "array") {
+		auto nested_items = GetJsonSchemaSubdocument(items, "items");
+		if (nested_items.empty()) {
+			return LogicalType::VARCHAR;
+		}
+		return LogicalType::LIST(JsonSchemaListChildType(nested_items));
+	}
+	return JsonSchemaScalarNodeType(items);
+}
+
+// Mirrors CollectFieldPaths: sub-documents with known properties are flattened into `parent_child` columns next to
+// the parent JSON column, up to max_depth levels
+void CollectJsonSchemaProperties(const bsoncxx::document::view &properties, const std::string &prefix,
+                                 const std::string &mongo_prefix, int depth, int max_depth,
+                                 std::vector<string> &column_names, std::vector<LogicalType> &column_types,
+                                 std::unordered_map<string, string> &column_name_to_mongo_path,
+                                 std::unordered_set<std::string> &objectid_columns) {
+	for (const auto &property : properties) {
+		std::string field_name(property.key().data(), property.key().length());
+		std::string full_path = prefix.empty() ? field_name : prefix + "_" + field_name;
+		std::string mongo_path = mongo_prefix.empty() ? field_name : mongo_prefix + "." + field_name;
+
+		LogicalType field_type = LogicalType::VARCHAR;
+		bsoncxx::document::view nested_properties;
+		if (property.type() == bsoncxx::type::k_document) {
+			auto node = property.get_document().value;
+			auto type_names = GetJsonSchemaTypeNames(node);
+			if (type_names.size() == 1 && type_names[0] == "object") {
+				nested_properties = GetJsonSchemaSubdocument(node, "properties");
+				auto additional = GetJsonSchemaSubdocument(node, "additionalProperties");
+				if (nested_properties.empty() && !additional.empty()) {
+					// Only dynamic keys are described: the same shape MAP inference produces
+					field_type = LogicalType::MAP(LogicalType::VARCHAR, JsonSchemaScalarNodeType(additional));
+				}
+			} else if (type_names.size() == 1 && type_names[0] == "array") {
+				auto items = GetJsonSchemaSubdocument(node, "items");
+				if (!items.empty()) {
+					field_type = LogicalType::LIST(JsonSchemaListChildType(items));
+				}
+			} else {
+				field_type = JsonSchemaScalarNodeType(node);
+				if (type_names.size() == 1 && type_names[0] == "objectId") {
+					objectid_columns.insert(mongo_path);
+				}
+			}
+		}
+
+		column_names.push_back(full_path);
+		column_types.push_back(field_type);
+		column_name_to_mongo_path[full_path] = mongo_path;
+		if (!nested_properties.empty() && depth + 1 <= max_depth) {
+			CollectJsonSchemaProperties(nested_properties, full_path, mongo_path, depth + 1, max_depth, column_names,
+			                            column_types, column_name_to_mongo_path, objectid_columns);
+		}
+	}
+}
+
+} // namespace
+
+bsoncxx::stdx::optional<bsoncxx::document::value> FetchCollectionInfo(mongocxx::database &database,
+                                                                       const std::string &collection_name) {
+	bsoncxx::builder::basic::document filter_builder;
+	filter_builder.append(bsoncxx::builder::basic::kvp("name", collection_name));
+	try {
+		auto cursor = database.list_collections(filter_builder.extract());
+		for (const auto &info : cursor) {
+			return bsoncxx::document::value(info);
+		}
+	} catch (...) {
+		// Missing listCollections privilege: fall back to the other schema sources
+	}
+	return bsoncxx::stdx::nullopt;
+}
+
+bool ParseSchemaFromJsonSchemaValidator(mongocxx::database &database, const std::string &collection_name,
+                                        int max_depth, std::vector<string> &column_names,
+                                        std::vector<LogicalType> &column_types,
+                                        std::unordered_map<string, string> &column_name_to_mongo_path,
+                                        bool &enforced) {
+	auto collection_info = FetchCollectionInfo(database, collection_name);
+	if (!collection_info) {
+		return false;
+	}
+	std::unordered_set<std::string> objectid_columns;
+	return ParseSchemaFromJsonSchemaValidator(collection_info->view(), max_depth, column_names, column_types,
+	                                          column_name_to_mongo_path, enforced, objectid_columns);
+}
+
+bool ParseSchemaFromJsonSchemaValidator(const bsoncxx::document::view &collection_info, int max_depth,
+                                        std::vector<string> &column_names, std::vector<LogicalType> &column_types,
+                                        std::unordered_map<string, string> &column_name_to_mongo_path,
+                                        bool &enforced, std::unordered_set<std::string> &objectid_columns) {
+	auto options = GetJsonSchemaSubdocument(collection_info, "options");
+	auto validator = GetJsonSchemaSubdocument(options, "validator");
+	auto json_schema = GetJsonSchemaSubdocument(validator, "$jsonSchema");
+	auto properties = GetJsonSchemaSubdocument(json_schema, "properties");
+	if (properties.empty()) {
+		return false;
+	}
+
+	CollectJsonSchemaProperties(properties, "", "", 0, max_depth, column_names, column_types,
+	                            column_name_to_mongo_path, objectid_columns);
+
+	// _id is not always part of the validator, but every document has one
+	if (column_name_to_mongo_path.find("_id") == column_name_to_mongo_path.end()) {
+		column_names.insert(column_names.begin(), "_id");
+		column_types.insert(column_types.begin(), LogicalType::VARCHAR);
+		column_name_to_mongo_path["_id"] = "_id";
+	}
+
+	// Documents can only violate the schema when the server doesn't reject them
+	auto level = options["validationLevel"];
+	auto action = options["validationAction"];
+	bool strict = !level || (level.type() == bsoncxx::type::k_string && level.get_string().value == "strict");
+	bool error = !action || (action.type() == bsoncxx::type::k_string && action.get_string().value == "error");
+	enforced = strict && error;
+	return true;
+}
+
 void ParseSchemaFromColumnsParameter(ClientContext &context, const Value &columns_value,
                                      std::vector<string> &column_names, std::vector<LogicalType> &column_types,
                                      std::unordered_map<string, string> &column_name_to_mongo_path) {
@@ -489,43 +845,94 @@ void ParseSchemaFromColumnsParameter(ClientContext &context, const Value &column
 	}
 }
 
-void InferSchemaFromDocuments(mongocxx::collection &collection, int64_t sample_size, std::vector<string> &column_names,
-                              std::vector<LogicalType> &column_types,
-                              std::unordered_map<string, string> &column_name_to_mongo_path) {
-	std::unordered_map<std::string, std::vector<LogicalType>> field_types;
+std::vector<bsoncxx::document::value> SampleDocuments(mongocxx::collection &collection, int64_t sample_size,
+                                                      const MongoSchemaInferenceOptions &options) {
+	std::vector<bsoncxx::document::value> sample;
+
+	// Only fetch the requested subtrees so huge documents are neither transferred nor walked in full
+	bsoncxx::document::value include_projection = bsoncxx::builder::basic::document {}.extract();
+	if (!options.include_paths.empty()) {
+		vector<column_t> path_ids;
+		for (idx_t i = 0; i < options.include_paths.size(); i++) {
+			path_ids.push_back(i);
+		}
+		include_projection = BuildMongoProjection(path_ids, options.include_paths, {});
+	}
+	bool has_include_projection = !include_projection.view().empty();
 
 	// Use $sample aggregation for random sampling to better capture heterogeneous schemas.
 	// Collections with optional fields (e.g., completion timestamps only on finished records)
 	// need random sampling to discover all fields, since find().limit() only returns the
 	// first N documents in natural order.
-	int64_t count = 0;
 	try {
 		mongocxx::pipeline pipe;
 		pipe.sample(static_cast<int32_t>(std::min(sample_size, static_cast<int64_t>(INT32_MAX))));
+		if (has_include_projection) {
+			pipe.project(include_projection.view());
+		}
 		auto cursor = collection.aggregate(pipe);
 		for (const auto &doc : cursor) {
-			CollectFieldPaths(doc, "", 0, field_types, column_name_to_mongo_path, "");
-			count++;
-			if (count >= sample_size) {
+			sample.emplace_back(doc);
+			if (static_cast<int64_t>(sample.size()) >= sample_size) {
 				break;
 			}
 		}
 	} catch (...) {
 		// Fall back to find().limit() if $sample is unavailable (e.g., views, older MongoDB).
-		count = 0;
-		field_types.clear();
-		column_name_to_mongo_path.clear();
+		sample.clear();
 		mongocxx::options::find opts;
 		opts.limit(sample_size);
+		if (has_include_projection) {
+			opts.projection(include_projection.view());
+		}
 		auto cursor = collection.find({}, opts);
 		for (const auto &doc : cursor) {
-			CollectFieldPaths(doc, "", 0, field_types, column_name_to_mongo_path, "");
-			count++;
-			if (count >= sample_size) {
+			sample.emplace_back(doc);
+			if (static_cast<int64_t>(sample.size()) >= sample_size) {
 				break;
 			}
 		}
 	}
+	return sample;
+}
+
+void InferSchemaFromDocuments(mongocxx::collection &collection, int64_t sample_size, std::vector<string> &column_names,
+                              std::vector<LogicalType> &column_types,
+                              std::unordered_map<string, string> &column_name_to_mongo_path,
+                              const MongoSchemaInferenceOptions &options) {
+	InferSchemaFromSample(SampleDocuments(collection, sample_size, options), column_names, column_types,
+	                      column_name_to_mongo_path, options);
+}
+
+// Whether the sampled values of a column disagree on a scalar type (nested types have their own merging)
+static bool IsScalarTypeConflict(const std::vector<LogicalType> &types) {
+	for (const auto &type : types) {
+		if (type.IsNested()) {
+			return false;
+		}
+	}
+	for (idx_t i = 1; i < types.size(); i++) {
+		if (types[i] != types[0]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void InferSchemaFromSample(const std::vector<bsoncxx::document::value> &sample, std::vector<string> &column_names,
+                           std::vector<LogicalType> &column_types,
+                           std::unordered_map<string, string> &column_name_to_mongo_path,
+                           const MongoSchemaInferenceOptions &options,
+                           std::unordered_set<std::string> *conflicted_columns) {
+	std::unordered_map<std::string, std::vector<LogicalType>> field_types;
+	std::unordered_map<std::string, MongoMapCandidate> map_candidates;
+	for (const auto &doc : sample) {
+		CollectFieldPaths(doc.view(), "", 0, field_types, column_name_to_mongo_path, "", options, &map_candidates);
+	}
+
+	if (options.map_key_threshold > 0) {
+		CollapseMapCandidates(map_candidates, options.map_key_threshold, field_types, column_name_to_mongo_path);
+	}
 
 	// Always include _id column (present in all MongoDB documents)
 	// If collection is empty, we still need at least one column
@@ -565,12 +972,18 @@ void InferSchemaFromDocuments(mongocxx::collection &collection, int64_t sample_s
 				merged.push_back(t);
 			}
 			column_types[existing_idx] = ResolveTypeConflict(merged);
+			if (conflicted_columns && IsScalarTypeConflict(merged)) {
+				conflicted_columns->insert(column_names[existing_idx]);
+			}
 			continue;
 		}
 		lower_name_to_idx[lower_name] = column_names.size();
 		column_names.push_back(pair.first);
 		LogicalType resolved_type = ResolveTypeConflict(pair.second);
 		column_types.push_back(resolved_type);
+		if (conflicted_columns && IsScalarTypeConflict(pair.second)) {
+			conflicted_columns->insert(pair.first);
+		}
 	}
 
 	// Ensure we have at least one column (should always have _id, but double-check)
@@ -607,609 +1020,928 @@ void DetectObjectIdColumns(mongocxx::collection &collection, std::unordered_set<
 	}
 }
 
-// Validation-only function that checks schema compatibility without writing to output
-// Used for COUNT(*) queries where we need to validate but not materialize data
-bool ValidateDocumentSchema(const bsoncxx::document::view &doc, const std::vector<string> &column_names,
-                            const std::vector<LogicalType> &column_types,
-                            const std::unordered_map<string, string> &column_name_to_mongo_path,
-                            SchemaMode schema_mode) {
-	for (idx_t col_idx = 0; col_idx < column_names.size(); col_idx++) {
-		const auto &column_name = column_names[col_idx];
-		const auto &column_type = column_types[col_idx];
+void CollectObjectIdColumns(const std::vector<bsoncxx::document::value> &sample,
+                            std::unordered_set<std::string> &objectid_columns) {
+	for (const auto &doc : sample) {
+		CollectObjectIdFieldsRecursive(doc.view(), "", objectid_columns);
+	}
+}
 
-		// Skip complex types (LIST, STRUCT) - they have their own conversion logic
-		if (column_type.id() == LogicalTypeId::LIST || column_type.id() == LogicalTypeId::STRUCT) {
-			continue;
+std::vector<MongoColumnPlan> BuildColumnPlans(const std::vector<string> &column_names,
+                                              const std::vector<LogicalType> &column_types,
+                                              const std::unordered_map<string, string> &column_name_to_mongo_path) {
+	auto split = [](const std::string &str, char delimiter) {
+		std::vector<std::string> segments;
+		std::istringstream iss(str);
+		std::string segment;
+		while (std::getline(iss, segment, delimiter)) {
+			segments.push_back(segment);
 		}
+		return segments;
+	};
 
-		// Get the MongoDB path for this column
-		std::string mongo_field_name = column_name;
-		auto path_it = column_name_to_mongo_path.find(column_name);
-		if (path_it != column_name_to_mongo_path.end()) {
-			mongo_field_name = path_it->second;
+	std::vector<MongoColumnPlan> plans;
+	plans.reserve(column_names.size());
+	auto raw_paths = make_shared_ptr<MongoPathTrie>();
+	for (idx_t col_idx = 0; col_idx < column_names.size(); col_idx++) {
+		MongoColumnPlan plan;
+		plan.column_name = column_names[col_idx];
+		plan.column_type = column_types[col_idx];
+		auto path_it = column_name_to_mongo_path.find(plan.column_name);
+		plan.has_mongo_path = path_it != column_name_to_mongo_path.end();
+		plan.mongo_path = plan.has_mongo_path ? path_it->second : plan.column_name;
+		plan.nested_path = plan.mongo_path.find('.') != std::string::npos;
+		plan.path_segments = split(plan.mongo_path, '.');
+		plan.underscore_segments = split(plan.column_name, '_');
+		switch (plan.column_type.id()) {
+		case LogicalTypeId::BIGINT:
+		case LogicalTypeId::HUGEINT:
+		case LogicalTypeId::DOUBLE:
+		case LogicalTypeId::BOOLEAN:
+		case LogicalTypeId::DATE:
+		case LogicalTypeId::TIMESTAMP:
+		case LogicalTypeId::VARCHAR:
+			plan.raw_scalar = !plan.path_segments.empty();
+			break;
+		default:
+			break;
 		}
-
-		// Find the element
-		bsoncxx::document::element element;
-		if (mongo_field_name.find('.') != std::string::npos) {
-			// Nested path - navigate through
-			std::vector<std::string> segments;
-			std::istringstream iss(mongo_field_name);
-			std::string segment;
-			while (std::getline(iss, segment, '.')) {
-				segments.push_back(segment);
-			}
-			bsoncxx::document::view current = doc;
-			for (size_t i = 0; i < segments.size(); i++) {
-				element = current[segments[i]];
-				if (!element) {
-					break;
-				}
-				if (i < segments.size() - 1 && element.type() == bsoncxx::type::k_document) {
-					current = element.get_document().value;
-				}
-			}
-		} else {
-			element = doc[mongo_field_name];
+		if (plan.raw_scalar) {
+			raw_paths->Add(plan.path_segments, NumericCast<uint32_t>(col_idx));
 		}
+		plans.push_back(std::move(plan));
+	}
+	raw_paths->Build();
+	for (auto &plan : plans) {
+		plan.raw_paths = raw_paths;
+	}
+	return plans;
+}
 
-		// Missing field is OK (will be NULL)
-		if (!element || element.type() == bsoncxx::type::k_null || element.type() == bsoncxx::type::k_undefined) {
-			continue;
-		}
+namespace {
 
-		// Check type compatibility for scalar types
-		if (!IsBSONTypeCompatible(element.type(), column_type.id())) {
-			if (schema_mode == SchemaMode::FAILFAST) {
-				std::string doc_id = "<unknown>";
-				auto id_elem = doc["_id"];
-				if (id_elem) {
-					if (id_elem.type() == bsoncxx::type::k_oid) {
-						doc_id = id_elem.get_oid().value.to_string();
-					} else if (id_elem.type() == bsoncxx::type::k_string) {
-						doc_id = std::string(id_elem.get_string().value);
-					}
-				}
-				throw InvalidInputException(
-				    "Schema violation in document _id='%s': Field '%s' expected type %s but found %s.\n"
-				    "Hint: Use schema_mode='permissive' to replace with NULL, or 'dropmalformed' to skip bad rows.",
-				    doc_id, column_name, column_type.ToString(), GetBSONTypeName(element.type()));
-			}
-			// DROPMALFORMED: signal that row should be skipped
-			return false;
+// Follows path segments through nested documents; every intermediate value must be a document
+bsoncxx::document::element LookupPath(const bsoncxx::document::view &doc, const std::vector<std::string> &segments) {
+	if (segments.empty()) {
+		return bsoncxx::document::element {};
+	}
+	bsoncxx::document::view current = doc;
+	for (idx_t i = 0; i + 1 < segments.size(); i++) {
+		auto element = current[segments[i]];
+		if (!element || element.type() != bsoncxx::type::k_document) {
+			return bsoncxx::document::element {};
 		}
+		current = element.get_document().value;
 	}
-	return true;
+	return current[segments.back()];
 }
 
-bool FlattenDocument(const bsoncxx::document::view &doc, const std::vector<string> &column_names,
-                     const std::vector<LogicalType> &column_types, DataChunk &output, idx_t row_idx,
-                     const std::unordered_map<string, string> &column_name_to_mongo_path, SchemaMode schema_mode,
-                     bool has_explicit_schema) {
-	// Track if we've seen any schema violations in this row (for DROPMALFORMED)
-	bool row_has_violation = false;
-
-	// Helper to handle schema violation based on mode
-	auto handleSchemaViolation = [&](const std::string &field_name, const std::string &expected_type,
-	                                 bsoncxx::type actual_bson_type, idx_t col_idx) -> bool {
-		// Only enforce if explicit schema was provided
-		if (!has_explicit_schema) {
-			return true; // Continue processing
-		}
-
-		std::string actual_type = GetBSONTypeName(actual_bson_type);
-
-		switch (schema_mode) {
-		case SchemaMode::FAILFAST: {
-			// Try to get document _id for error context
-			std::string doc_id = "<unknown>";
-			auto id_elem = doc["_id"];
-			if (id_elem) {
-				if (id_elem.type() == bsoncxx::type::k_oid) {
-					doc_id = id_elem.get_oid().value.to_string();
-				} else if (id_elem.type() == bsoncxx::type::k_string) {
-					doc_id = std::string(id_elem.get_string().value);
-				}
-			}
-			throw InvalidInputException(
-			    "Schema violation in document _id='%s': Field '%s' expected type %s but found %s.\n"
-			    "Hint: Use schema_mode='permissive' to replace with NULL, or 'dropmalformed' to skip bad rows.",
-			    doc_id, field_name, expected_type, actual_type);
-		}
-		case SchemaMode::DROPMALFORMED:
-			row_has_violation = true;
-			return false; // Stop processing this row
-		case SchemaMode::PERMISSIVE:
-		default:
-			// Set to NULL and continue
-			FlatVector::SetNull(output.data[col_idx], row_idx, true);
-			return true; // Continue processing other columns
+// Underscore-split fallback for arrays: returns the first array found while descending
+bsoncxx::array::view LookupArrayByUnderscorePath(const bsoncxx::document::view &doc,
+                                                 const std::vector<std::string> &segments) {
+	bsoncxx::document::view current = doc;
+	for (const auto &segment : segments) {
+		auto element = current[segment];
+		if (!element) {
+			return bsoncxx::array::view {};
 		}
-	};
-	// Helper to get element from document by MongoDB path (uses dot notation)
-	auto getElementByMongoPath = [&](const std::string &mongo_path) -> bsoncxx::document::element {
-		std::vector<std::string> segments;
-		std::istringstream iss(mongo_path);
-		std::string segment;
-
-		// Split by dots
-		while (std::getline(iss, segment, '.')) {
-			segments.push_back(segment);
+		if (element.type() == bsoncxx::type::k_document) {
+			current = element.get_document().value;
+		} else if (element.type() == bsoncxx::type::k_array) {
+			return element.get_array().value;
+		} else {
+			return bsoncxx::array::view {};
 		}
+	}
+	return bsoncxx::array::view {};
+}
 
-		if (segments.empty()) {
-			return bsoncxx::document::element {};
+std::string GetDocumentIdForError(const bsoncxx::document::view &doc) {
+	std::string doc_id = "<unknown>";
+	auto id_elem = doc["_id"];
+	if (id_elem) {
+		if (id_elem.type() == bsoncxx::type::k_oid) {
+			doc_id = id_elem.get_oid().value.to_string();
+		} else if (id_elem.type() == bsoncxx::type::k_string) {
+			doc_id = std::string(id_elem.get_string().value);
 		}
+	}
+	return doc_id;
+}
 
-		bsoncxx::document::view current = doc;
-		bsoncxx::document::element result;
+// Copies a string into the output vector's string heap (no intermediate std::string)
+void WriteString(Vector &vec, idx_t row_idx, const char *data, idx_t len) {
+	MongoFlatVectorGetDataMutable<string_t>(vec)[row_idx] = StringVector::AddString(vec, data, len);
+}
 
-		// Navigate through segments
-		for (size_t i = 0; i < segments.size(); i++) {
-			const std::string &seg = segments[i];
-			auto element = current[seg];
-			if (!element) {
-				return bsoncxx::document::element {};
-			}
-			result = element;
+void WriteString(Vector &vec, idx_t row_idx, bsoncxx::stdx::string_view str) {
+	WriteString(vec, row_idx, str.data(), str.length());
+}
 
-			// If this is not the last segment, it must be a document
-			if (i < segments.size() - 1) {
-				if (result.type() != bsoncxx::type::k_document) {
-					// Path is invalid - non-document in the middle
-					return bsoncxx::document::element {};
-				}
-				current = result.get_document().value;
-			} else {
-				// Last segment - return the element (even if null)
-				return result;
-			}
-		}
+template <class T>
+void WriteIntegerString(Vector &vec, idx_t row_idx, T value) {
+	char buffer[32];
+	auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+	WriteString(vec, row_idx, buffer, idx_t(result.ptr - buffer));
+}
 
-		// Should never reach here, but return result if we do
-		return result;
-	};
+// Formats like std::to_string(double) ("%f") without a heap allocation for typical magnitudes
+void WriteDoubleString(Vector &vec, idx_t row_idx, double value) {
+	char buffer[64];
+	auto len = snprintf(buffer, sizeof(buffer), "%f", value);
+	if (len < 0 || len >= int(sizeof(buffer))) {
+		auto str = std::to_string(value);
+		WriteString(vec, row_idx, str.data(), str.length());
+		return;
+	}
+	WriteString(vec, row_idx, buffer, idx_t(len));
+}
 
-	// Helper to get element from document by path (handles nested fields with _ separator)
-	// This is a fallback for when MongoDB path is not available
-	auto getElementByPath = [&](const std::string &path) -> bsoncxx::document::element {
-		std::vector<std::string> segments;
-		std::istringstream iss(path);
-		std::string segment;
+void WriteObjectIdString(Vector &vec, idx_t row_idx, const uint8_t *bytes) {
+	static constexpr const char *HEX_DIGITS = "0123456789abcdef";
+	char buffer[24];
+	for (idx_t i = 0; i < 12; i++) {
+		buffer[2 * i] = HEX_DIGITS[bytes[i] >> 4];
+		buffer[2 * i + 1] = HEX_DIGITS[bytes[i] & 0x0F];
+	}
+	WriteString(vec, row_idx, buffer, 24);
+}
 
-		// First, collect all segments
-		while (std::getline(iss, segment, '_')) {
-			segments.push_back(segment);
-		}
+void WriteObjectIdString(Vector &vec, idx_t row_idx, const bsoncxx::oid &oid) {
+	WriteObjectIdString(vec, row_idx, reinterpret_cast<const uint8_t *>(oid.bytes()));
+}
 
-		if (segments.empty()) {
-			return bsoncxx::document::element {};
-		}
+// Normalized JSON goes through the per-chunk scratch arena instead of a second std::string
+void WriteJsonString(Vector &vec, idx_t row_idx, const std::string &json, ArenaAllocator *scratch) {
+	if (!scratch) {
+		auto normalized = NormalizeJson(json);
+		WriteString(vec, row_idx, normalized.data(), normalized.length());
+		return;
+	}
+	auto buffer = char_ptr_cast(scratch->Allocate(MaxValue<idx_t>(json.length(), 1)));
+	auto len = NormalizeJson(json, buffer);
+	WriteString(vec, row_idx, buffer, len);
+}
 
-		bsoncxx::document::view current = doc;
-		bsoncxx::document::element result;
+// Converts any BSON value to its VARCHAR representation (top-level column semantics)
+void WriteVarchar(const bsoncxx::document::element &element, Vector &vec, idx_t row_idx, ArenaAllocator *scratch) {
+	switch (element.type()) {
+	case bsoncxx::type::k_string:
+		WriteString(vec, row_idx, element.get_string().value);
+		break;
+	case bsoncxx::type::k_oid:
+		WriteObjectIdString(vec, row_idx, element.get_oid().value);
+		break;
+	case bsoncxx::type::k_document:
+		WriteJsonString(vec, row_idx, bsoncxx::to_json(element.get_document().value), scratch);
+		break;
+	case bsoncxx::type::k_array:
+		WriteJsonString(vec, row_idx, bsoncxx::to_json(element.get_array().value), scratch);
+		break;
+	case bsoncxx::type::k_int32:
+		WriteIntegerString(vec, row_idx, element.get_int32().value);
+		break;
+	case bsoncxx::type::k_int64:
+		WriteIntegerString(vec, row_idx, element.get_int64().value);
+		break;
+	case bsoncxx::type::k_double:
+		WriteDoubleString(vec, row_idx, element.get_double().value);
+		break;
+	case bsoncxx::type::k_bool:
+		WriteString(vec, row_idx, element.get_bool().value ? "true" : "false");
+		break;
+	case bsoncxx::type::k_date:
+		WriteIntegerString(vec, row_idx, element.get_date().to_int64());
+		break;
+	case bsoncxx::type::k_null:
+		WriteString(vec, row_idx, "null");
+		break;
+	case bsoncxx::type::k_binary:
+		WriteString(vec, row_idx, "<binary data>");
+		break;
+	case bsoncxx::type::k_undefined:
+		WriteString(vec, row_idx, "undefined");
+		break;
+	case bsoncxx::type::k_regex: {
+		auto regex = element.get_regex();
+		idx_t len = regex.regex.length() + regex.options.length() + 2;
+		auto buffer = scratch ? char_ptr_cast(scratch->Allocate(len)) : nullptr;
+		std::string fallback;
+		if (!buffer) {
+			fallback.resize(len);
+			buffer = &fallback[0];
+		}
+		buffer[0] = '/';
+		memcpy(buffer + 1, regex.regex.data(), regex.regex.length());
+		buffer[1 + regex.regex.length()] = '/';
+		memcpy(buffer + 2 + regex.regex.length(), regex.options.data(), regex.options.length());
+		WriteString(vec, row_idx, buffer, len);
+		break;
+	}
+	case bsoncxx::type::k_dbpointer:
+		WriteString(vec, row_idx, "<dbpointer>");
+		break;
+	case bsoncxx::type::k_code:
+		WriteString(vec, row_idx, element.get_code().code);
+		break;
+	case bsoncxx::type::k_codewscope:
+		WriteString(vec, row_idx, element.get_codewscope().code);
+		break;
+	case bsoncxx::type::k_symbol:
+		WriteString(vec, row_idx, element.get_symbol().symbol);
+		break;
+	case bsoncxx::type::k_timestamp: {
+		auto ts = element.get_timestamp();
+		char buffer[32];
+		auto len = snprintf(buffer, sizeof(buffer), "%u:%u", ts.timestamp, ts.increment);
+		WriteString(vec, row_idx, buffer, idx_t(len));
+		break;
+	}
+	case bsoncxx::type::k_decimal128: {
+		auto str = element.get_decimal128().value.to_string();
+		WriteString(vec, row_idx, str.data(), str.length());
+		break;
+	}
+	default:
+		// For unknown types, use a default representation
+		WriteString(vec, row_idx, "<unknown type>");
+		break;
+	}
+}
 
-		// Navigate through segments
-		for (size_t i = 0; i < segments.size(); i++) {
-			const std::string &seg = segments[i];
-			auto element = current[seg];
-			if (!element) {
-				return bsoncxx::document::element {};
-			}
-			result = element;
+// Non-VARCHAR scalar types decoded by FlattenDocument
+bool IsDecodedScalarType(LogicalTypeId type_id) {
+	switch (type_id) {
+	case LogicalTypeId::BIGINT:
+	case LogicalTypeId::HUGEINT:
+	case LogicalTypeId::DOUBLE:
+	case LogicalTypeId::BOOLEAN:
+	case LogicalTypeId::DATE:
+	case LogicalTypeId::TIMESTAMP:
+		return true;
+	default:
+		return false;
+	}
+}
 
-			// If this is not the last segment, it must be a document
-			if (i < segments.size() - 1) {
-				if (result.type() != bsoncxx::type::k_document) {
-					// Path is invalid - non-document in the middle
-					return bsoncxx::document::element {};
-				}
-				current = result.get_document().value;
-			} else {
-				// Last segment - return the element (even if null)
-				return result;
+// Writes a scalar of an already type-checked (IsBSONTypeCompatible) element
+void WriteCompatibleScalar(const bsoncxx::document::element &element, const LogicalType &type, Vector &vec,
+                           idx_t row_idx) {
+	switch (type.id()) {
+	case LogicalTypeId::BIGINT: {
+		int64_t int_val = 0;
+		if (element.type() == bsoncxx::type::k_int32) {
+			int_val = element.get_int32().value;
+		} else if (element.type() == bsoncxx::type::k_int64) {
+			int_val = element.get_int64().value;
+		} else if (element.type() == bsoncxx::type::k_double) {
+			int_val = static_cast<int64_t>(element.get_double().value);
+		}
+		MongoFlatVectorGetDataMutable<int64_t>(vec)[row_idx] = int_val;
+		break;
+	}
+	case LogicalTypeId::HUGEINT: {
+		// MongoDB doesn't have 128-bit integers, so we convert from int32/int64/double/decimal128
+		hugeint_t huge_val = 0;
+		if (element.type() == bsoncxx::type::k_int32) {
+			huge_val = hugeint_t(element.get_int32().value);
+		} else if (element.type() == bsoncxx::type::k_int64) {
+			huge_val = hugeint_t(element.get_int64().value);
+		} else if (element.type() == bsoncxx::type::k_double) {
+			huge_val = hugeint_t(static_cast<int64_t>(element.get_double().value));
+		} else if (element.type() == bsoncxx::type::k_decimal128) {
+			// Parse Decimal128 string and convert to hugeint (truncating decimal part)
+			auto dec_str = element.get_decimal128().value.to_string();
+			try {
+				double d = std::stod(dec_str);
+				huge_val = hugeint_t(static_cast<int64_t>(d));
+			} catch (...) {
+				huge_val = 0;
 			}
 		}
+		MongoFlatVectorGetDataMutable<hugeint_t>(vec)[row_idx] = huge_val;
+		break;
+	}
+	case LogicalTypeId::DOUBLE: {
+		double double_val = 0.0;
+		if (element.type() == bsoncxx::type::k_double) {
+			double_val = element.get_double().value;
+		} else if (element.type() == bsoncxx::type::k_int32) {
+			double_val = static_cast<double>(element.get_int32().value);
+		} else if (element.type() == bsoncxx::type::k_int64) {
+			double_val = static_cast<double>(element.get_int64().value);
+		} else if (element.type() == bsoncxx::type::k_decimal128) {
+			auto dec_str = element.get_decimal128().value.to_string();
+			try {
+				double_val = std::stod(dec_str);
+			} catch (...) {
+				double_val = 0.0;
+			}
+		}
+		MongoFlatVectorGetDataMutable<double>(vec)[row_idx] = double_val;
+		break;
+	}
+	case LogicalTypeId::BOOLEAN:
+		MongoFlatVectorGetDataMutable<bool>(vec)[row_idx] = element.get_bool().value;
+		break;
+	case LogicalTypeId::DATE:
+		// Convert milliseconds to timestamp_t, then to date_t
+		MongoFlatVectorGetDataMutable<date_t>(vec)[row_idx] =
+		    Timestamp::GetDate(Timestamp::FromEpochMs(element.get_date().to_int64()));
+		break;
+	case LogicalTypeId::TIMESTAMP:
+		MongoFlatVectorGetDataMutable<timestamp_t>(vec)[row_idx] =
+		    Timestamp::FromEpochMs(element.get_date().to_int64());
+		break;
+	default:
+		break;
+	}
+}
 
-		// Should never reach here, but return result if we do
-		return result;
-	};
+// Writes a struct field with the same conversions as BSONElementToValue (used for STRUCT children)
+void WriteStructField(const bsoncxx::document::element &element, const LogicalType &type, Vector &vec,
+                      idx_t row_idx) {
+	if (!element || element.type() == bsoncxx::type::k_null) {
+		FlatVector::SetNull(vec, row_idx, true);
+		return;
+	}
+	switch (type.id()) {
+	case LogicalTypeId::VARCHAR:
+		switch (element.type()) {
+		case bsoncxx::type::k_string:
+			WriteString(vec, row_idx, element.get_string().value);
+			break;
+		case bsoncxx::type::k_oid:
+			WriteObjectIdString(vec, row_idx, element.get_oid().value);
+			break;
+		case bsoncxx::type::k_document:
+			WriteJsonString(vec, row_idx, bsoncxx::to_json(element.get_document().value), nullptr);
+			break;
+		case bsoncxx::type::k_array:
+			WriteJsonString(vec, row_idx, bsoncxx::to_json(element.get_array().value), nullptr);
+			break;
+		default:
+			WriteString(vec, row_idx, "<unknown>");
+			break;
+		}
+		return;
+	case LogicalTypeId::BIGINT:
+	case LogicalTypeId::DOUBLE:
+		if (element.type() == bsoncxx::type::k_int32 || element.type() == bsoncxx::type::k_int64 ||
+		    element.type() == bsoncxx::type::k_double) {
+			WriteCompatibleScalar(element, type, vec, row_idx);
+		} else if (type.id() == LogicalTypeId::BIGINT) {
+			MongoFlatVectorGetDataMutable<int64_t>(vec)[row_idx] = 0;
+		} else {
+			MongoFlatVectorGetDataMutable<double>(vec)[row_idx] = 0.0;
+		}
+		return;
+	case LogicalTypeId::BOOLEAN:
+		MongoFlatVectorGetDataMutable<bool>(vec)[row_idx] =
+		    element.type() == bsoncxx::type::k_bool && element.get_bool().value;
+		return;
+	case LogicalTypeId::DATE:
+	case LogicalTypeId::TIMESTAMP: {
+		int64_t ms_since_epoch = element.type() == bsoncxx::type::k_date ? element.get_date().to_int64() : 0;
+		auto ts_val = Timestamp::FromEpochMs(ms_since_epoch);
+		if (type.id() == LogicalTypeId::DATE) {
+			MongoFlatVectorGetDataMutable<date_t>(vec)[row_idx] = Timestamp::GetDate(ts_val);
+		} else {
+			MongoFlatVectorGetDataMutable<timestamp_t>(vec)[row_idx] = ts_val;
+		}
+		return;
+	}
+	default:
+		FlatVector::SetNull(vec, row_idx, true);
+		return;
+	}
+}
 
-	auto getArrayByMongoPath = [&](const std::string &mongo_path) -> bsoncxx::array::view {
-		std::vector<std::string> segments;
-		std::istringstream iss(mongo_path);
-		std::string segment;
+void WriteStruct(const bsoncxx::document::view &struct_doc, const LogicalType &struct_type, Vector &vec,
+                 idx_t row_idx) {
+	auto &child_types = StructType::GetChildTypes(struct_type);
+	auto &children = StructVector::GetEntries(vec);
+	for (idx_t child_idx = 0; child_idx < child_types.size(); child_idx++) {
+		const auto &field_name = MongoChildPairName(child_types[child_idx]);
+		WriteStructField(struct_doc[field_name], child_types[child_idx].second, *children[child_idx], row_idx);
+	}
+}
 
-		// Split by dots (MongoDB path notation)
-		while (std::getline(iss, segment, '.')) {
-			segments.push_back(segment);
+// LIST types whose elements can be written straight into the child vector (one level of nesting)
+bool IsDirectListChildType(const LogicalType &child_type) {
+	switch (child_type.id()) {
+	case LogicalTypeId::VARCHAR:
+	case LogicalTypeId::BIGINT:
+	case LogicalTypeId::DOUBLE:
+	case LogicalTypeId::BOOLEAN:
+	case LogicalTypeId::STRUCT:
+		return true;
+	default:
+		return false;
+	}
+}
+
+// Writes one list element with the conversions of BSONArrayToList. Exact type matches are written directly;
+// other conversions go through a Value cast so the results stay identical.
+void WriteListElement(const bsoncxx::array::element &element, const LogicalType &child_type, Vector &child,
+                      idx_t child_idx) {
+	auto type = element.type();
+	if (type == bsoncxx::type::k_null || type == bsoncxx::type::k_array) {
+		// Nested arrays don't fit a one-level list: BSONArrayToList produces NULL for them as well
+		FlatVector::SetNull(child, child_idx, true);
+		return;
+	}
+	if (child_type.id() == LogicalTypeId::STRUCT) {
+		if (type == bsoncxx::type::k_document) {
+			WriteStruct(element.get_document().value, child_type, child, child_idx);
+		} else {
+			FlatVector::SetNull(child, child_idx, true);
 		}
+		return;
+	}
 
-		if (segments.empty()) {
-			return bsoncxx::array::view {};
+	Value elem_val;
+	switch (type) {
+	case bsoncxx::type::k_string:
+		if (child_type.id() == LogicalTypeId::VARCHAR) {
+			WriteString(child, child_idx, element.get_string().value);
+			return;
+		}
+		elem_val = Value(std::string(element.get_string().value.data(), element.get_string().value.length()));
+		break;
+	case bsoncxx::type::k_int32:
+	case bsoncxx::type::k_int64: {
+		int64_t int_val =
+		    type == bsoncxx::type::k_int32 ? int64_t(element.get_int32().value) : element.get_int64().value;
+		if (child_type.id() == LogicalTypeId::BIGINT) {
+			MongoFlatVectorGetDataMutable<int64_t>(child)[child_idx] = int_val;
+			return;
+		}
+		if (child_type.id() == LogicalTypeId::DOUBLE) {
+			MongoFlatVectorGetDataMutable<double>(child)[child_idx] = static_cast<double>(int_val);
+			return;
+		}
+		if (child_type.id() == LogicalTypeId::VARCHAR) {
+			WriteIntegerString(child, child_idx, int_val);
+			return;
+		}
+		elem_val = Value::BIGINT(int_val);
+		break;
+	}
+	case bsoncxx::type::k_double:
+		if (child_type.id() == LogicalTypeId::DOUBLE) {
+			MongoFlatVectorGetDataMutable<double>(child)[child_idx] = element.get_double().value;
+			return;
+		}
+		elem_val = Value::DOUBLE(element.get_double().value);
+		break;
+	case bsoncxx::type::k_bool:
+		if (child_type.id() == LogicalTypeId::BOOLEAN) {
+			MongoFlatVectorGetDataMutable<bool>(child)[child_idx] = element.get_bool().value;
+			return;
 		}
+		elem_val = Value::BOOLEAN(element.get_bool().value);
+		break;
+	default:
+		FlatVector::SetNull(child, child_idx, true);
+		return;
+	}
 
-		bsoncxx::document::view current = doc;
-		bsoncxx::document::element result;
+	Value casted_val;
+	string error_msg;
+	if (elem_val.DefaultTryCastAs(child_type, casted_val, &error_msg)) {
+		child.SetValue(child_idx, casted_val);
+	} else {
+		FlatVector::SetNull(child, child_idx, true);
+	}
+}
 
-		// Navigate through segments
-		for (size_t i = 0; i < segments.size(); i++) {
-			const std::string &seg = segments[i];
-			auto element = current[seg];
-			if (!element) {
-				return bsoncxx::array::view {};
+void WriteList(const bsoncxx::array::view &array_view, const LogicalType &list_type, Vector &vec, idx_t row_idx) {
+	auto &child_type = ListType::GetChildType(list_type);
+	if (!IsDirectListChildType(child_type)) {
+		// Multi-dimensional lists keep the Value-based conversion (handles depth mismatches)
+		Value list_value;
+		if (array_view.begin() == array_view.end()) {
+			list_value = Value::LIST(child_type, vector<Value>());
+		} else {
+			list_value = BSONArrayToList(array_view, list_type);
+		}
+		if (list_value.type() != list_type) {
+			Value casted_list;
+			string error_msg;
+			if (!list_value.DefaultTryCastAs(list_type, casted_list, &error_msg)) {
+				FlatVector::SetNull(vec, row_idx, true);
+				return;
 			}
-			result = element;
+			list_value = casted_list;
+		}
+		vec.SetValue(row_idx, list_value);
+		return;
+	}
 
-			// If this is not the last segment, it must be a document
-			if (i < segments.size() - 1) {
-				if (result.type() != bsoncxx::type::k_document) {
-					return bsoncxx::array::view {};
-				}
-				current = result.get_document().value;
-			} else {
-				// Last segment - check if it's an array
-				if (result.type() == bsoncxx::type::k_array) {
-					return result.get_array().value;
-				}
-				return bsoncxx::array::view {};
-			}
+	idx_t length = 0;
+	for (auto it = array_view.begin(); it != array_view.end(); ++it) {
+		length++;
+	}
+	auto offset = ListVector::GetListSize(vec);
+	ListVector::Reserve(vec, offset + length);
+	auto &child = ListVector::GetEntry(vec);
+	idx_t child_idx = offset;
+	for (const auto &element : array_view) {
+		WriteListElement(element, child_type, child, child_idx++);
+	}
+	ListVector::SetListSize(vec, offset + length);
+
+	auto &entry = MongoFlatVectorGetDataMutable<list_entry_t>(vec)[row_idx];
+	entry.offset = offset;
+	entry.length = length;
+}
+
+// Writes a sub-document as MAP(VARCHAR, T) with one entry per field; values that don't fit T become NULL
+void WriteMap(const bsoncxx::document::view &map_doc, const LogicalType &map_type, Vector &vec, idx_t row_idx,
+              ArenaAllocator *scratch) {
+	auto &value_type = MapType::ValueType(map_type);
+	idx_t length = 0;
+	for (auto it = map_doc.begin(); it != map_doc.end(); ++it) {
+		length++;
+	}
+	auto offset = ListVector::GetListSize(vec);
+	ListVector::Reserve(vec, offset + length);
+	auto &keys = MapVector::GetKeys(vec);
+	auto &values = MapVector::GetValues(vec);
+	idx_t child_idx = offset;
+	for (const auto &element : map_doc) {
+		WriteString(keys, child_idx, element.key());
+		auto type = element.type();
+		if (type == bsoncxx::type::k_null || type == bsoncxx::type::k_undefined) {
+			FlatVector::SetNull(values, child_idx, true);
+		} else if (value_type.id() == LogicalTypeId::VARCHAR) {
+			WriteVarchar(element, values, child_idx, scratch);
+		} else if (IsDecodedScalarType(value_type.id()) && IsBSONTypeCompatible(type, value_type.id())) {
+			WriteCompatibleScalar(element, value_type, values, child_idx);
+		} else {
+			FlatVector::SetNull(values, child_idx, true);
 		}
+		child_idx++;
+	}
+	ListVector::SetListSize(vec, offset + length);
 
-		return bsoncxx::array::view {};
-	};
+	auto &entry = MongoFlatVectorGetDataMutable<list_entry_t>(vec)[row_idx];
+	entry.offset = offset;
+	entry.length = length;
+}
 
-	auto getArrayByPath = [&](const std::string &path) -> bsoncxx::array::view {
-		std::istringstream iss(path);
-		std::string segment;
-		bsoncxx::document::view current = doc;
-		bsoncxx::document::element result;
+// Rolls back a partially decoded row: clears the NULLs it set (including in STRUCT children). LIST and MAP entries
+// it appended stay in the child vectors unreferenced, since the next row writes a new entry past them.
+void ResetRowValidity(Vector &vec, idx_t row_idx) {
+	FlatVector::SetNull(vec, row_idx, false);
+	if (vec.GetType().id() == LogicalTypeId::STRUCT) {
+		for (auto &child : StructVector::GetEntries(vec)) {
+			ResetRowValidity(*child, row_idx);
+		}
+	}
+}
 
-		while (std::getline(iss, segment, '_')) {
-			auto element = current[segment];
-			if (!element) {
-				return bsoncxx::array::view {};
+// Per-document state of a column in FlattenDocument's raw pass
+enum : uint8_t { RAW_UNSEEN = 0, RAW_WRITTEN = 1, RAW_FALLBACK = 2 };
+
+// Writes a value read by MongoBsonReader with the conversions of WriteCompatibleScalar and WriteVarchar. Returns
+// false for the values left to the bsoncxx path: other BSON types, including schema violations.
+bool WriteRawScalar(const MongoBsonElement &element, const LogicalType &type, Vector &vec, idx_t row_idx) {
+	if (element.type == MongoBsonType::NULL_VALUE) {
+		FlatVector::SetNull(vec, row_idx, true);
+		return true;
+	}
+	switch (type.id()) {
+	case LogicalTypeId::BIGINT:
+	case LogicalTypeId::HUGEINT: {
+		int64_t int_val;
+		if (element.type == MongoBsonType::INT32) {
+			int_val = element.GetInt32();
+		} else if (element.type == MongoBsonType::INT64) {
+			int_val = element.GetInt64();
+		} else if (element.type == MongoBsonType::DOUBLE) {
+			int_val = static_cast<int64_t>(element.GetDouble());
+		} else {
+			return false;
+		}
+		if (type.id() == LogicalTypeId::BIGINT) {
+			MongoFlatVectorGetDataMutable<int64_t>(vec)[row_idx] = int_val;
+		} else {
+			MongoFlatVectorGetDataMutable<hugeint_t>(vec)[row_idx] = hugeint_t(int_val);
+		}
+		return true;
+	}
+	case LogicalTypeId::DOUBLE: {
+		double double_val;
+		if (element.type == MongoBsonType::DOUBLE) {
+			double_val = element.GetDouble();
+		} else if (element.type == MongoBsonType::INT32) {
+			double_val = static_cast<double>(element.GetInt32());
+		} else if (element.type == MongoBsonType::INT64) {
+			double_val = static_cast<double>(element.GetInt64());
+		} else {
+			return false;
+		}
+		MongoFlatVectorGetDataMutable<double>(vec)[row_idx] = double_val;
+		return true;
+	}
+	case LogicalTypeId::BOOLEAN:
+		if (element.type != MongoBsonType::BOOL) {
+			return false;
+		}
+		MongoFlatVectorGetDataMutable<bool>(vec)[row_idx] = element.GetBool();
+		return true;
+	case LogicalTypeId::DATE:
+		if (element.type != MongoBsonType::DATE) {
+			return false;
+		}
+		MongoFlatVectorGetDataMutable<date_t>(vec)[row_idx] =
+		    Timestamp::GetDate(Timestamp::FromEpochMs(element.GetInt64()));
+		return true;
+	case LogicalTypeId::TIMESTAMP:
+		if (element.type != MongoBsonType::DATE) {
+			return false;
+		}
+		MongoFlatVectorGetDataMutable<timestamp_t>(vec)[row_idx] = Timestamp::FromEpochMs(element.GetInt64());
+		return true;
+	case LogicalTypeId::VARCHAR:
+		switch (element.type) {
+		case MongoBsonType::STRING:
+			WriteString(vec, row_idx, element.GetStringData(), element.GetStringLength());
+			return true;
+		case MongoBsonType::OID:
+			WriteObjectIdString(vec, row_idx, element.value);
+			return true;
+		case MongoBsonType::INT32:
+			WriteIntegerString(vec, row_idx, element.GetInt32());
+			return true;
+		case MongoBsonType::INT64:
+		case MongoBsonType::DATE:
+			WriteIntegerString(vec, row_idx, element.GetInt64());
+			return true;
+		case MongoBsonType::DOUBLE:
+			WriteDoubleString(vec, row_idx, element.GetDouble());
+			return true;
+		case MongoBsonType::BOOL:
+			WriteString(vec, row_idx, element.GetBool() ? "true" : "false");
+			return true;
+		default:
+			return false;
+		}
+	default:
+		return false;
+	}
+}
+
+// Resolves the raw_scalar columns whose paths continue below a document, `node` being the trie node of its path, in
+// one pass over its elements. Like doc[key] and LookupPath, only the first element with a given key counts. Returns
+// false when the document is malformed.
+bool WalkRawColumns(const uint8_t *data, size_t length, const MongoPathTrie &trie, uint32_t node,
+                    const std::vector<MongoColumnPlan> &columns, DataChunk &output, idx_t row_idx, uint8_t *states,
+                    idx_t &remaining) {
+	MongoBsonReader reader(data, length);
+	MongoBsonElement element;
+	bool valid = true;
+	auto &matcher = trie.nodes[node].matcher;
+	while (remaining > 0 && reader.Next(element)) {
+		auto field_idx = matcher.Find(element.key, element.key_length);
+		if (field_idx == MongoFieldMatcher::NOT_FOUND) {
+			continue;
+		}
+		auto &field = trie.nodes[node].fields[field_idx];
+		if (states[field.subtree_columns[0]] != RAW_UNSEEN) {
+			// A later element with the same key
+			continue;
+		}
+		for (auto col_idx : field.columns) {
+			bool written = WriteRawScalar(element, columns[col_idx].column_type, output.data[col_idx], row_idx);
+			states[col_idx] = written ? RAW_WRITTEN : RAW_FALLBACK;
+			remaining--;
+		}
+		if (field.child == MongoPathTrie::NO_CHILD) {
+			continue;
+		}
+		if (element.type == MongoBsonType::DOCUMENT) {
+			valid = WalkRawColumns(element.value, element.value_length, trie, field.child, columns, output, row_idx,
+			                       states, remaining) &&
+			        valid;
+		}
+		for (auto col_idx : field.subtree_columns) {
+			if (states[col_idx] == RAW_UNSEEN) {
+				// Not below this element, or the element isn't a document
+				FlatVector::SetNull(output.data[col_idx], row_idx, true);
+				states[col_idx] = RAW_WRITTEN;
+				remaining--;
 			}
-			result = element;
-			if (result.type() == bsoncxx::type::k_document) {
-				current = result.get_document().value;
-			} else if (result.type() == bsoncxx::type::k_array) {
-				return result.get_array().value;
-			} else {
-				return bsoncxx::array::view {};
+		}
+	}
+	return valid && !reader.Malformed();
+}
+
+} // namespace
+
+// Validation-only function that checks schema compatibility without writing to output
+// Used for COUNT(*) queries where we need to validate but not materialize data
+bool ValidateDocumentSchema(const bsoncxx::document::view &doc, const std::vector<MongoColumnPlan> &columns,
+                            SchemaMode schema_mode) {
+	for (const auto &column : columns) {
+		// Skip complex types (LIST, STRUCT, MAP) - they have their own conversion logic
+		if (column.column_type.id() == LogicalTypeId::LIST || column.column_type.id() == LogicalTypeId::STRUCT ||
+		    column.column_type.id() == LogicalTypeId::MAP) {
+			continue;
+		}
+
+		auto element = column.nested_path ? LookupPath(doc, column.path_segments) : doc[column.mongo_path];
+
+		// Missing field is OK (will be NULL)
+		if (!element || element.type() == bsoncxx::type::k_null || element.type() == bsoncxx::type::k_undefined) {
+			continue;
+		}
+
+		// Check type compatibility for scalar types
+		if (!IsBSONTypeCompatible(element.type(), column.column_type.id())) {
+			if (schema_mode == SchemaMode::FAILFAST) {
+				throw InvalidInputException(
+				    "Schema violation in document _id='%s': Field '%s' expected type %s but found %s.\n"
+				    "Hint: Use schema_mode='permissive' to replace with NULL, or 'dropmalformed' to skip bad rows.",
+				    GetDocumentIdForError(doc), column.column_name, column.column_type.ToString(),
+				    GetBSONTypeName(element.type()));
 			}
+			// DROPMALFORMED: signal that row should be skipped
+			return false;
 		}
+	}
+	return true;
+}
+
+bool ValidateDocumentSchema(const bsoncxx::document::view &doc, const std::vector<string> &column_names,
+                            const std::vector<LogicalType> &column_types,
+                            const std::unordered_map<string, string> &column_name_to_mongo_path,
+                            SchemaMode schema_mode) {
+	return ValidateDocumentSchema(doc, BuildColumnPlans(column_names, column_types, column_name_to_mongo_path),
+	                              schema_mode);
+}
 
-		if (result && result.type() == bsoncxx::type::k_array) {
-			return result.get_array().value;
+bool FlattenDocument(const bsoncxx::document::view &doc, const std::vector<MongoColumnPlan> &columns,
+                     DataChunk &output, idx_t row_idx, SchemaMode schema_mode, bool has_explicit_schema,
+                     ArenaAllocator *scratch) {
+	// Scalar columns are resolved by a single walk over the document bytes. Values it can't convert (other BSON
+	// types, schema violations) and the other columns go through the bsoncxx lookups below.
+	static constexpr idx_t INLINE_STATES = 256;
+	uint8_t inline_states[INLINE_STATES];
+	std::vector<uint8_t> heap_states;
+	uint8_t *states = inline_states;
+	if (columns.size() > INLINE_STATES) {
+		heap_states.resize(columns.size());
+		states = heap_states.data();
+	}
+	memset(states, RAW_UNSEEN, columns.size());
+	idx_t remaining = 0;
+	for (auto &column : columns) {
+		if (column.raw_scalar) {
+			remaining++;
 		}
-		return bsoncxx::array::view {};
-	};
+	}
+	if (remaining > 0 && columns[0].raw_paths) {
+		auto &trie = *columns[0].raw_paths;
+		bool valid = WalkRawColumns(doc.data(), doc.length(), trie, 0, columns, output, row_idx, states, remaining);
+		for (idx_t col_idx = 0; col_idx < columns.size(); col_idx++) {
+			const auto &column = columns[col_idx];
+			if (!column.raw_scalar || states[col_idx] != RAW_UNSEEN) {
+				continue;
+			}
+			// Missing: NULL, unless the underscore fallback below may still find it
+			if (valid && (column.nested_path || column.underscore_segments.size() <= 1)) {
+				FlatVector::SetNull(output.data[col_idx], row_idx, true);
+				states[col_idx] = RAW_WRITTEN;
+			}
+		}
+	}
 
-	for (idx_t col_idx = 0; col_idx < column_names.size(); col_idx++) {
-		const auto &column_name = column_names[col_idx];
-		const auto &column_type = column_types[col_idx];
+	for (idx_t col_idx = 0; col_idx < columns.size(); col_idx++) {
+		if (states[col_idx] == RAW_WRITTEN) {
+			continue;
+		}
+		const auto &column = columns[col_idx];
+		const auto &column_type = column.column_type;
+		auto &vec = output.data[col_idx];
 
 		if (column_type.id() == LogicalTypeId::LIST) {
-			auto element = doc[column_name];
 			bsoncxx::array::view array_view;
-
+			auto element = doc[column.column_name];
 			if (element && element.type() == bsoncxx::type::k_array) {
 				array_view = element.get_array().value;
-			} else {
-				// Try MongoDB path-based lookup for nested fields
-				auto path_it = column_name_to_mongo_path.find(column_name);
-				if (path_it != column_name_to_mongo_path.end()) {
-					// Use MongoDB dot-notation path
-					array_view = getArrayByMongoPath(path_it->second);
-				} else {
-					// Fallback to underscore-based path splitting
-					array_view = getArrayByPath(column_name);
+			} else if (column.has_mongo_path) {
+				// Use MongoDB dot-notation path
+				element = LookupPath(doc, column.path_segments);
+				if (element && element.type() == bsoncxx::type::k_array) {
+					array_view = element.get_array().value;
 				}
+			} else {
+				// Fallback to underscore-based path splitting
+				array_view = LookupArrayByUnderscorePath(doc, column.underscore_segments);
 			}
+			WriteList(array_view, column_type, vec, row_idx);
+			continue;
+		}
 
-			auto &vec = output.data[col_idx];
-			if (array_view.begin() == array_view.end()) {
-				Value empty_list = Value::LIST(ListType::GetChildType(column_type), vector<Value>());
-				if (empty_list.type() != column_type) {
-					Value casted_list;
-					string error_msg;
-					if (!empty_list.DefaultTryCastAs(column_type, casted_list, &error_msg)) {
-						FlatVector::SetNull(vec, row_idx, true);
-						continue;
-					}
-					empty_list = casted_list;
-				}
-				vec.SetValue(row_idx, empty_list);
+		if (column_type.id() == LogicalTypeId::MAP) {
+			auto element = column.nested_path ? LookupPath(doc, column.path_segments) : doc[column.mongo_path];
+			if (element && element.type() == bsoncxx::type::k_document) {
+				WriteMap(element.get_document().value, column_type, vec, row_idx, scratch);
 			} else {
-				// BSONArrayToList now handles depth mismatches by wrapping shallower arrays
-				Value list_value = BSONArrayToList(array_view, column_type);
-				if (list_value.type() != column_type) {
-					Value casted_list;
-					string error_msg;
-					if (!list_value.DefaultTryCastAs(column_type, casted_list, &error_msg)) {
-						FlatVector::SetNull(vec, row_idx, true);
-					} else {
-						vec.SetValue(row_idx, casted_list);
-					}
-				} else {
-					vec.SetValue(row_idx, list_value);
-				}
+				FlatVector::SetNull(vec, row_idx, true);
 			}
 			continue;
 		}
 
 		if (column_type.id() == LogicalTypeId::STRUCT) {
-			auto element = doc[column_name];
-			bsoncxx::document::view struct_doc;
-
-			auto &vec = output.data[col_idx];
+			auto element = doc[column.column_name];
+			if ((!element || element.type() != bsoncxx::type::k_document) && column.has_mongo_path) {
+				element = LookupPath(doc, column.path_segments);
+			}
 			if (element && element.type() == bsoncxx::type::k_document) {
-				struct_doc = element.get_document().value;
+				WriteStruct(element.get_document().value, column_type, vec, row_idx);
 			} else {
-				// Try MongoDB path-based lookup for nested fields
-				auto path_it = column_name_to_mongo_path.find(column_name);
-				if (path_it != column_name_to_mongo_path.end()) {
-					// Use MongoDB dot-notation path
-					element = getElementByMongoPath(path_it->second);
-					if (element && element.type() == bsoncxx::type::k_document) {
-						struct_doc = element.get_document().value;
-					} else {
-						Value null_struct = Value(column_type);
-						vec.SetValue(row_idx, null_struct);
-						continue;
-					}
-				} else {
-					Value null_struct = Value(column_type);
-					vec.SetValue(row_idx, null_struct);
-					continue;
-				}
-			}
-
-			Value struct_value = BSONDocumentToStruct(struct_doc, column_type);
-			if (struct_value.type() != column_type) {
-				Value casted_struct;
-				string error_msg;
-				if (!struct_value.DefaultTryCastAs(column_type, casted_struct, &error_msg)) {
-					FlatVector::SetNull(vec, row_idx, true);
-					continue;
-				}
-				struct_value = casted_struct;
+				FlatVector::SetNull(vec, row_idx, true);
 			}
-			vec.SetValue(row_idx, struct_value);
 			continue;
 		}
 
-		// Get MongoDB path for this column
-		std::string mongo_field_name = column_name;
-		auto path_it = column_name_to_mongo_path.find(column_name);
-		if (path_it != column_name_to_mongo_path.end()) {
-			mongo_field_name = path_it->second;
-		}
-
 		bsoncxx::document::element element;
-
-		// Check if this is a nested path (contains dots)
-		if (mongo_field_name.find('.') != std::string::npos) {
+		if (column.nested_path) {
 			// Use MongoDB path-based lookup for nested fields
-			element = getElementByMongoPath(mongo_field_name);
+			element = LookupPath(doc, column.path_segments);
 		} else {
-			// Try direct field access first (O(1) for top-level fields)
-			element = doc[mongo_field_name];
-
-			// If direct access didn't find the field, try iteration as fallback
+			element = doc[column.mongo_path];
 			if (!element) {
-				bool found = false;
-				for (auto it = doc.begin(); it != doc.end(); ++it) {
-					std::string field_key(it->key().data(), it->key().length());
-					if (field_key == mongo_field_name) {
-						element = *it;
-						found = true;
-						break;
-					}
-				}
-				if (!found) {
-					// Fallback to underscore-based path splitting
-					element = getElementByPath(column_name);
-				}
+				// Fallback to underscore-based path splitting
+				element = LookupPath(doc, column.underscore_segments);
 			}
 		}
 
 		if (!element || element.type() == bsoncxx::type::k_null) {
 			// Field not found - set to NULL
-			FlatVector::SetNull(output.data[col_idx], row_idx, true);
+			FlatVector::SetNull(vec, row_idx, true);
 			continue;
 		}
 
-		switch (column_type.id()) {
-		case LogicalTypeId::VARCHAR: {
-			std::string str_val;
-			if (element.type() == bsoncxx::type::k_string) {
-				str_val = std::string(element.get_string().value.data(), element.get_string().value.length());
-			} else if (element.type() == bsoncxx::type::k_oid) {
-				str_val = element.get_oid().value.to_string();
-			} else if (element.type() == bsoncxx::type::k_document) {
-				str_val = NormalizeJson(bsoncxx::to_json(element.get_document().value));
-			} else if (element.type() == bsoncxx::type::k_array) {
-				str_val = NormalizeJson(bsoncxx::to_json(element.get_array().value));
-			} else if (element.type() == bsoncxx::type::k_int32) {
-				str_val = std::to_string(element.get_int32().value);
-			} else if (element.type() == bsoncxx::type::k_int64) {
-				str_val = std::to_string(element.get_int64().value);
-			} else if (element.type() == bsoncxx::type::k_double) {
-				str_val = std::to_string(element.get_double().value);
-			} else if (element.type() == bsoncxx::type::k_bool) {
-				str_val = element.get_bool().value ? "true" : "false";
-			} else if (element.type() == bsoncxx::type::k_date) {
-				str_val = std::to_string(element.get_date().to_int64());
-			} else if (element.type() == bsoncxx::type::k_null) {
-				str_val = "null";
-			} else if (element.type() == bsoncxx::type::k_binary) {
-				str_val = "<binary data>";
-			} else if (element.type() == bsoncxx::type::k_undefined) {
-				str_val = "undefined";
-			} else if (element.type() == bsoncxx::type::k_regex) {
-				auto regex = element.get_regex();
-				str_val = "/" + std::string(regex.regex.data(), regex.regex.length()) + "/" +
-				          std::string(regex.options.data(), regex.options.length());
-			} else if (element.type() == bsoncxx::type::k_dbpointer) {
-				str_val = "<dbpointer>";
-			} else if (element.type() == bsoncxx::type::k_code) {
-				str_val = std::string(element.get_code().code.data(), element.get_code().code.length());
-			} else if (element.type() == bsoncxx::type::k_codewscope) {
-				str_val = std::string(element.get_codewscope().code.data(), element.get_codewscope().code.length());
-			} else if (element.type() == bsoncxx::type::k_symbol) {
-				str_val = std::string(element.get_symbol().symbol.data(), element.get_symbol().symbol.length());
-			} else if (element.type() == bsoncxx::type::k_timestamp) {
-				auto ts = element.get_timestamp();
-				str_val = std::to_string(ts.timestamp) + ":" + std::to_string(ts.increment);
-			} else if (element.type() == bsoncxx::type::k_decimal128) {
-				str_val = element.get_decimal128().value.to_string();
-			} else {
-				// For unknown types, use a default representation
-				str_val = "<unknown type>";
-			}
-			MongoFlatVectorGetDataMutable<string_t>(output.data[col_idx])[row_idx] =
-			    StringVector::AddString(output.data[col_idx], str_val);
-			break;
-		}
-		case LogicalTypeId::BIGINT: {
-			// Check type compatibility
-			if (!IsBSONTypeCompatible(element.type(), LogicalTypeId::BIGINT)) {
-				if (!handleSchemaViolation(column_name, "BIGINT", element.type(), col_idx)) {
-					return false; // DROPMALFORMED: skip this row
-				}
-				break; // PERMISSIVE: already set to NULL
-			}
-			int64_t int_val = 0;
-			if (element.type() == bsoncxx::type::k_int32) {
-				int_val = element.get_int32().value;
-			} else if (element.type() == bsoncxx::type::k_int64) {
-				int_val = element.get_int64().value;
-			} else if (element.type() == bsoncxx::type::k_double) {
-				int_val = static_cast<int64_t>(element.get_double().value);
-			}
-			MongoFlatVectorGetDataMutable<int64_t>(output.data[col_idx])[row_idx] = int_val;
-			break;
-		}
-		case LogicalTypeId::HUGEINT: {
-			// Check type compatibility
-			if (!IsBSONTypeCompatible(element.type(), LogicalTypeId::HUGEINT)) {
-				if (!handleSchemaViolation(column_name, "HUGEINT", element.type(), col_idx)) {
-					return false;
-				}
-				break;
-			}
-			// MongoDB doesn't have 128-bit integers, so we convert from int32/int64/double/decimal128
-			hugeint_t huge_val = 0;
-			if (element.type() == bsoncxx::type::k_int32) {
-				huge_val = hugeint_t(element.get_int32().value);
-			} else if (element.type() == bsoncxx::type::k_int64) {
-				huge_val = hugeint_t(element.get_int64().value);
-			} else if (element.type() == bsoncxx::type::k_double) {
-				huge_val = hugeint_t(static_cast<int64_t>(element.get_double().value));
-			} else if (element.type() == bsoncxx::type::k_decimal128) {
-				// Parse Decimal128 string and convert to hugeint (truncating decimal part)
-				auto dec_str = element.get_decimal128().value.to_string();
-				try {
-					double d = std::stod(dec_str);
-					huge_val = hugeint_t(static_cast<int64_t>(d));
-				} catch (...) {
-					huge_val = 0;
-				}
-			}
-			MongoFlatVectorGetDataMutable<hugeint_t>(output.data[col_idx])[row_idx] = huge_val;
-			break;
-		}
-		case LogicalTypeId::DOUBLE: {
-			// Check type compatibility
-			if (!IsBSONTypeCompatible(element.type(), LogicalTypeId::DOUBLE)) {
-				if (!handleSchemaViolation(column_name, "DOUBLE", element.type(), col_idx)) {
-					return false;
-				}
-				break;
-			}
-			double double_val = 0.0;
-			if (element.type() == bsoncxx::type::k_double) {
-				double_val = element.get_double().value;
-			} else if (element.type() == bsoncxx::type::k_int32) {
-				double_val = static_cast<double>(element.get_int32().value);
-			} else if (element.type() == bsoncxx::type::k_int64) {
-				double_val = static_cast<double>(element.get_int64().value);
-			} else if (element.type() == bsoncxx::type::k_decimal128) {
-				auto dec_str = element.get_decimal128().value.to_string();
-				try {
-					double_val = std::stod(dec_str);
-				} catch (...) {
-					double_val = 0.0;
-				}
-			}
-			MongoFlatVectorGetDataMutable<double>(output.data[col_idx])[row_idx] = double_val;
-			break;
-		}
-		case LogicalTypeId::BOOLEAN: {
-			// Check type compatibility
-			if (!IsBSONTypeCompatible(element.type(), LogicalTypeId::BOOLEAN)) {
-				if (!handleSchemaViolation(column_name, "BOOLEAN", element.type(), col_idx)) {
-					return false;
-				}
-				break;
-			}
-			bool bool_val = false;
-			if (element.type() == bsoncxx::type::k_bool) {
-				bool_val = element.get_bool().value;
-			}
-			MongoFlatVectorGetDataMutable<bool>(output.data[col_idx])[row_idx] = bool_val;
-			break;
-		}
-		case LogicalTypeId::DATE: {
-			// Check type compatibility
-			if (!IsBSONTypeCompatible(element.type(), LogicalTypeId::DATE)) {
-				if (!handleSchemaViolation(column_name, "DATE", element.type(), col_idx)) {
-					return false;
-				}
-				break;
-			}
-			date_t date_val;
-			if (element.type() == bsoncxx::type::k_date) {
-				auto mongo_date = element.get_date();
-				auto ms_since_epoch = mongo_date.to_int64();
-				// Convert milliseconds to timestamp_t, then to date_t
-				timestamp_t ts_val = Timestamp::FromEpochMs(ms_since_epoch);
-				date_val = Timestamp::GetDate(ts_val);
-			} else {
-				date_val = date_t(0);
-			}
-			MongoFlatVectorGetDataMutable<date_t>(output.data[col_idx])[row_idx] = date_val;
-			break;
+		if (column_type.id() == LogicalTypeId::VARCHAR) {
+			WriteVarchar(element, vec, row_idx, scratch);
+			continue;
 		}
-		case LogicalTypeId::TIMESTAMP: {
-			// Check type compatibility
-			if (!IsBSONTypeCompatible(element.type(), LogicalTypeId::TIMESTAMP)) {
-				if (!handleSchemaViolation(column_name, "TIMESTAMP", element.type(), col_idx)) {
-					return false;
-				}
-				break;
+
+		if (!IsBSONTypeCompatible(element.type(), column_type.id())) {
+			// Schema modes are only enforced for explicit schemas; otherwise the value becomes NULL.
+			// Undefined counts as missing, as in ValidateDocumentSchema.
+			bool violation = has_explicit_schema && element.type() != bsoncxx::type::k_undefined;
+			if (violation && schema_mode == SchemaMode::FAILFAST) {
+				throw InvalidInputException(
+				    "Schema violation in document _id='%s': Field '%s' expected type %s but found %s.\n"
+				    "Hint: Use schema_mode='permissive' to replace with NULL, or 'dropmalformed' to skip bad rows.",
+				    GetDocumentIdForError(doc), column.column_name, column_type.ToString(),
+				    GetBSONTypeName(element.type()));
 			}
-			timestamp_t ts_val;
-			if (element.type() == bsoncxx::type::k_date) {
-				auto date_val = element.get_date();
-				ts_val = Timestamp::FromEpochMs(date_val.to_int64());
-			} else {
-				ts_val = Timestamp::FromEpochMs(0);
+			if (violation && schema_mode == SchemaMode::DROPMALFORMED) {
+				return false; // DROPMALFORMED: skip this row
 			}
-			MongoFlatVectorGetDataMutable<timestamp_t>(output.data[col_idx])[row_idx] = ts_val;
-			break;
+			FlatVector::SetNull(vec, row_idx, true);
+			continue;
 		}
-		default: {
+
+		if (!IsDecodedScalarType(column_type.id())) {
 			// Default to NULL for unsupported types
-			FlatVector::SetNull(output.data[col_idx], row_idx, true);
-			break;
-		}
+			FlatVector::SetNull(vec, row_idx, true);
+			continue;
 		}
+		WriteCompatibleScalar(element, column_type, vec, row_idx);
 	}
+	return true;
+}
 
-	return !row_has_violation;
+bool FlattenAndValidateDocument(const bsoncxx::document::view &doc, const std::vector<MongoColumnPlan> &columns,
+                                const std::vector<MongoColumnPlan> &validation_columns, DataChunk &output,
+                                idx_t row_idx, SchemaMode schema_mode, ArenaAllocator *scratch) {
+	// Check the columns that are not decoded first: a dropped row then costs no writes
+	if (!validation_columns.empty() && !ValidateDocumentSchema(doc, validation_columns, schema_mode)) {
+		return false;
+	}
+	if (FlattenDocument(doc, columns, output, row_idx, schema_mode, true, scratch)) {
+		return true;
+	}
+	for (idx_t col_idx = 0; col_idx < columns.size(); col_idx++) {
+		ResetRowValidity(output.data[col_idx], row_idx);
+	}
+	return false;
+}
+
+bool FlattenDocument(const bsoncxx::document::view &doc, const std::vector<string> &column_names,
+                     const std::vector<LogicalType> &column_types, DataChunk &output, idx_t row_idx,
+                     const std::unordered_map<string, string> &column_name_to_mongo_path, SchemaMode schema_mode,
+                     bool has_explicit_schema) {
+	return FlattenDocument(doc, BuildColumnPlans(column_names, column_types, column_name_to_mongo_path), output,
+	                       row_idx, schema_mode, has_explicit_schema);
 }
 
 } // namespace duckdb
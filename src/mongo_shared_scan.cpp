@@ -0,0 +1,196 @@
+#include "mongo_shared_scan.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <chrono>
+
+namespace duckdb {
+
+// How often a waiting reader checks whether its query was interrupted
+static constexpr std::chrono::milliseconds SHARED_SCAN_WAIT_INTERVAL(100);
+// How long a reader waits for the slowest readers before detaching them
+static constexpr std::chrono::milliseconds SHARED_SCAN_DETACH_DELAY(1000);
+
+MongoSharedScan::MongoSharedScan(producer_t producer_p, idx_t max_buffered_chunks_p, bool ordered_p)
+    : producer(std::move(producer_p)), max_buffered_chunks(MaxValue<idx_t>(max_buffered_chunks_p, 1)),
+      ordered(ordered_p) {
+}
+
+bool MongoSharedScan::TryAddReader(idx_t connection_id, idx_t &reader) {
+	lock_guard<mutex> guard(lock);
+	if (first_chunk > 0 || error || (started && !ordered)) {
+		return false;
+	}
+	for (auto &entry : readers) {
+		if (entry.second.connection_id == connection_id) {
+			return false;
+		}
+	}
+	reader = next_reader++;
+	readers[reader] = Reader {connection_id, 0, document_id_t(), false};
+	return true;
+}
+
+void MongoSharedScan::RemoveReader(idx_t reader) {
+	lock_guard<mutex> guard(lock);
+	readers.erase(reader);
+	ReleaseReadChunks();
+	changed.notify_all();
+}
+
+bool MongoSharedScan::ReleaseReadChunks() {
+	idx_t min_position = first_chunk + chunks.size();
+	for (auto &entry : readers) {
+		if (!entry.second.detached) {
+			min_position = MinValue<idx_t>(min_position, entry.second.position);
+		}
+	}
+	bool released = false;
+	while (first_chunk < min_position && (first_chunk > 0 || chunks.size() >= max_buffered_chunks)) {
+		chunks.pop_front();
+		chunk_last_ids.pop_front();
+		first_chunk++;
+		released = true;
+	}
+	return released;
+}
+
+bool MongoSharedScan::DetachSlowestReaders(idx_t reader) {
+	idx_t min_position = first_chunk + chunks.size();
+	for (auto &entry : readers) {
+		if (entry.first != reader && !entry.second.detached) {
+			min_position = MinValue<idx_t>(min_position, entry.second.position);
+		}
+	}
+	bool detached = false;
+	for (auto &entry : readers) {
+		if (entry.first != reader && !entry.second.detached && entry.second.position == min_position) {
+			entry.second.detached = true;
+			detached = true;
+		}
+	}
+	return detached;
+}
+
+shared_ptr<DataChunk> MongoSharedScan::Next(ClientContext &context, idx_t reader, bool &detached,
+                                            document_id_t &resume_after) {
+	unique_lock<mutex> guard(lock);
+	detached = false;
+	// Whether, and since when, this reader waits for the slowest readers
+	bool blocked = false;
+	std::chrono::steady_clock::time_point blocked_since;
+	while (true) {
+		auto &state = readers[reader];
+		if (state.detached) {
+			detached = true;
+			resume_after = state.last_id;
+			return nullptr;
+		}
+		auto &position = state.position;
+		if (position < first_chunk + chunks.size()) {
+			auto chunk = chunks[position - first_chunk];
+			state.last_id = chunk_last_ids[position - first_chunk];
+			position++;
+			if (ReleaseReadChunks()) {
+				changed.notify_all();
+			}
+			return chunk;
+		}
+		if (error) {
+			std::rethrow_exception(error);
+		}
+		if (exhausted) {
+			return nullptr;
+		}
+		if (chunks.size() >= max_buffered_chunks && !ReleaseReadChunks() && !producing) {
+			auto now = std::chrono::steady_clock::now();
+			if (!blocked) {
+				blocked = true;
+				blocked_since = now;
+			} else if (now - blocked_since >= SHARED_SCAN_DETACH_DELAY) {
+				// The slowest readers did not catch up: rather than stalling everyone (their results may not be
+				// fetched at all), they continue on their own cursors
+				if (DetachSlowestReaders(reader)) {
+					ReleaseReadChunks();
+					changed.notify_all();
+				}
+				blocked = false;
+			}
+		} else {
+			blocked = false;
+		}
+		if (!producing && chunks.size() < max_buffered_chunks) {
+			// Detaching readers needs an _id ordered cursor, only worth its cost with more than one reader
+			if (!started) {
+				started = true;
+				ordered = ordered || readers.size() > 1;
+			}
+			// Decode the next chunk outside the lock, so readers behind can keep reading buffered chunks
+			producing = true;
+			auto sort_by_id = ordered;
+			guard.unlock();
+			unique_ptr<DataChunk> chunk;
+			document_id_t last_id;
+			bool reader_error = false;
+			std::exception_ptr produce_error;
+			try {
+				chunk = producer(context, sort_by_id, last_id, reader_error);
+			} catch (...) {
+				produce_error = std::current_exception();
+			}
+			guard.lock();
+			producing = false;
+			if (produce_error && reader_error) {
+				// The next reader that needs the chunk produces it
+				changed.notify_all();
+				std::rethrow_exception(produce_error);
+			}
+			if (produce_error) {
+				error = produce_error;
+			} else if (!chunk) {
+				exhausted = true;
+			} else {
+				chunks.push_back(shared_ptr<DataChunk>(std::move(chunk)));
+				chunk_last_ids.push_back(std::move(last_id));
+			}
+			changed.notify_all();
+			continue;
+		}
+		// Another reader is producing the chunk, or the slowest reader is max_buffered_chunks behind
+		changed.wait_for(guard, SHARED_SCAN_WAIT_INTERVAL);
+		if (context.interrupted) {
+			throw InterruptException();
+		}
+	}
+}
+
+MongoSharedScanRegistry &MongoSharedScanRegistry::Get() {
+	static MongoSharedScanRegistry registry;
+	return registry;
+}
+
+shared_ptr<MongoSharedScan>
+MongoSharedScanRegistry::Attach(const std::string &key, idx_t connection_id,
+                                const std::function<MongoSharedScan::producer_t()> &create_producer,
+                                idx_t max_buffered_chunks, bool ordered, idx_t &reader) {
+	lock_guard<mutex> guard(lock);
+	for (auto it = scans.begin(); it != scans.end();) {
+		if (it->second.expired()) {
+			it = scans.erase(it);
+		} else {
+			++it;
+		}
+	}
+	auto entry = scans.find(key);
+	if (entry != scans.end()) {
+		auto scan = entry->second.lock();
+		if (scan && scan->TryAddReader(connection_id, reader)) {
+			return scan;
+		}
+	}
+	auto scan = make_shared_ptr<MongoSharedScan>(create_producer(), max_buffered_chunks, ordered);
+	scan->TryAddReader(connection_id, reader);
+	scans[key] = weak_ptr<MongoSharedScan>(scan);
+	return scan;
+}
+
+} // namespace duckdb
@@ -3,6 +3,7 @@
 #include "mongo_filter_pushdown.hpp"
 #include "mongo_compat.hpp"
 #include "mongo_secrets.hpp"
+#include "mongo_partition_summary.hpp"
 #include "duckdb/common/types/timestamp.hpp"
 #include "duckdb/common/types/date.hpp"
 #include "duckdb/common/types/time.hpp"
@@ -25,6 +26,7 @@
 #include "duckdb/planner/expression/bound_constant_expression.hpp"
 #include "duckdb/planner/expression/bound_cast_expression.hpp"
 #include "duckdb/planner/expression/bound_operator_expression.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
 #include "duckdb/planner/operator/logical_get.hpp"
 #include "duckdb/optimizer/column_lifetime_analyzer.hpp"
 #include <bsoncxx/builder/basic/document.hpp>
@@ -32,8 +34,11 @@
 #include <bsoncxx/json.hpp>
 #include <mongocxx/pipeline.hpp>
 #include <mongocxx/options/aggregate.hpp>
+#include <mongocxx/exception/operation_exception.hpp>
 #include <algorithm>
+#include <future>
 #include <sstream>
+#include <thread>
 #include <cctype>
 #include <iostream>
 #include <map>
@@ -42,6 +47,19 @@
 
 namespace duckdb {
 
+static constexpr const char *DECODE_THREADS_SETTING = "mongo_decode_threads";
+static constexpr const char *LATE_MATERIALIZATION_SETTING = "mongo_late_materialization";
+static constexpr const char *SHARED_SCANS_SETTING = "mongo_shared_scans";
+static constexpr const char *SHARED_SCAN_BUFFER_SETTING = "mongo_shared_scan_buffer";
+static constexpr int64_t DEFAULT_SHARED_SCAN_BUFFER = 8;
+static constexpr const char *BATCH_SIZE_SETTING = "mongo_batch_size";
+static constexpr const char *NATIVE_CURSOR_SETTING = "mongo_native_cursor";
+static constexpr int64_t DEFAULT_PARTITION_COUNT = 64;
+// How often a throttled scan checks whether its query was interrupted while it waits
+static constexpr std::chrono::milliseconds THROTTLE_WAIT_INTERVAL(100);
+// How far over its rate limits a throttled scan reads before it ends the chunk and waits
+static constexpr std::chrono::milliseconds THROTTLE_CHUNK_DEBT(10);
+
 InsertionOrderPreservingMap<string> MongoScanToString(TableFunctionToStringInput &input) {
 	InsertionOrderPreservingMap<string> result;
 	if (!input.bind_data) {
@@ -68,6 +86,60 @@ InsertionOrderPreservingMap<string> MongoScanToString(TableFunctionToStringInput
 		if (!data.complex_filter_expr.view().empty()) {
 			result["expr"] = bsoncxx::to_json(data.complex_filter_expr.view());
 		}
+		if (!data.map_filter_query.view().empty()) {
+			result["map_filter"] = bsoncxx::to_json(data.map_filter_query.view());
+		}
+		if (!data.schema_type_filter.view().empty()) {
+			result["schema_filter"] = bsoncxx::to_json(data.schema_type_filter.view());
+		}
+	}
+	auto conversions = GetServerTypeConversions(data);
+	if (!conversions.empty()) {
+		vector<string> converted;
+		for (auto &conversion : conversions) {
+			converted.push_back(conversion.first + " -> " + conversion.second);
+		}
+		std::sort(converted.begin(), converted.end());
+		result["server_converted"] = StringUtil::Join(converted, ", ");
+	}
+	if (data.decode_threads > 1) {
+		result["decode_threads"] = std::to_string(data.decode_threads);
+	}
+	if (data.late_filter && data.pipeline_json.empty()) {
+		vector<string> late_columns;
+		for (auto col_idx : data.late_filter_columns) {
+			late_columns.push_back(data.column_names[col_idx]);
+		}
+		result["late_filter_columns"] = StringUtil::Join(late_columns, ", ");
+	}
+	if (data.shared_scans && data.pipeline_json.empty()) {
+		result["shared_scans"] = "true";
+	}
+	if (data.max_docs_per_second > 0) {
+		result["max_docs_per_second"] = std::to_string(data.max_docs_per_second);
+	}
+	if (data.max_bytes_per_second > 0) {
+		result["max_bytes_per_second"] = std::to_string(data.max_bytes_per_second);
+	}
+	if (data.batch_size > 0) {
+		result["batch_size"] = std::to_string(data.batch_size);
+	}
+	if (data.native_cursor && data.pipeline_json.empty()) {
+		result["native_cursor"] = "true";
+	}
+	if (data.sort_by_id != 0 && data.pipeline_json.empty()) {
+		result["sort"] = data.sort_by_id > 0 ? "_id ASC" : "_id DESC";
+	}
+	if (!data.partition_summary_paths.empty() && data.pipeline_json.empty()) {
+		result["partition_summary"] = StringUtil::Join(data.partition_summary_paths, ", ");
+	}
+	if (!data.computed_columns.empty() && data.pipeline_json.empty()) {
+		vector<string> computed;
+		for (auto &column : data.computed_columns) {
+			computed.push_back(column.first + ": " + bsoncxx::to_json(column.second.view()));
+		}
+		std::sort(computed.begin(), computed.end());
+		result["computed"] = StringUtil::Join(computed, ", ");
 	}
 	return result;
 }
@@ -116,29 +188,202 @@ unique_ptr<FunctionData> MongoScanBind(ClientContext &context, TableFunctionBind
 		result->sample_size = input.named_parameters["sample_size"].GetValue<int64_t>();
 	}
 
+	// Schema inference limits for wide or deeply nested documents
+	auto &inference_options = result->inference_options;
+	if (input.named_parameters.find("max_depth") != input.named_parameters.end()) {
+		auto max_depth = input.named_parameters["max_depth"].GetValue<int64_t>();
+		if (max_depth < 0 || max_depth > NumericLimits<int32_t>::Maximum()) {
+			throw BinderException("mongo_scan \"max_depth\" must be a non-negative integer");
+		}
+		inference_options.max_depth = NumericCast<int>(max_depth);
+	}
+	if (input.named_parameters.find("max_fields_per_level") != input.named_parameters.end()) {
+		auto max_fields = input.named_parameters["max_fields_per_level"].GetValue<int64_t>();
+		if (max_fields < 0) {
+			throw BinderException("mongo_scan \"max_fields_per_level\" must be a non-negative integer");
+		}
+		inference_options.max_fields_per_level = NumericCast<idx_t>(max_fields);
+	}
+	if (input.named_parameters.find("map_key_threshold") != input.named_parameters.end()) {
+		auto map_key_threshold = input.named_parameters["map_key_threshold"].GetValue<int64_t>();
+		if (map_key_threshold < 0) {
+			throw BinderException("mongo_scan \"map_key_threshold\" must be a non-negative integer");
+		}
+		inference_options.map_key_threshold = NumericCast<idx_t>(map_key_threshold);
+	}
+	if (input.named_parameters.find("include_paths") != input.named_parameters.end()) {
+		auto &paths_value = input.named_parameters["include_paths"];
+		if (!paths_value.IsNull()) {
+			for (auto &path : ListValue::GetChildren(paths_value)) {
+				if (path.IsNull() || path.GetValue<string>().empty()) {
+					throw BinderException("mongo_scan \"include_paths\" must not contain empty paths");
+				}
+				inference_options.include_paths.push_back(path.GetValue<string>());
+			}
+		}
+		// A path inside another listed path collides with it in the projection: only the parent is kept
+		auto &paths = inference_options.include_paths;
+		sort(paths.begin(), paths.end());
+		paths.erase(unique(paths.begin(), paths.end()), paths.end());
+		vector<string> collapsed;
+		for (auto &path : paths) {
+			bool nested = false;
+			for (auto &parent : paths) {
+				nested = nested || StringUtil::StartsWith(path, parent + ".");
+			}
+			if (!nested) {
+				collapsed.push_back(path);
+			}
+		}
+		paths = std::move(collapsed);
+	}
+
 	// Parse schema_mode parameter
 	if (input.named_parameters.find("schema_mode") != input.named_parameters.end()) {
 		result->schema_mode = ParseSchemaMode(input.named_parameters["schema_mode"].GetValue<string>());
 	}
 
+	if (input.named_parameters.find("type_coercion") != input.named_parameters.end()) {
+		auto coercion = StringUtil::Lower(input.named_parameters["type_coercion"].GetValue<string>());
+		if (coercion != "client" && coercion != "server") {
+			throw BinderException("mongo_scan \"type_coercion\" must be 'client' or 'server', got '%s'", coercion);
+		}
+		result->server_type_coercion = coercion == "server";
+	}
+
+	// Parallel decode of a single cursor: the decode_threads parameter overrides mongo_decode_threads
+	Value decode_threads_value;
+	int64_t decode_threads = 1;
+	if (input.named_parameters.find("decode_threads") != input.named_parameters.end()) {
+		decode_threads = input.named_parameters["decode_threads"].GetValue<int64_t>();
+	} else if (context.TryGetCurrentSetting(DECODE_THREADS_SETTING, decode_threads_value) &&
+	           !decode_threads_value.IsNull()) {
+		decode_threads = decode_threads_value.GetValue<int64_t>();
+	}
+	if (decode_threads < 1) {
+		throw BinderException("mongo_scan \"decode_threads\" must be at least 1");
+	}
+	result->decode_threads = NumericCast<idx_t>(decode_threads);
+
+	// Decode-time evaluation of the filters DuckDB keeps: the late_materialization parameter overrides
+	// mongo_late_materialization
+	Value late_materialization_value;
+	if (input.named_parameters.find("late_materialization") != input.named_parameters.end()) {
+		result->late_materialization = input.named_parameters["late_materialization"].GetValue<bool>();
+	} else if (context.TryGetCurrentSetting(LATE_MATERIALIZATION_SETTING, late_materialization_value) &&
+	           !late_materialization_value.IsNull()) {
+		result->late_materialization = late_materialization_value.GetValue<bool>();
+	}
+
+	// Shared scans: the shared_scans parameter overrides mongo_shared_scans
+	Value shared_scans_value;
+	if (input.named_parameters.find("shared_scans") != input.named_parameters.end()) {
+		result->shared_scans = input.named_parameters["shared_scans"].GetValue<bool>();
+	} else if (context.TryGetCurrentSetting(SHARED_SCANS_SETTING, shared_scans_value) &&
+	           !shared_scans_value.IsNull()) {
+		result->shared_scans = shared_scans_value.GetValue<bool>();
+	}
+	Value shared_scan_buffer_value;
+	int64_t shared_scan_buffer = DEFAULT_SHARED_SCAN_BUFFER;
+	if (context.TryGetCurrentSetting(SHARED_SCAN_BUFFER_SETTING, shared_scan_buffer_value) &&
+	    !shared_scan_buffer_value.IsNull()) {
+		shared_scan_buffer = shared_scan_buffer_value.GetValue<int64_t>();
+	}
+	if (result->shared_scans) {
+		if (shared_scan_buffer < 1) {
+			throw InvalidInputException("mongo_shared_scan_buffer must be at least 1");
+		}
+		result->shared_scan_buffer = NumericCast<idx_t>(shared_scan_buffer);
+	}
+
+	// Bandwidth limits for background scans (0 = unlimited)
+	if (input.named_parameters.find("max_docs_per_second") != input.named_parameters.end()) {
+		auto max_docs_per_second = input.named_parameters["max_docs_per_second"].GetValue<int64_t>();
+		if (max_docs_per_second < 0) {
+			throw BinderException("mongo_scan \"max_docs_per_second\" must not be negative");
+		}
+		result->max_docs_per_second = NumericCast<idx_t>(max_docs_per_second);
+	}
+	if (input.named_parameters.find("max_bytes_per_second") != input.named_parameters.end()) {
+		auto max_bytes_per_second = input.named_parameters["max_bytes_per_second"].GetValue<int64_t>();
+		if (max_bytes_per_second < 0) {
+			throw BinderException("mongo_scan \"max_bytes_per_second\" must not be negative");
+		}
+		result->max_bytes_per_second = NumericCast<idx_t>(max_bytes_per_second);
+	}
+
+	// Server reply batch size: the batch_size parameter overrides mongo_batch_size
+	Value batch_size_value;
+	int64_t batch_size = 0;
+	if (input.named_parameters.find("batch_size") != input.named_parameters.end()) {
+		batch_size = input.named_parameters["batch_size"].GetValue<int64_t>();
+	} else if (context.TryGetCurrentSetting(BATCH_SIZE_SETTING, batch_size_value) && !batch_size_value.IsNull()) {
+		batch_size = batch_size_value.GetValue<int64_t>();
+	}
+	if (batch_size < 0 || batch_size > NumericLimits<int32_t>::Maximum()) {
+		throw BinderException("mongo_scan \"batch_size\" must be a non-negative 32-bit integer");
+	}
+	result->batch_size = NumericCast<idx_t>(batch_size);
+
+	// libmongoc find cursors: the native_cursor parameter overrides mongo_native_cursor
+	Value native_cursor_value;
+	if (input.named_parameters.find("native_cursor") != input.named_parameters.end()) {
+		result->native_cursor = input.named_parameters["native_cursor"].GetValue<bool>();
+	} else if (context.TryGetCurrentSetting(NATIVE_CURSOR_SETTING, native_cursor_value) &&
+	           !native_cursor_value.IsNull()) {
+		result->native_cursor = native_cursor_value.GetValue<bool>();
+	}
+
 	// Ensure MongoDB instance is initialized
 	GetMongoInstance();
 
 	// Create connection
 	result->connection = make_shared_ptr<MongoConnection>(result->connection_string);
 
-	// Get collection
-	auto db = result->connection->client[result->database_name];
-	auto collection = db[result->collection_name];
+	bool has_columns_parameter = input.named_parameters.find("columns") != input.named_parameters.end();
+	// Opt-in: fields a validator doesn't describe would be missing from the schema, where sampling finds them
+	bool use_validator = false;
+	if (input.named_parameters.find("use_validator") != input.named_parameters.end()) {
+		use_validator = input.named_parameters["use_validator"].GetValue<bool>();
+	}
+
+	// The metadata requests behind the explicit schema sources and the sample are independent, so they are issued
+	// concurrently on pooled clients: the __schema lookup (and the validator lookup) on other threads while this one
+	// samples, one round trip of latency instead of one per source. The sample is discarded when a schema is found.
+	std::future<bsoncxx::stdx::optional<bsoncxx::document::value>> atlas_schema_future;
+	std::future<bsoncxx::stdx::optional<bsoncxx::document::value>> collection_info_future;
+	std::vector<bsoncxx::document::value> sample;
+	if (!has_columns_parameter) {
+		auto pool = GetMongoClientPool(result->connection_string);
+		auto database_name = result->database_name;
+		auto collection_name = result->collection_name;
+		atlas_schema_future = std::async(std::launch::async, [pool, database_name, collection_name]() {
+			auto client = pool->acquire();
+			auto collection = (*client)[database_name][collection_name];
+			return FetchAtlasSchemaDocument(collection);
+		});
+		if (use_validator) {
+			collection_info_future = std::async(std::launch::async, [pool, database_name, collection_name]() {
+				auto client = pool->acquire();
+				auto database = (*client)[database_name];
+				return FetchCollectionInfo(database, collection_name);
+			});
+		}
+		auto client = pool->acquire();
+		auto collection = (*client)[database_name][collection_name];
+		sample = SampleDocuments(collection, result->sample_size, result->inference_options);
+	}
 
 	// Schema resolution priority:
 	// 1. User-provided columns parameter (highest priority)
 	// 2. __schema document in collection (for Atlas SQL customers)
-	// 3. Infer from documents (fallback)
+	// 3. $jsonSchema collection validator
+	// 4. Infer from documents (fallback)
 	bool schema_set = false;
+	bool schema_inferred = false;
 
 	// Check for user-provided columns parameter
-	if (input.named_parameters.find("columns") != input.named_parameters.end()) {
+	if (has_columns_parameter) {
 		ParseSchemaFromColumnsParameter(context, input.named_parameters["columns"], result->column_names,
 		                                result->column_types, result->column_name_to_mongo_path);
 		schema_set = true;
@@ -147,22 +392,79 @@ unique_ptr<FunctionData> MongoScanBind(ClientContext &context, TableFunctionBind
 
 	// If no user-provided schema, check for __schema document (Atlas SQL)
 	if (!schema_set) {
-		schema_set = ParseSchemaFromAtlasDocument(context, collection, result->column_names, result->column_types,
-		                                          result->column_name_to_mongo_path);
+		auto schema_doc = atlas_schema_future.get();
+		if (schema_doc) {
+			schema_set = ParseSchemaFromAtlasDocument(context, schema_doc->view(), result->column_names,
+			                                          result->column_types, result->column_name_to_mongo_path);
+		}
 		if (schema_set) {
 			result->has_explicit_schema = true; // Explicit schema via __schema document
 		}
 	}
 
+	// Next, use the collection's $jsonSchema validator (exact, no sampling needed)
+	if (!schema_set && collection_info_future.valid()) {
+		auto collection_info = collection_info_future.get();
+		bool validator_enforced = false;
+		if (collection_info) {
+			schema_set = ParseSchemaFromJsonSchemaValidator(
+			    collection_info->view(), inference_options.max_depth, result->column_names, result->column_types,
+			    result->column_name_to_mongo_path, validator_enforced, result->objectid_columns);
+		}
+		if (schema_set) {
+			// Only a validator the server enforces guarantees the types, like an explicit schema
+			result->has_explicit_schema = validator_enforced;
+		}
+	}
+
 	// If still no schema, infer from documents
 	if (!schema_set) {
-		InferSchemaFromDocuments(collection, result->sample_size, result->column_names, result->column_types,
-		                         result->column_name_to_mongo_path);
+		InferSchemaFromSample(sample, result->column_names, result->column_types, result->column_name_to_mongo_path,
+		                      result->inference_options, &result->conflicted_columns);
+		result->sampled_paths = result->inference_options.include_paths;
+		schema_inferred = true;
 	}
 
-	// Probe one document to discover which fields are actual BSON ObjectIds.
+	// Discover which fields are actual BSON ObjectIds from the sample.
 	// This avoids the heuristic of guessing by column name during filter pushdown.
-	DetectObjectIdColumns(collection, result->objectid_columns);
+	// Schemas that were not inferred probe one document.
+	if (schema_inferred) {
+		CollectObjectIdColumns(sample, result->objectid_columns);
+	} else {
+		auto db = result->connection->client[result->database_name];
+		auto collection = db[result->collection_name];
+		DetectObjectIdColumns(collection, result->objectid_columns);
+	}
+
+	if (result->has_explicit_schema && result->schema_mode == SchemaMode::DROPMALFORMED) {
+		result->schema_type_filter =
+		    BuildSchemaTypeFilter(result->column_names, result->column_types, result->column_name_to_mongo_path,
+		                          result->schema_type_filter_exact);
+	}
+
+	// Zone map over _id ranges: the partition_summary fields are column names (or MongoDB paths)
+	if (input.named_parameters.find("partition_summary") != input.named_parameters.end()) {
+		auto &fields_value = input.named_parameters["partition_summary"];
+		if (!fields_value.IsNull()) {
+			for (auto &field : ListValue::GetChildren(fields_value)) {
+				if (field.IsNull() || field.GetValue<string>().empty()) {
+					throw BinderException("mongo_scan \"partition_summary\" must not contain empty field names");
+				}
+				auto name = field.GetValue<string>();
+				auto path_it = result->column_name_to_mongo_path.find(name);
+				result->partition_summary_paths.push_back(
+				    path_it != result->column_name_to_mongo_path.end() ? path_it->second : name);
+			}
+		}
+	}
+	int64_t partition_count = DEFAULT_PARTITION_COUNT;
+	if (input.named_parameters.find("partition_count") != input.named_parameters.end()) {
+		partition_count = input.named_parameters["partition_count"].GetValue<int64_t>();
+	}
+	if (partition_count < 1 || partition_count > NumericLimits<int32_t>::Maximum()) {
+		throw BinderException("mongo_scan \"partition_count\" must be a positive 32-bit integer");
+	}
+	result->partition_count = NumericCast<idx_t>(partition_count);
 
 	// Set return types and names
 	return_types = result->column_types;
@@ -171,9 +473,95 @@ unique_ptr<FunctionData> MongoScanBind(ClientContext &context, TableFunctionBind
 	return std::move(result);
 }
 
+// $convert target for a column type ("" when the type is not converted)
+static string MongoConvertTargetType(const LogicalType &type) {
+	switch (type.id()) {
+	case LogicalTypeId::VARCHAR:
+		return "string";
+	case LogicalTypeId::BIGINT:
+		return "long";
+	case LogicalTypeId::DOUBLE:
+		return "double";
+	case LogicalTypeId::BOOLEAN:
+		return "bool";
+	case LogicalTypeId::DATE:
+	case LogicalTypeId::TIMESTAMP:
+		return "date";
+	default:
+		return "";
+	}
+}
+
+// Whether the server converts column `col_idx`, with its MongoDB path and $convert target type
+static bool GetServerTypeConversion(const MongoScanData &data, idx_t col_idx, string &mongo_path, string &to) {
+	auto &column_name = data.column_names[col_idx];
+	if (!data.server_type_coercion || data.conflicted_columns.find(column_name) == data.conflicted_columns.end()) {
+		return false;
+	}
+	to = MongoConvertTargetType(data.column_types[col_idx]);
+	auto path_it = data.column_name_to_mongo_path.find(column_name);
+	mongo_path = path_it != data.column_name_to_mongo_path.end() ? path_it->second : column_name;
+	// _id can't be replaced by an expression, and field paths can't start with '$'
+	return !to.empty() && mongo_path != "_id" && !mongo_path.empty() && mongo_path[0] != '$';
+}
+
+unordered_map<string, string> GetServerTypeConversions(const MongoScanData &data) {
+	unordered_map<string, string> conversions;
+	for (idx_t col_idx = 0; col_idx < data.column_names.size(); col_idx++) {
+		string mongo_path;
+		string to;
+		if (GetServerTypeConversion(data, col_idx, mongo_path, to)) {
+			conversions[mongo_path] = to;
+		}
+	}
+	return conversions;
+}
+
+unordered_set<string> GetServerConvertedColumns(const MongoScanData &data) {
+	unordered_set<string> columns;
+	for (idx_t col_idx = 0; col_idx < data.column_names.size(); col_idx++) {
+		string mongo_path;
+		string to;
+		if (GetServerTypeConversion(data, col_idx, mongo_path, to)) {
+			columns.insert(data.column_names[col_idx]);
+		}
+	}
+	return columns;
+}
+
+bsoncxx::document::value BuildMongoConvertExpression(const std::string &mongo_path, const std::string &to) {
+	using bsoncxx::builder::basic::kvp;
+	auto field = "$" + mongo_path;
+	bsoncxx::builder::basic::document convert;
+	convert.append(kvp("input", field));
+	convert.append(kvp("to", to));
+	convert.append(kvp("onError", field));
+	auto converted = bsoncxx::builder::basic::make_document(kvp("$convert", convert.extract()));
+	if (to != "string") {
+		return converted;
+	}
+	// Only types whose text matches the client's (WriteVarchar) are converted: the server writes doubles and dates
+	// differently, and strings need no conversion
+	bsoncxx::builder::basic::array types;
+	for (auto type : {"int", "long", "bool", "objectId"}) {
+		types.append(type);
+	}
+	bsoncxx::builder::basic::array in_args;
+	in_args.append(bsoncxx::builder::basic::make_document(kvp("$type", field)));
+	in_args.append(types.extract());
+	bsoncxx::builder::basic::array cond_args;
+	cond_args.append(bsoncxx::builder::basic::make_document(kvp("$in", in_args.extract())));
+	cond_args.append(converted.view());
+	cond_args.append(field);
+	return bsoncxx::builder::basic::make_document(kvp("$cond", cond_args.extract()));
+}
+
 bsoncxx::document::value BuildMongoProjection(const vector<column_t> &column_ids,
                                               const vector<string> &all_column_names,
-                                              const unordered_map<string, string> &column_name_to_mongo_path) {
+                                              const unordered_map<string, string> &column_name_to_mongo_path,
+                                              const unordered_map<string, string> &convert_to,
+                                              const unordered_map<string, bsoncxx::document::value> &computed,
+                                              const vector<string> &sampled_paths) {
 	// Collect all MongoDB paths for requested columns
 	vector<string> mongo_paths;
 	bool has_id = false;
@@ -205,7 +593,17 @@ bsoncxx::document::value BuildMongoProjection(const vector<column_t> &column_ids
 			has_id = true;
 		}
 
-		mongo_paths.push_back(mongo_path);
+		// A column above sampled subtrees holds only them, as in the sample its type was inferred from
+		bool above_sampled = false;
+		for (auto &sampled_path : sampled_paths) {
+			if (StringUtil::StartsWith(sampled_path, mongo_path + ".")) {
+				mongo_paths.push_back(sampled_path);
+				above_sampled = true;
+			}
+		}
+		if (!above_sampled) {
+			mongo_paths.push_back(mongo_path);
+		}
 	}
 
 	// Sort paths to enable efficient prefix collapsing
@@ -265,7 +663,16 @@ bsoncxx::document::value BuildMongoProjection(const vector<column_t> &column_ids
 	vector<string> sorted_paths(collapsed_paths.begin(), collapsed_paths.end());
 	sort(sorted_paths.begin(), sorted_paths.end());
 	for (const string &path : sorted_paths) {
-		projection_builder.append(bsoncxx::builder::basic::kvp(path, 1));
+		auto convert_it = convert_to.find(path);
+		auto computed_it = computed.find(path);
+		if (convert_it != convert_to.end()) {
+			projection_builder.append(
+			    bsoncxx::builder::basic::kvp(path, BuildMongoConvertExpression(path, convert_it->second)));
+		} else if (computed_it != computed.end()) {
+			projection_builder.append(bsoncxx::builder::basic::kvp(path, computed_it->second.view()));
+		} else {
+			projection_builder.append(bsoncxx::builder::basic::kvp(path, 1));
+		}
 	}
 
 	// Include _id if it wasn't already included (MongoDB typically includes _id by default)
@@ -277,8 +684,156 @@ bsoncxx::document::value BuildMongoProjection(const vector<column_t> &column_ids
 	return projection_builder.extract();
 }
 
-unique_ptr<LocalTableFunctionState> MongoScanInitLocal(ExecutionContext &context, TableFunctionInitInput &input,
-                                                       GlobalTableFunctionState *global_state) {
+// Parses a JSON array of stages. `document` keeps the parsed stages alive for the lifetime of the cursor.
+static mongocxx::pipeline MongoParsePipeline(const string &pipeline_json, bsoncxx::document::value &document) {
+	// Parse JSON array pipeline by wrapping it in a document.
+	// Example input: '[{"$match":{"x":1}},{"$count":"count"}]'
+	auto wrapped = StringUtil::Format("{\"pipeline\": %s}", pipeline_json);
+	try {
+		document = bsoncxx::from_json(wrapped);
+	} catch (const std::exception &e) {
+		throw InvalidInputException("mongo_scan \"pipeline\" contains invalid JSON: %s", e.what());
+	}
+	auto pipeline_elem = document.view()["pipeline"];
+	if (!pipeline_elem || pipeline_elem.type() != bsoncxx::type::k_array) {
+		throw InvalidInputException("mongo_scan \"pipeline\" must be a JSON array of stage documents");
+	}
+
+	mongocxx::pipeline pipeline;
+	auto stages = pipeline_elem.get_array().value;
+	for (auto it = stages.begin(); it != stages.end(); ++it) {
+		if (it->type() != bsoncxx::type::k_document) {
+			throw InvalidInputException("mongo_scan \"pipeline\" stages must be JSON objects");
+		}
+		pipeline.append_stage(it->get_document().value);
+	}
+	return pipeline;
+}
+
+// Whether a command failed because a result document went over a size limit: BSONObjectTooLarge (10334), or the
+// $facet output limit of MongoDB 7.0+ (4031700)
+static bool MongoIsResultTooLarge(const mongocxx::operation_exception &e) {
+	auto code = e.code().value();
+	return code == 10334 || code == 4031700;
+}
+
+// Whether the cursor (mongocxx or native) points at a document
+static bool MongoScanCursorHasDocument(const MongoScanState &state) {
+	if (state.native_cursor) {
+		return state.native_cursor->HasDocument();
+	}
+	return state.current && state.end && *state.current != *state.end;
+}
+
+static bsoncxx::document::view MongoScanCursorDocument(const MongoScanState &state) {
+	if (state.native_cursor) {
+		return state.native_cursor->Document();
+	}
+	return **state.current;
+}
+
+// Releases the admission slot once the cursor is exhausted (the server closed it with the last batch), so that other
+// cursors, like the probe side of a join that reads the build side first, are not kept waiting until the query ends
+static void MongoScanReleaseExhaustedCursor(MongoScanState &state) {
+	if (state.cursor_slot && !MongoScanCursorHasDocument(state)) {
+		state.cursor_slot.reset();
+	}
+}
+
+// Admits a new cursor through the admission controller of its connection string, which may wait for other cursors
+// to finish
+static void MongoScanAdmitCursor(ClientContext &context, MongoScanState &state) {
+	if (!state.cursor_slot) {
+		state.cursor_slot = MongoAdmissionController::Get().Acquire(context, state.connection->connection_string,
+		                                                            state.admission_limits);
+	}
+}
+
+// Opens the cursor (the first batch is fetched by begin()), attributing the time to the server
+static void MongoScanOpenCursor(ClientContext &context, MongoScanState &state, mongocxx::cursor cursor) {
+	MongoScanAdmitCursor(context, state);
+	auto start = MongoQueryStats::clock_t::now();
+	state.cursor = make_uniq<mongocxx::cursor>(std::move(cursor));
+	state.current = make_uniq<mongocxx::cursor::iterator>(state.cursor->begin());
+	state.end = make_uniq<mongocxx::cursor::iterator>(state.cursor->end());
+	if (state.query_stats) {
+		state.query_stats->server_time += MongoQueryStats::clock_t::now() - start;
+	}
+	MongoScanReleaseExhaustedCursor(state);
+}
+
+// Opens a native find cursor: libmongoc sends the find command and returns the first document
+static void MongoScanOpenNativeCursor(ClientContext &context, MongoScanState &state,
+                                      const bsoncxx::document::view &query_filter) {
+	MongoScanAdmitCursor(context, state);
+	auto start = MongoQueryStats::clock_t::now();
+	state.native_cursor = make_uniq<MongoNativeCursor>(state.connection->connection_string, state.database_name,
+	                                                   state.collection_name, query_filter, state.find_options);
+	if (state.query_stats) {
+		state.query_stats->server_time += MongoQueryStats::clock_t::now() - start;
+	}
+	MongoScanReleaseExhaustedCursor(state);
+}
+
+static void MongoScanAdvanceCursorUntimed(MongoScanState &state) {
+	if (state.native_cursor) {
+		state.native_cursor->Advance();
+	} else {
+		++(*state.current);
+	}
+}
+
+// Advances the cursor; getMore round trips happen here, so the time is attributed to the server
+static void MongoScanAdvanceCursor(MongoScanState &state) {
+	if (!state.query_stats) {
+		MongoScanAdvanceCursorUntimed(state);
+	} else {
+		auto start = MongoQueryStats::clock_t::now();
+		MongoScanAdvanceCursorUntimed(state);
+		state.query_stats->server_time += MongoQueryStats::clock_t::now() - start;
+	}
+	MongoScanReleaseExhaustedCursor(state);
+}
+
+// Attributes the time of one MongoScanFunction call that was not spent in the cursor to the client
+struct MongoScanChunkTimer {
+	explicit MongoScanChunkTimer(MongoQueryStats *stats_p) : stats(stats_p) {
+		if (stats) {
+			start = MongoQueryStats::clock_t::now();
+			server_time_before = stats->server_time;
+		}
+	}
+	~MongoScanChunkTimer() {
+		if (stats) {
+			auto elapsed = MongoQueryStats::clock_t::now() - start;
+			stats->client_time += elapsed - (stats->server_time - server_time_before);
+		}
+	}
+
+	MongoQueryStats *stats;
+	MongoQueryStats::clock_t::time_point start;
+	MongoQueryStats::clock_t::duration server_time_before;
+};
+
+// Adds `extra` to the find filter as another conjunct
+static void MongoScanAndFilter(bsoncxx::document::view_or_value &query_filter, const bsoncxx::document::view &extra) {
+	if (extra.empty()) {
+		return;
+	}
+	if (query_filter.view().empty()) {
+		query_filter = bsoncxx::document::value(extra);
+		return;
+	}
+	bsoncxx::builder::basic::array and_terms;
+	and_terms.append(query_filter.view());
+	and_terms.append(extra);
+	bsoncxx::builder::basic::document and_query;
+	and_query.append(bsoncxx::builder::basic::kvp("$and", and_terms.extract()));
+	query_filter = and_query.extract();
+}
+
+// Resolves the projection and filters of a scan and opens its cursor
+static unique_ptr<MongoScanState> MongoScanOpen(ClientContext &context, TableFunctionInitInput &input) {
 	const auto &data = dynamic_cast<const MongoScanData &>(*input.bind_data);
 	auto result = make_uniq<MongoScanState>();
 
@@ -288,6 +843,9 @@ unique_ptr<LocalTableFunctionState> MongoScanInitLocal(ExecutionContext &context
 	result->collection_name = data.collection_name;
 	result->filter_query = data.filter_query;
 	result->pipeline_json = data.pipeline_json;
+	result->query_stats = MongoQueryStatsCreate(context, data.database_name, data.collection_name);
+	result->admission_limits = MongoAdmissionLimitsFromSettings(context);
+	result->use_native_cursor = data.native_cursor;
 
 	// Projection pushdown: collect columns needed (selected + filter columns that couldn't be pushed down)
 	unordered_set<idx_t> needed_column_indices;
@@ -336,33 +894,43 @@ unique_ptr<LocalTableFunctionState> MongoScanInitLocal(ExecutionContext &context
 			}
 		}
 
-		// Parse JSON array pipeline by wrapping it in a document.
-		// Example input: '[{"$match":{"x":1}},{"$count":"count"}]'
-		auto wrapped = StringUtil::Format("{\"pipeline\": %s}", result->pipeline_json);
-		try {
-			result->pipeline_document = bsoncxx::from_json(wrapped);
-		} catch (const std::exception &e) {
-			throw InvalidInputException("mongo_scan \"pipeline\" contains invalid JSON: %s", e.what());
-		}
-		auto pipeline_elem = result->pipeline_document.view()["pipeline"];
-		if (!pipeline_elem || pipeline_elem.type() != bsoncxx::type::k_array) {
-			throw InvalidInputException("mongo_scan \"pipeline\" must be a JSON array of stage documents");
+		auto pipeline = MongoParsePipeline(result->pipeline_json, result->pipeline_document);
+
+		if (result->query_stats) {
+			result->query_stats->entry.scan_method = "aggregate";
+			result->query_stats->entry.command = result->pipeline_json;
 		}
 
-		mongocxx::pipeline pipeline;
-		auto stages = pipeline_elem.get_array().value;
-		for (auto it = stages.begin(); it != stages.end(); ++it) {
-			if (it->type() != bsoncxx::type::k_document) {
-				throw InvalidInputException("mongo_scan \"pipeline\" stages must be JSON objects");
+		// $group and $sort stages (pushed-down aggregations, eager aggregation) spill to disk instead of failing
+		// at the 100 MB memory limit of a stage
+		mongocxx::options::aggregate agg_opts;
+		agg_opts.allow_disk_use(true);
+		if (data.batch_size > 0) {
+			agg_opts.batch_size(NumericCast<int32_t>(data.batch_size));
+		}
+		try {
+			MongoScanOpenCursor(context, *result, collection.aggregate(pipeline, agg_opts));
+		} catch (const mongocxx::operation_exception &e) {
+			if (data.facet_fallback_pipeline_json.empty() || !MongoIsResultTooLarge(e)) {
+				throw;
+			}
+			// The $facet output document is over the size limit: run its branches one after another instead
+			result->pipeline_json = data.facet_fallback_pipeline_json;
+			auto fallback = MongoParsePipeline(result->pipeline_json, result->pipeline_document);
+			if (result->query_stats) {
+				result->query_stats->entry.command = result->pipeline_json;
 			}
-			pipeline.append_stage(it->get_document().value);
+			MongoScanOpenCursor(context, *result, collection.aggregate(fallback, agg_opts));
 		}
+		return result;
+	}
 
-		mongocxx::options::aggregate agg_opts;
-		result->cursor = make_uniq<mongocxx::cursor>(collection.aggregate(pipeline, agg_opts));
-		result->current = make_uniq<mongocxx::cursor::iterator>(result->cursor->begin());
-		result->end = make_uniq<mongocxx::cursor::iterator>(result->cursor->end());
-		return std::move(result);
+	// Columns decoded ahead of the others to evaluate residual filters. The late filter's columns come first, so its
+	// references stay valid.
+	vector<idx_t> residual_columns;
+	if (data.late_filter) {
+		residual_columns = data.late_filter_columns;
+		result->late_filter = data.late_filter->Copy();
 	}
 
 	// Build query from pushed-down filters first to determine which filters were successfully pushed down
@@ -384,14 +952,20 @@ unique_ptr<LocalTableFunctionState> MongoScanInitLocal(ExecutionContext &context
 			auto it = filter_index_map.find(col_idx);
 			if (it != filter_index_map.end()) {
 				MongoSetFilter(*remapped_filters, it->second, MongoCopyFilter(filter));
+				// Join bounds are filled in while the query runs; the copies share that runtime data
+				if (IsPendingDynamicFilter(filter)) {
+					MongoSetFilter(*result->pending_dynamic_filters, it->second, MongoCopyFilter(filter));
+				}
 			}
 		});
 
 		// Only attempt conversion if we successfully remapped at least one filter
 		if (MongoHasFilters(*remapped_filters)) {
 			// Convert DuckDB filters to MongoDB query using remapped indices
-			auto mongo_filter = ConvertFiltersToMongoQuery(remapped_filters.get(), data.column_names, data.column_types,
-			                                               data.column_name_to_mongo_path, data.objectid_columns);
+			auto converted_columns = GetServerConvertedColumns(data);
+			auto mongo_filter =
+			    ConvertFiltersToMongoQuery(remapped_filters.get(), data.column_names, data.column_types,
+			                               data.column_name_to_mongo_path, data.objectid_columns, converted_columns);
 
 			// Check if filters were successfully pushed down (non-empty MongoDB query)
 			// If filters are pushed down to MongoDB, MongoDB filters server-side and we don't need filter columns
@@ -406,6 +980,30 @@ unique_ptr<LocalTableFunctionState> MongoScanInitLocal(ExecutionContext &context
 			filters_pushed_down = (filter_field_count > 0);
 
 			query_filter = std::move(mongo_filter);
+
+			// Filters the query doesn't fully express are applied by the scan to the decoded values
+			auto residual_filter_columns =
+			    GetResidualFilterColumns(*remapped_filters, data.column_names, data.column_types,
+			                             data.column_name_to_mongo_path, data.objectid_columns, converted_columns);
+			MongoForEachFilter(*remapped_filters, [&](idx_t col_idx, TableFilter &filter) {
+				if (std::find(residual_filter_columns.begin(), residual_filter_columns.end(), col_idx) ==
+				    residual_filter_columns.end()) {
+					return;
+				}
+				auto position = std::find(residual_columns.begin(), residual_columns.end(), col_idx);
+				if (position == residual_columns.end()) {
+					residual_columns.push_back(col_idx);
+					position = residual_columns.end() - 1;
+				}
+				BoundReferenceExpression column(data.column_types[col_idx], idx_t(position - residual_columns.begin()));
+				auto filter_expr = MongoFilterToExpression(filter, column);
+				if (result->residual_filter) {
+					result->residual_filter = make_uniq<BoundConjunctionExpression>(
+					    ExpressionType::CONJUNCTION_AND, std::move(result->residual_filter), std::move(filter_expr));
+				} else {
+					result->residual_filter = std::move(filter_expr);
+				}
+			});
 		} else {
 			// No filters could be remapped, so they can't be pushed down
 			filters_pushed_down = false;
@@ -445,6 +1043,11 @@ unique_ptr<LocalTableFunctionState> MongoScanInitLocal(ExecutionContext &context
 		query_filter = bsoncxx::builder::stream::document {} << bsoncxx::builder::stream::finalize;
 	}
 
+	// MAP key prefilter and DROPMALFORMED type checks. DuckDB (or the decode pass) still evaluates the original
+	// predicates, so filters_pushed_down is unchanged.
+	MongoScanAndFilter(query_filter, data.map_filter_query.view());
+	MongoScanAndFilter(query_filter, data.schema_type_filter.view());
+
 	// Add filter columns to projection only if filters weren't pushed down to MongoDB.
 	// Pushed-down filters are handled server-side, so we don't need those columns.
 	// Unpushed filters require columns for post-scan filtering in DuckDB.
@@ -527,6 +1130,13 @@ unique_ptr<LocalTableFunctionState> MongoScanInitLocal(ExecutionContext &context
 
 	// Build MongoDB find options
 	mongocxx::options::find opts;
+	if (data.batch_size > 0) {
+		opts.batch_size(NumericCast<int32_t>(data.batch_size));
+	}
+	if (data.sort_by_id != 0) {
+		// Served by the _id index; the scan is read by a single thread, so DuckDB keeps this order
+		opts.sort(bsoncxx::builder::basic::make_document(bsoncxx::builder::basic::kvp("_id", data.sort_by_id)));
+	}
 
 	// When schema enforcement is needed, ensure ALL schema columns are fetched from MongoDB
 	// so validation can check all columns, not just the ones DuckDB requested
@@ -549,12 +1159,31 @@ unique_ptr<LocalTableFunctionState> MongoScanInitLocal(ExecutionContext &context
 		}
 	}
 
-	// Build MongoDB projection from requested columns
-	if (!result->requested_column_indices.empty()) {
-		vector<column_t> projection_column_ids(result->requested_column_indices.begin(),
-		                                       result->requested_column_indices.end());
+	// Residual filters read batches of copied documents, decoding residual_columns first
+	if (result->residual_filter || result->late_filter) {
+		vector<string> residual_names;
+		vector<LogicalType> residual_types;
+		for (auto col_idx : residual_columns) {
+			residual_names.push_back(data.column_names[col_idx]);
+			residual_types.push_back(data.column_types[col_idx]);
+		}
+		result->residual_plans = BuildColumnPlans(residual_names, residual_types, data.column_name_to_mongo_path);
+		result->batched = true;
+	}
+
+	// Build MongoDB projection from requested columns (and the residual filter columns, which may not be requested)
+	vector<column_t> projection_column_ids(result->requested_column_indices.begin(),
+	                                       result->requested_column_indices.end());
+	for (auto col_idx : residual_columns) {
+		if (std::find(projection_column_ids.begin(), projection_column_ids.end(), col_idx) ==
+		    projection_column_ids.end()) {
+			projection_column_ids.push_back(col_idx);
+		}
+	}
+	if (!projection_column_ids.empty()) {
 		auto projection_doc =
-		    BuildMongoProjection(projection_column_ids, data.column_names, data.column_name_to_mongo_path);
+		    BuildMongoProjection(projection_column_ids, data.column_names, data.column_name_to_mongo_path,
+		                         GetServerTypeConversions(data), data.computed_columns, data.sampled_paths);
 
 		// Check if projection document has fields (empty means return all fields)
 		auto proj_view = projection_doc.view();
@@ -571,66 +1200,588 @@ unique_ptr<LocalTableFunctionState> MongoScanInitLocal(ExecutionContext &context
 	}
 
 	// LIMIT pushdown: Push constant LIMIT values to MongoDB
-	// Only works when LIMIT is directly above table scan (simple queries, not Q3/Q10 with joins)
-	if (input.op) {
+	// Only works when LIMIT is directly above table scan (simple queries, not Q3/Q10 with joins), and when the server
+	// evaluates every filter: the first documents it returns may all fail a residual filter
+	if (input.op && !result->residual_filter && !result->late_filter) {
+		optional_ptr<const BoundLimitNode> limit_val;
+		optional_ptr<const BoundLimitNode> offset_val;
 		if (input.op->type == PhysicalOperatorType::LIMIT) {
 			const auto &limit_op = input.op->Cast<PhysicalLimit>();
-			if (limit_op.limit_val.Type() == LimitNodeType::CONSTANT_VALUE) {
-				idx_t limit_value = limit_op.limit_val.GetConstantValue();
-				if (limit_value > 0 && limit_value < PhysicalLimit::MAX_LIMIT_VALUE) {
-					opts.limit(limit_value);
-					result->limit = limit_value;
-				}
-			}
+			limit_val = &limit_op.limit_val;
+			offset_val = &limit_op.offset_val;
 		} else if (input.op->type == PhysicalOperatorType::STREAMING_LIMIT) {
 			const auto &streaming_limit_op = input.op->Cast<PhysicalStreamingLimit>();
-			if (streaming_limit_op.limit_val.Type() == LimitNodeType::CONSTANT_VALUE) {
-				idx_t limit_value = streaming_limit_op.limit_val.GetConstantValue();
-				if (limit_value > 0 && limit_value < PhysicalLimit::MAX_LIMIT_VALUE) {
-					opts.limit(limit_value);
-					result->limit = limit_value;
-				}
+			limit_val = &streaming_limit_op.limit_val;
+			offset_val = &streaming_limit_op.offset_val;
+		}
+		// The server returns the first limit + offset documents; DuckDB skips the offset
+		if (limit_val && limit_val->Type() == LimitNodeType::CONSTANT_VALUE &&
+		    (offset_val->Type() == LimitNodeType::UNSET || offset_val->Type() == LimitNodeType::CONSTANT_VALUE)) {
+			idx_t limit_value = limit_val->GetConstantValue();
+			if (offset_val->Type() == LimitNodeType::CONSTANT_VALUE) {
+				limit_value += offset_val->GetConstantValue();
+			}
+			if (limit_value > 0 && limit_value < PhysicalLimit::MAX_LIMIT_VALUE) {
+				opts.limit(NumericCast<int64_t>(limit_value));
+				result->limit = limit_value;
 			}
 		}
 	}
 
+	// Zone map: only the _id ranges whose field summaries may match the query are read, and no cursor is opened when
+	// none may. Without a summary that is provably up to date, every document is read.
+	if (!data.partition_summary_paths.empty()) {
+		auto summary = MongoPartitionSummaryCache::Get().GetSummary(data.connection_string, data.database_name,
+		                                                            collection, data.partition_summary_paths,
+		                                                            data.partition_count);
+		if (summary) {
+			auto id_filter = bsoncxx::builder::basic::document {}.extract();
+			if (!MongoPrunePartitions(*summary, query_filter.view(), id_filter)) {
+				result->finished = true;
+				return result;
+			}
+			MongoScanAndFilter(query_filter, id_filter.view());
+		}
+	}
+
+	// The cursor is created by the first MongoScanFunction call (MongoScanStartCursor), once dynamic filters had a
+	// chance to be populated
+	result->find_filter = bsoncxx::document::value(query_filter.view());
+	result->find_options = opts;
+	result->cursor_pending = true;
+	return result;
+}
+
+static void MongoScanOpenFindCursor(ClientContext &context, MongoScanState &state,
+                                    const bsoncxx::document::view &query_filter) {
+	if (state.query_stats) {
+		state.query_stats->entry.scan_method = "find";
+		state.query_stats->entry.command = bsoncxx::to_json(query_filter);
+		if (!state.projection_document.view().empty()) {
+			state.query_stats->entry.projection = bsoncxx::to_json(state.projection_document.view());
+		}
+	}
+
+	if (state.use_native_cursor) {
+		MongoScanOpenNativeCursor(context, state, query_filter);
+		return;
+	}
 	// Create cursor with query filter and options (including projection if set)
-	result->cursor = make_uniq<mongocxx::cursor>(collection.find(query_filter, opts));
-	result->current = make_uniq<mongocxx::cursor::iterator>(result->cursor->begin());
-	result->end = make_uniq<mongocxx::cursor::iterator>(result->cursor->end());
+	auto collection = state.connection->client[state.database_name][state.collection_name];
+	MongoScanOpenCursor(context, state, collection.find(query_filter, state.find_options));
+}
+
+// Opens a deferred find cursor. Dynamic filters that were empty at init (hash join build-side bounds, complete once
+// the build pipeline has finished) are converted now and added to the query. Bounds that arrive after this point are
+// only applied by DuckDB: a Top-N boundary, set by a sink in the scan's own pipeline, is still empty here.
+static void MongoScanStartCursor(ClientContext &context, const MongoScanData &data, MongoScanState &state) {
+	if (!state.cursor_pending) {
+		return;
+	}
+	state.cursor_pending = false;
+	if (state.shared) {
+		lock_guard<mutex> guard(state.shared->lock);
+		MongoScanStartCursor(context, data, *state.shared->state);
+		return;
+	}
+
+	bsoncxx::document::view_or_value query_filter(state.find_filter.view());
+	if (MongoHasFilters(*state.pending_dynamic_filters)) {
+		auto dynamic_query =
+		    ConvertFiltersToMongoQuery(state.pending_dynamic_filters.get(), data.column_names, data.column_types,
+		                               data.column_name_to_mongo_path, data.objectid_columns,
+		                               GetServerConvertedColumns(data));
+		MongoScanAndFilter(query_filter, dynamic_query.view());
+	}
+
+	MongoScanOpenFindCursor(context, state, query_filter.view());
+}
+
+// A COUNT(*) pushed into a pipeline emits a single 0 row when the pipeline returns nothing, which only one thread
+// may do
+static bool MongoScanIsCountPipeline(const MongoScanData &data, const TableFunctionInitInput &input) {
+	if (data.pipeline_json.empty()) {
+		return false;
+	}
+	idx_t column_count = 0;
+	bool is_count = false;
+	for (column_t col_id : input.column_ids) {
+		if (col_id < VIRTUAL_COLUMN_START && col_id < data.column_names.size()) {
+			column_count++;
+			is_count = StringUtil::CIEquals(data.column_names[col_id], "count");
+		}
+	}
+	return column_count == 1 && is_count;
+}
+
+MongoScanThrottle::MongoScanThrottle(idx_t max_docs_per_second, idx_t max_bytes_per_second)
+    : docs_per_second(double(max_docs_per_second)), bytes_per_second(double(max_bytes_per_second)),
+      doc_tokens(docs_per_second), byte_tokens(bytes_per_second), last_refill(clock_t::now()) {
+}
+
+MongoScanThrottle::clock_t::time_point MongoScanThrottle::Consume(idx_t bytes) {
+	lock_guard<mutex> guard(lock);
+	auto now = clock_t::now();
+	double elapsed = std::chrono::duration<double>(now - last_refill).count();
+	last_refill = now;
+	double wait_seconds = 0;
+	if (docs_per_second > 0) {
+		doc_tokens = MinValue<double>(doc_tokens + elapsed * docs_per_second, docs_per_second) - 1;
+		wait_seconds = MaxValue<double>(wait_seconds, -doc_tokens / docs_per_second);
+	}
+	if (bytes_per_second > 0) {
+		byte_tokens = MinValue<double>(byte_tokens + elapsed * bytes_per_second, bytes_per_second) - double(bytes);
+		wait_seconds = MaxValue<double>(wait_seconds, -byte_tokens / bytes_per_second);
+	}
+	return now + std::chrono::duration_cast<clock_t::duration>(std::chrono::duration<double>(wait_seconds));
+}
+
+void MongoScanThrottle::Wait(ClientContext &context, clock_t::time_point until) {
+	while (true) {
+		auto now = clock_t::now();
+		if (now >= until) {
+			return;
+		}
+		if (context.interrupted) {
+			throw InterruptException();
+		}
+		std::this_thread::sleep_for(MinValue<clock_t::duration>(until - now, THROTTLE_WAIT_INTERVAL));
+	}
+}
+
+unique_ptr<GlobalTableFunctionState> MongoScanInitGlobal(ClientContext &context, TableFunctionInitInput &input) {
+	const auto &data = dynamic_cast<const MongoScanData &>(*input.bind_data);
+	auto result = make_uniq<MongoScanGlobalState>();
+	if (data.max_docs_per_second > 0 || data.max_bytes_per_second > 0) {
+		result->throttle = make_shared_ptr<MongoScanThrottle>(data.max_docs_per_second, data.max_bytes_per_second);
+	}
+	if (data.decode_threads > 1 && !MongoScanIsCountPipeline(data, input)) {
+		result->cursor = make_shared_ptr<MongoScanSharedCursor>();
+		result->cursor->state = MongoScanOpen(context, input);
+		result->cursor->state->throttle = result->throttle;
+		result->max_threads = data.decode_threads;
+	}
+	return std::move(result);
+}
+
+unique_ptr<LocalTableFunctionState> MongoScanInitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                       GlobalTableFunctionState *global_state) {
+	auto global = dynamic_cast<MongoScanGlobalState *>(global_state);
+	if (!global || !global->cursor) {
+		auto result = MongoScanOpen(context.client, input);
+		if (global) {
+			result->throttle = global->throttle;
+		}
+		return std::move(result);
+	}
 
+	// Decode worker: reads batches from the shared cursor, decodes the same columns as the cursor's owner
+	auto &owner = *global->cursor->state;
+	auto result = make_uniq<MongoScanState>();
+	result->shared = global->cursor;
+	result->connection = owner.connection;
+	result->database_name = owner.database_name;
+	result->collection_name = owner.collection_name;
+	result->filter_query = owner.filter_query;
+	result->pipeline_json = owner.pipeline_json;
+	result->limit = owner.limit;
+	result->requested_column_indices = owner.requested_column_indices;
+	result->requested_column_names = owner.requested_column_names;
+	result->requested_column_types = owner.requested_column_types;
+	// Workers wait for the rate limits their batches overdraw
+	result->throttle = global->throttle;
+	result->batched = true;
+	result->cursor_pending = true;
+	if (owner.residual_filter) {
+		result->residual_filter = owner.residual_filter->Copy();
+	}
+	if (owner.late_filter) {
+		result->late_filter = owner.late_filter->Copy();
+	}
+	result->residual_plans = owner.residual_plans;
+	if (owner.query_stats) {
+		// Worker-local timings (never logged themselves), added to the owner's entry when the worker finishes
+		result->query_stats = make_uniq<MongoQueryStats>();
+	}
 	return std::move(result);
 }
 
+MongoScanState::~MongoScanState() {
+	if (shared_scan) {
+		shared_scan->RemoveReader(shared_scan_reader);
+	}
+	if (!shared || !query_stats) {
+		return;
+	}
+	lock_guard<mutex> guard(shared->lock);
+	shared->state->query_stats->client_time += query_stats->client_time;
+}
+
+// Moves the cursor past the current document, counting it for the slow-query log
+static void MongoScanCursorNext(MongoScanState &state) {
+	auto length = MongoScanCursorDocument(state).length();
+	if (state.query_stats) {
+		state.query_stats->entry.documents++;
+		state.query_stats->entry.bytes += length;
+	}
+	if (state.cursor_slot) {
+		state.cursor_slot->AddDocument(length);
+	}
+	if (state.throttle) {
+		state.throttle_until = MaxValue(state.throttle_until, state.throttle->Consume(length));
+	}
+	MongoScanAdvanceCursor(state);
+}
+
+// Whether a throttled scan should end its chunk (after at least one document): reading the rest of a full chunk
+// over the rate limits would burst and then stall for as long
+static bool MongoScanThrottled(const MongoScanState &state) {
+	return state.throttle && state.throttle_until > MongoScanThrottle::clock_t::now() + THROTTLE_CHUNK_DEBT;
+}
+
+static void MongoScanNextDocument(MongoScanState &state) {
+	if (state.batched) {
+		state.batch_position++;
+		return;
+	}
+	MongoScanCursorNext(state);
+}
+
+// Copies up to STANDARD_VECTOR_SIZE documents out of the cursor of `source` into the batch of `target`
+static void MongoScanCopyBatch(MongoScanState &source, MongoScanState &target) {
+	while (target.batch_documents.size() < STANDARD_VECTOR_SIZE && MongoScanCursorHasDocument(source) &&
+	       (target.batch_documents.empty() || !MongoScanThrottled(source))) {
+		auto doc = MongoScanCursorDocument(source);
+		target.batch_documents.emplace_back(target.batch_data.size(), doc.length());
+		target.batch_data.insert(target.batch_data.end(), doc.data(), doc.data() + doc.length());
+		MongoScanCursorNext(source);
+	}
+	// The worker decoding the batch waits for the throttle, outside the lock of a shared cursor
+	target.throttle_until = MaxValue(target.throttle_until, source.throttle_until);
+}
+
+// Copies the next batch of documents out of the cursor. For a shared cursor, only the copy (and the getMore round
+// trips it triggers) happens under the lock; decoding happens in the calling worker.
+static bool MongoScanFetchBatch(MongoScanState &state) {
+	state.batch_data.clear();
+	state.batch_documents.clear();
+	state.batch_position = 0;
+	if (!state.shared) {
+		MongoScanCopyBatch(state, state);
+		return !state.batch_documents.empty();
+	}
+	auto start = MongoQueryStats::clock_t::now();
+	{
+		lock_guard<mutex> guard(state.shared->lock);
+		MongoScanCopyBatch(*state.shared->state, state);
+	}
+	if (state.query_stats) {
+		state.query_stats->server_time += MongoQueryStats::clock_t::now() - start;
+	}
+	return !state.batch_documents.empty();
+}
+
+// Whether another document is available; batched states refill their batch here
+static bool MongoScanHasDocument(MongoScanState &state) {
+	if (!state.batched) {
+		return MongoScanCursorHasDocument(state);
+	}
+	if (state.batch_position < state.batch_documents.size()) {
+		return true;
+	}
+	return MongoScanFetchBatch(state);
+}
+
+static bsoncxx::document::view MongoScanBatchDocument(MongoScanState &state, idx_t index) {
+	auto &entry = state.batch_documents[index];
+	return bsoncxx::document::view(state.batch_data.data() + entry.first, entry.second);
+}
+
+static bsoncxx::document::view MongoScanCurrentDocument(MongoScanState &state) {
+	if (!state.batched) {
+		return MongoScanCursorDocument(state);
+	}
+	return MongoScanBatchDocument(state, state.batch_position);
+}
+
+// Late materialization: decodes the residual filter columns of a batch of documents, evaluates the residual filters
+// on them and decodes the output columns only for the documents that pass. Batches are processed until one produces
+// rows (returns 0 once the cursor is exhausted).
+static idx_t MongoScanResidualBatch(ClientContext &context, const MongoScanData &bind_data, MongoScanState &state,
+                                    DataChunk &output, idx_t num_cols_to_use) {
+	if (!state.residual_chunk.ColumnCount()) {
+		vector<LogicalType> residual_types;
+		for (auto &plan : state.residual_plans) {
+			residual_types.push_back(plan.column_type);
+		}
+		state.residual_chunk.Initialize(Allocator::Get(context), residual_types);
+		if (state.residual_filter) {
+			state.residual_executor = make_uniq<ExpressionExecutor>(context, *state.residual_filter);
+		}
+		if (state.late_filter) {
+			state.late_filter_executor = make_uniq<ExpressionExecutor>(context, *state.late_filter);
+		}
+	}
+	bool needs_schema_enforcement = bind_data.has_explicit_schema && bind_data.schema_mode != SchemaMode::PERMISSIVE;
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	SelectionVector late_sel(STANDARD_VECTOR_SIZE);
+	idx_t count = 0;
+	while (count == 0 && MongoScanHasDocument(state)) {
+		// Filter columns are decoded as in PERMISSIVE mode; rows with schema violations are dropped (or fail) when
+		// their output columns are decoded
+		idx_t batch_start = state.batch_position;
+		idx_t batch_count = state.batch_documents.size() - batch_start;
+		auto &chunk = state.residual_chunk;
+		chunk.Reset();
+		for (idx_t i = 0; i < batch_count; i++) {
+			auto doc = MongoScanBatchDocument(state, batch_start + i);
+			if (bind_data.schema_mode == SchemaMode::FAILFAST && needs_schema_enforcement) {
+				// Documents rejected by the filters must still fail the scan
+				ValidateDocumentSchema(doc, state.output_plans, SchemaMode::FAILFAST);
+				ValidateDocumentSchema(doc, state.validation_plans, SchemaMode::FAILFAST);
+			}
+			FlattenDocument(doc, state.residual_plans, chunk, i, SchemaMode::PERMISSIVE, bind_data.has_explicit_schema,
+			                &state.scratch);
+		}
+		for (idx_t col_idx = 0; col_idx < chunk.ColumnCount(); col_idx++) {
+			MongoSetVectorSize(chunk.data[col_idx], batch_count);
+		}
+		chunk.SetCardinality(batch_count);
+		state.batch_position += batch_count;
+
+		idx_t selected = batch_count;
+		if (state.residual_executor) {
+			selected = state.residual_executor->SelectExpression(chunk, sel);
+		} else {
+			for (idx_t i = 0; i < batch_count; i++) {
+				sel.set_index(i, i);
+			}
+		}
+		if (state.late_filter_executor && selected > 0) {
+			if (selected < batch_count) {
+				chunk.Slice(sel, selected);
+			}
+			try {
+				idx_t late_selected = state.late_filter_executor->SelectExpression(chunk, late_sel);
+				// late_sel indexes the sliced chunk; map it back to batch positions (in place, as i <= late_sel[i])
+				for (idx_t i = 0; i < late_selected; i++) {
+					sel.set_index(i, sel.get_index(late_sel.get_index(i)));
+				}
+				selected = late_selected;
+			} catch (std::exception &) {
+				// DuckDB evaluates these filters again above the scan: keep the rows and let the error surface there
+			}
+		}
+
+		for (idx_t i = 0; i < selected; i++) {
+			auto doc = MongoScanBatchDocument(state, batch_start + sel.get_index(i));
+			bool row_valid = true;
+			if (needs_schema_enforcement) {
+				row_valid = FlattenAndValidateDocument(doc, state.output_plans, state.validation_plans, output, count,
+				                                       bind_data.schema_mode, &state.scratch);
+			} else if (num_cols_to_use > 0) {
+				row_valid = FlattenDocument(doc, state.output_plans, output, count, bind_data.schema_mode,
+				                            bind_data.has_explicit_schema, &state.scratch);
+			}
+			if (row_valid) {
+				count++;
+			}
+		}
+		// An empty chunk would end the scan, so batches the filters reject entirely wait for the rate limits here
+		if (count == 0 && MongoScanThrottled(state)) {
+			MongoScanThrottle::Wait(context, state.throttle_until);
+		}
+	}
+	return count;
+}
+
+// Decodes the chunks of a shared scan from `source`, a state holding the deferred cursor of the scan that created it
+static MongoSharedScan::producer_t MongoScanSharedProducer(shared_ptr<MongoScanState> source,
+                                                           vector<MongoColumnPlan> plans, vector<LogicalType> types,
+                                                           bool has_explicit_schema, int32_t id_order) {
+	using document_id_t = MongoSharedScan::document_id_t;
+	return [source, plans, types, has_explicit_schema, id_order](ClientContext &context, bool sort_by_id,
+	                                                             document_id_t &last_id,
+	                                                             bool &reader_error) -> unique_ptr<DataChunk> {
+		if (source->cursor_pending) {
+			if (sort_by_id) {
+				source->find_options.sort(bsoncxx::builder::basic::make_document(
+				    bsoncxx::builder::basic::kvp("_id", id_order)));
+			}
+			// Opening waits for admission on the calling reader's query. When that fails (interrupted or timed
+			// out), the cursor stays pending and another reader opens it.
+			reader_error = true;
+			MongoScanOpenFindCursor(context, *source, source->find_filter.view());
+			reader_error = false;
+			source->cursor_pending = false;
+		}
+		if (!MongoScanHasDocument(*source)) {
+			return nullptr;
+		}
+		MongoScanChunkTimer chunk_timer(source->query_stats.get());
+		auto chunk = make_uniq<DataChunk>();
+		chunk->Initialize(Allocator::DefaultAllocator(), types);
+		source->scratch.Reset();
+		idx_t count = 0;
+		while (count < STANDARD_VECTOR_SIZE && MongoScanHasDocument(*source)) {
+			auto doc = MongoScanCurrentDocument(*source);
+			FlattenDocument(doc, plans, *chunk, count, SchemaMode::PERMISSIVE, has_explicit_schema, &source->scratch);
+			auto id = doc["_id"];
+			if (id) {
+				last_id = bsoncxx::types::bson_value::value(id.get_value());
+			}
+			MongoScanNextDocument(*source);
+			count++;
+		}
+		for (idx_t col_idx = 0; col_idx < chunk->ColumnCount(); col_idx++) {
+			MongoSetVectorSize(chunk->data[col_idx], count);
+		}
+		chunk->SetCardinality(count);
+		return chunk;
+	};
+}
+
+// Direction of the _id order of a shared scan's cursor: the scan's own ORDER BY _id, or ascending
+static int32_t MongoSharedScanIdOrder(const MongoScanData &data) {
+	return data.sort_by_id != 0 ? data.sort_by_id : 1;
+}
+
+// Shared scans: a deferred find cursor that decodes every output column without schema enforcement, residual
+// filters or runtime filters produces the same chunks for every scan with the same query, projection and columns.
+// Such a scan attaches to the in-flight scan registered under that key (or registers one) instead of opening its
+// own cursor. Its cursor moves to a separate state, so the shared scan outlives the scan that created it.
+static void MongoScanAttachSharedScan(ClientContext &context, const MongoScanData &data, MongoScanState &state,
+                                      const DataChunk &output) {
+	if (!data.shared_scans || !state.cursor_pending || state.shared || state.batched || state.limit >= 0 ||
+	    state.throttle || MongoHasFilters(*state.pending_dynamic_filters)) {
+		return;
+	}
+	if (data.has_explicit_schema && data.schema_mode != SchemaMode::PERMISSIVE) {
+		return;
+	}
+	const auto &column_names = state.requested_column_names.empty() ? data.column_names : state.requested_column_names;
+	const auto &column_types = state.requested_column_names.empty() ? data.column_types : state.requested_column_types;
+	if (output.ColumnCount() == 0 || output.ColumnCount() != column_names.size()) {
+		return;
+	}
+
+	auto key = data.connection_string + "\n" + state.database_name + "\n" + state.collection_name + "\n" +
+	           bsoncxx::to_json(state.find_filter.view()) + "\n" + bsoncxx::to_json(state.projection_document.view());
+	for (idx_t col_idx = 0; col_idx < column_names.size(); col_idx++) {
+		key += "\n" + column_names[col_idx] + " " + column_types[col_idx].ToString();
+	}
+	key += data.has_explicit_schema ? "\nexplicit" : "\ninferred";
+	if (data.sort_by_id != 0) {
+		key += "\nsort _id " + std::to_string(data.sort_by_id);
+	}
+
+	// Called under the registry lock, only when no scan can be attached to: the cursor is logged once, by the
+	// state reading it
+	auto create_producer = [&]() {
+		auto source = make_shared_ptr<MongoScanState>();
+		source->connection = state.connection;
+		source->database_name = state.database_name;
+		source->collection_name = state.collection_name;
+		source->projection_document = bsoncxx::document::value(state.projection_document.view());
+		source->find_filter = bsoncxx::document::value(state.find_filter.view());
+		source->find_options = state.find_options;
+		source->use_native_cursor = state.use_native_cursor;
+		if (!source->projection_document.view().empty()) {
+			source->find_options.projection(source->projection_document.view());
+		}
+		source->cursor_pending = true;
+		source->admission_limits = state.admission_limits;
+		source->query_stats = std::move(state.query_stats);
+		auto plans = BuildColumnPlans(column_names, column_types, data.column_name_to_mongo_path);
+		// Sorted by _id once several readers share the cursor, so that a detached reader can continue after the
+		// last _id it read
+		return MongoScanSharedProducer(std::move(source), std::move(plans), column_types, data.has_explicit_schema,
+		                               MongoSharedScanIdOrder(data));
+	};
+	state.shared_scan =
+	    MongoSharedScanRegistry::Get().Attach(key, context.GetConnectionId(), create_producer, data.shared_scan_buffer,
+	                                          data.sort_by_id != 0, state.shared_scan_reader);
+	state.cursor_pending = false;
+	state.query_stats.reset();
+}
+
+// Reads the next chunk of a shared scan. Returns false when the scan detached this reader (the others could not wait
+// for it any longer): the state then reads the remaining documents, after the last _id it read, from its own cursor.
+static bool MongoScanSharedChunk(ClientContext &context, const MongoScanData &data, MongoScanState &state,
+                                 DataChunk &output) {
+	while (true) {
+		bool detached = false;
+		MongoSharedScan::document_id_t resume_after;
+		auto chunk = state.shared_scan->Next(context, state.shared_scan_reader, detached, resume_after);
+		if (detached) {
+			state.shared_scan->RemoveReader(state.shared_scan_reader);
+			state.shared_scan.reset();
+			bsoncxx::document::view_or_value query_filter(state.find_filter.view());
+			if (resume_after) {
+				auto op = MongoSharedScanIdOrder(data) > 0 ? "$gt" : "$lt";
+				auto condition = bsoncxx::builder::basic::make_document(
+				    bsoncxx::builder::basic::kvp(op, resume_after->view()));
+				auto id_filter =
+				    bsoncxx::builder::basic::make_document(bsoncxx::builder::basic::kvp("_id", condition.view()));
+				MongoScanAndFilter(query_filter, id_filter.view());
+			}
+			MongoScanOpenFindCursor(context, state, query_filter.view());
+			return false;
+		}
+		if (!chunk) {
+			state.finished = true;
+			output.SetCardinality(0);
+			return true;
+		}
+		if (chunk->size() > 0) {
+			chunk->Copy(output);
+			return true;
+		}
+	}
+}
+
 void MongoScanFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
 	const auto &bind_data = dynamic_cast<const MongoScanData &>(*data_p.bind_data);
 	auto &state = dynamic_cast<MongoScanState &>(*data_p.local_state);
 
+	// Sleep off the documents the previous chunk read over the rate limits (counted as client time)
+	if (state.throttle) {
+		MongoScanChunkTimer wait_timer(state.query_stats.get());
+		MongoScanThrottle::Wait(context, state.throttle_until);
+	}
 	if (state.finished) {
 		output.SetCardinality(0);
 		return;
 	}
 
+	MongoScanAttachSharedScan(context, bind_data, state, output);
+	if (state.shared_scan && MongoScanSharedChunk(context, bind_data, state, output)) {
+		return;
+	}
+
+	MongoScanChunkTimer chunk_timer(state.query_stats.get());
+	MongoScanStartCursor(context, bind_data, state);
 	idx_t count = 0;
 	const idx_t max_count = STANDARD_VECTOR_SIZE;
 
 	// Handle COUNT(*) queries: output has 1 column but may have filter columns in requested_column_names
 	// Skip this optimization if schema enforcement is needed (non-PERMISSIVE mode with explicit schema)
 	bool needs_schema_enforcement = bind_data.has_explicit_schema && bind_data.schema_mode != SchemaMode::PERMISSIVE;
-	if (output.ColumnCount() == 1 && state.requested_column_names.size() > 1 && !needs_schema_enforcement) {
+	if (output.ColumnCount() == 1 && state.requested_column_names.size() > 1 && !needs_schema_enforcement &&
+	    !state.residual_filter) {
 		state.requested_column_names.clear();
 		state.requested_column_types.clear();
 		state.requested_column_indices.clear();
 
-		while (count < max_count && *state.current != *state.end) {
-			++(*state.current);
+		while (count < max_count && MongoScanHasDocument(state) && (count == 0 || !MongoScanThrottled(state))) {
+			MongoScanNextDocument(state);
 			count++;
 		}
 		for (idx_t col_idx = 0; col_idx < output.ColumnCount(); col_idx++) {
 			MongoSetVectorSize(output.data[col_idx], count);
 		}
 		output.SetCardinality(count);
-		if (*state.current == *state.end) {
+		if (!MongoScanHasDocument(state)) {
 			state.finished = true;
 		}
 		return;
@@ -659,14 +1810,15 @@ void MongoScanFunction(ClientContext &context, TableFunctionInput &data_p, DataC
 		auto &vec = output.data[col_idx];
 		vec.SetVectorType(VectorType::FLAT_VECTOR);
 		if (((*column_types)[col_idx].id() == LogicalTypeId::LIST ||
-		     (*column_types)[col_idx].id() == LogicalTypeId::STRUCT) &&
+		     (*column_types)[col_idx].id() == LogicalTypeId::STRUCT ||
+		     (*column_types)[col_idx].id() == LogicalTypeId::MAP) &&
 		    !MongoVectorHasAuxiliary(vec)) {
 			MongoVectorInitializeUninitialized(vec, STANDARD_VECTOR_SIZE);
 		}
 	}
 
 	// If the pipeline returned no rows for a COUNT(*) pushdown, emit a single 0 row.
-	if (state.current && state.end && *state.current == *state.end && !bind_data.pipeline_json.empty() &&
+	if (!state.shared && !MongoScanHasDocument(state) && !bind_data.pipeline_json.empty() &&
 	    output.ColumnCount() == 1 && state.requested_column_names.size() == 1 &&
 	    StringUtil::CIEquals(state.requested_column_names[0], "count")) {
 		if (output.data.empty()) {
@@ -682,32 +1834,63 @@ void MongoScanFunction(ClientContext &context, TableFunctionInput &data_p, DataC
 		return;
 	}
 
+	// Resolve column paths once per scan instead of once per row
+	if (!state.plans_initialized) {
+		vector<string> output_names(column_names->begin(), column_names->begin() + num_cols_to_use);
+		vector<LogicalType> output_types(column_types->begin(), column_types->begin() + num_cols_to_use);
+		state.output_plans = BuildColumnPlans(output_names, output_types, bind_data.column_name_to_mongo_path);
+		if (needs_schema_enforcement) {
+			// Output columns are checked while they are decoded; only the others need a separate check
+			unordered_set<string> decoded(output_names.begin(), output_names.end());
+			vector<string> validation_names;
+			vector<LogicalType> validation_types;
+			for (idx_t col_idx = 0; col_idx < bind_data.column_names.size(); col_idx++) {
+				if (decoded.find(bind_data.column_names[col_idx]) == decoded.end()) {
+					validation_names.push_back(bind_data.column_names[col_idx]);
+					validation_types.push_back(bind_data.column_types[col_idx]);
+				}
+			}
+			state.validation_plans =
+			    BuildColumnPlans(validation_names, validation_types, bind_data.column_name_to_mongo_path);
+		}
+		state.plans_initialized = true;
+	}
+	state.scratch.Reset();
+
+	if (!state.residual_plans.empty()) {
+		count = MongoScanResidualBatch(context, bind_data, state, output, num_cols_to_use);
+		for (idx_t col_idx = 0; col_idx < output.ColumnCount(); col_idx++) {
+			MongoSetVectorSize(output.data[col_idx], count);
+		}
+		output.SetCardinality(count);
+		if (count == 0) {
+			state.finished = true;
+		}
+		return;
+	}
+
 	// Scan documents and flatten into output
-	while (count < max_count && *state.current != *state.end) {
-		auto doc = **state.current;
-		vector<string> trunc_names(column_names->begin(), column_names->begin() + num_cols_to_use);
-		vector<LogicalType> trunc_types(column_types->begin(), column_types->begin() + num_cols_to_use);
+	while (count < max_count && MongoScanHasDocument(state) && (count == 0 || !MongoScanThrottled(state))) {
+		auto doc = MongoScanCurrentDocument(state);
 
 		// For schema enforcement, always validate ALL schema columns
 		// (DuckDB might not request all columns, e.g., for COUNT(*))
 		bool row_valid = true;
 		if (needs_schema_enforcement) {
-			// Validate full schema first (checks all columns, doesn't write to output)
-			row_valid = ValidateDocumentSchema(doc, bind_data.column_names, bind_data.column_types,
-			                                   bind_data.column_name_to_mongo_path, bind_data.schema_mode);
-		}
-
-		// If row is valid (or no enforcement needed), flatten requested columns to output
-		if (row_valid && num_cols_to_use > 0) {
+			// One pass over the document: decodes the requested columns and checks every schema column
+			row_valid = FlattenAndValidateDocument(doc, state.output_plans, state.validation_plans, output, count,
+			                                       bind_data.schema_mode, &state.scratch);
+		} else if (num_cols_to_use > 0) {
 			// Flatten only the requested columns to output
-			// Note: FlattenDocument also does schema checks, but we've already validated above
-			row_valid =
-			    FlattenDocument(doc, trunc_names, trunc_types, output, count, bind_data.column_name_to_mongo_path,
-			                    bind_data.schema_mode, bind_data.has_explicit_schema);
+			row_valid = FlattenDocument(doc, state.output_plans, output, count, bind_data.schema_mode,
+			                            bind_data.has_explicit_schema, &state.scratch);
 		}
-		++(*state.current);
+		MongoScanNextDocument(state);
 		if (row_valid) {
 			count++;
+		} else if (count == 0 && MongoScanThrottled(state)) {
+			// Nothing to return yet: wait for the rate limits here rather than ending the chunk (and the scan)
+			MongoScanThrottle::Wait(context, state.throttle_until);
 		}
 		// If row_valid is false (DROPMALFORMED), we skip incrementing count,
 		// effectively dropping this row from the output
@@ -718,24 +1901,35 @@ void MongoScanFunction(ClientContext &context, TableFunctionInput &data_p, DataC
 	}
 	output.SetCardinality(count);
 
-	if (state.current && state.end && *state.current == *state.end) {
+	if (!MongoScanHasDocument(state)) {
 		state.finished = true;
 	}
 }
 
-void RegisterMongoTableFunction(DatabaseInstance &db) {
-	TableFunction mongo_scan("mongo_scan", {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR},
-	                         MongoScanFunction, MongoScanBind, nullptr, MongoScanInitLocal);
-
-	// Add optional parameters
-	mongo_scan.named_parameters["filter"] = LogicalType::VARCHAR;
-	mongo_scan.named_parameters["sample_size"] = LogicalType::BIGINT;
-	mongo_scan.named_parameters["columns"] = LogicalType::ANY;
-	mongo_scan.named_parameters["schema_mode"] = LogicalType::VARCHAR;
-
-	// Register the table function using ExtensionLoader
-	// Note: This should be called from ExtensionLoader::Load, not directly
-	// The ExtensionLoader will handle registration
+void RegisterMongoScanSettings(DBConfig &config) {
+	config.AddExtensionOption(DECODE_THREADS_SETTING,
+	                          "Number of threads decoding the documents of one mongo_scan cursor (1 decodes on the "
+	                          "thread reading the cursor; rows are produced in no particular order when above 1)",
+	                          LogicalType::BIGINT, Value::BIGINT(1));
+	config.AddExtensionOption(LATE_MATERIALIZATION_SETTING,
+	                          "Evaluate filters that can't be pushed to MongoDB while decoding: filter columns are "
+	                          "decoded first and the other columns only for documents that pass",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
+	config.AddExtensionOption(SHARED_SCANS_SETTING,
+	                          "Let concurrent mongo_scan calls with the same query, projection and columns read one "
+	                          "cursor and share its decoded chunks",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
+	config.AddExtensionOption(SHARED_SCAN_BUFFER_SETTING,
+	                          "Maximum number of decoded chunks a shared scan buffers ahead of its slowest reader",
+	                          LogicalType::BIGINT, Value::BIGINT(DEFAULT_SHARED_SCAN_BUFFER));
+	config.AddExtensionOption(BATCH_SIZE_SETTING,
+	                          "Number of documents MongoDB returns per reply batch of a mongo_scan cursor "
+	                          "(0 = server default: 101 documents in the first batch, then up to 16 MB)",
+	                          LogicalType::BIGINT, Value::BIGINT(0));
+	config.AddExtensionOption(NATIVE_CURSOR_SETTING,
+	                          "Drive mongo_scan find cursors through libmongoc directly, reading each document in "
+	                          "place from the reply batch",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
 }
 
 } // namespace duckdb
@@ -20,31 +20,30 @@
 
 namespace duckdb {
 
-std::string NormalizeJson(const std::string &json) {
-	std::string normalized;
-	normalized.reserve(json.length());
+idx_t NormalizeJson(const std::string &json, char *out) {
+	idx_t out_len = 0;
 	bool in_string = false;
 	bool escape_next = false;
 
 	for (size_t i = 0; i < json.length(); i++) {
 		char c = json[i];
 		if (escape_next) {
-			normalized += c;
+			out[out_len++] = c;
 			escape_next = false;
 			continue;
 		}
 		if (c == '\\') {
 			escape_next = true;
-			normalized += c;
+			out[out_len++] = c;
 			continue;
 		}
 		if (c == '"') {
 			in_string = !in_string;
-			normalized += c;
+			out[out_len++] = c;
 			continue;
 		}
 		if (in_string) {
-			normalized += c;
+			out[out_len++] = c;
 			continue;
 		}
 		// Outside strings, remove spaces after [ and before ], and after commas
@@ -66,8 +65,14 @@ std::string NormalizeJson(const std::string &json) {
 				continue; // Skip this space
 			}
 		}
-		normalized += c;
+		out[out_len++] = c;
 	}
+	return out_len;
+}
+
+std::string NormalizeJson(const std::string &json) {
+	std::string normalized(json.length(), '\0');
+	normalized.resize(NormalizeJson(json, &normalized[0]));
 	return normalized;
 }
 
@@ -592,6 +597,7 @@ bool IsBSONTypeCompatible(bsoncxx::type bson_type, LogicalTypeId expected_type)
 		return bson_type == bsoncxx::type::k_date;
 
 	case LogicalTypeId::STRUCT:
+	case LogicalTypeId::MAP:
 		return bson_type == bsoncxx::type::k_document;
 
 	case LogicalTypeId::LIST:
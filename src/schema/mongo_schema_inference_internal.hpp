@@ -10,6 +10,8 @@
 namespace duckdb {
 
 std::string NormalizeJson(const std::string &json);
+// Writes the normalized JSON to out (which must hold json.length() bytes) and returns its length
+idx_t NormalizeJson(const std::string &json, char *out);
 
 template <typename ElementType>
 LogicalType InferTypeFromBSONElement(const ElementType &element) {
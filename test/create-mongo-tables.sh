@@ -515,6 +515,132 @@ db.case_variant_fields_test.insertMany([
   }
 ]);
 
+// Collection for testing MAP inference of dynamic-key sub-documents.
+// metrics uses one key per series (5 distinct keys across the collection, numeric values),
+// tags has few keys and stays flattened, attrs has enough keys but mixed value types.
+db.dynamic_keys_test.insertMany([
+  {
+    host: 'web1',
+    metrics: { 'cpu-1': 1.5, 'cpu-2': 0.5, mem: 40 },
+    tags: { env: 'prod', team: 'a' },
+    attrs: { a: 'x', b: true }
+  },
+  {
+    host: 'web2',
+    metrics: { 'cpu-1': 2.5, disk: 10 },
+    tags: { env: 'dev' },
+    attrs: { c: 'y', d: 'z' }
+  },
+  {
+    host: 'db1',
+    metrics: { 'cpu-3': 0.25, mem: 80 },
+    tags: { env: 'prod', tier: 'gold' },
+    attrs: { a: 'w' }
+  }
+]);
+
+// Collection with a $jsonSchema validator: the schema comes from the validator instead of sampling.
+// 'nickname' and 'settings' are described but never present in the data.
+db.createCollection('validated_test', {
+  validator: {
+    $jsonSchema: {
+      bsonType: 'object',
+      required: ['name', 'age'],
+      properties: {
+        _id: { bsonType: 'objectId' },
+        name: { bsonType: 'string' },
+        nickname: { bsonType: ['string', 'null'] },
+        age: { bsonType: 'int' },
+        score: { bsonType: ['int', 'double'] },
+        active: { bsonType: 'bool' },
+        joined: { bsonType: 'date' },
+        address: {
+          bsonType: 'object',
+          properties: {
+            city: { bsonType: 'string' },
+            zip: { bsonType: 'string' }
+          }
+        },
+        tags: { bsonType: 'array', items: { bsonType: 'string' } },
+        counters: { bsonType: 'object', additionalProperties: { bsonType: 'long' } },
+        settings: { bsonType: 'object' }
+      }
+    }
+  }
+});
+
+db.validated_test.insertMany([
+  {
+    name: 'Alice',
+    age: NumberInt(30),
+    score: 9.5,
+    active: true,
+    joined: new Date('2024-01-15T10:30:00Z'),
+    address: { city: 'New York', zip: '10001' },
+    tags: ['admin', 'dev'],
+    counters: { logins: NumberLong(12) }
+  },
+  {
+    name: 'Bob',
+    age: NumberInt(25),
+    score: NumberInt(7),
+    active: false,
+    joined: new Date('2024-03-01T08:00:00Z'),
+    address: { city: 'Boston', zip: '02101' },
+    tags: [],
+    counters: { logins: NumberLong(3), uploads: NumberLong(1) }
+  }
+]);
+
+// Larger collection spanning several cursor batches and output chunks
+const bulk_docs = [];
+for (let i = 0; i < 10000; i++) {
+  bulk_docs.push({ seq: NumberInt(i), grp: NumberInt(i % 10), value: i * 0.5, label: 'doc-' + i });
+}
+db.bulk_test.insertMany(bulk_docs);
+
+// Every BSON type before, between and below the decoded fields, for the raw BSON reader of the decode path
+db.bson_types_test.insertMany([
+  {
+    _id: NumberInt(1),
+    bin: BinData(0, ''),
+    re: /ab+c/i,
+    js: Code('f()'),
+    ts: Timestamp(1700000000, 7),
+    dec: NumberDecimal('1.10'),
+    lo: MinKey(),
+    hi: MaxKey(),
+    arr: [NumberInt(1), 'two', { three: NumberInt(3) }, []],
+    empty_doc: {},
+    nested: { skipped: [NumberInt(1), [NumberInt(2), [NumberInt(3)]]], inner: { i32: NumberInt(5), str: 'deep' } },
+    i32: NumberInt(-7),
+    i64: NumberLong('9007199254740993'),
+    dbl: 2.5,
+    flag: true,
+    when: ISODate('2024-02-29T12:34:56.789Z'),
+    str: 'h\u00e9llo',
+    empty_str: '',
+    nul_str: 'a\u0000b',
+    oid: ObjectId('507f1f77bcf86cd799439011'),
+    nothing: null
+  },
+  {
+    _id: NumberInt(2),
+    nested: 'not a document',
+    i32: NumberInt(2147483647),
+    i64: NumberLong(-1),
+    dbl: -0.125,
+    flag: false,
+    when: ISODate('1969-12-31T23:59:59Z'),
+    str: 'x'.repeat(5000),
+    empty_str: '',
+    nul_str: '',
+    oid: ObjectId('000000000000000000000000'),
+    nothing: null
+  },
+  { _id: NumberInt(3), nested: { inner: null } }
+]);
+
 print('Test database created successfully!');
 print('Database: ' + db.getName());
 print('Collections: ' + db.getCollectionNames().join(', '));
@@ -522,7 +648,7 @@ print('Collections: ' + db.getCollectionNames().join(', '));
 
 echo ""
 echo "Test MongoDB database '$MONGO_DB' created successfully!"
-echo "Collections: users, products, orders, decimal_test, empty_collection, type_conflicts, deeply_nested, nested_scalars_test, object_container_test, string_id_test, schema_test_simple, schema_test_nested, schema_test_paths, schema_test_with_id, schema_test_types, case_variant_fields_test"
+echo "Collections: users, products, orders, decimal_test, empty_collection, type_conflicts, deeply_nested, nested_scalars_test, object_container_test, string_id_test, schema_test_simple, schema_test_nested, schema_test_paths, schema_test_with_id, schema_test_types, case_variant_fields_test, dynamic_keys_test, validated_test, bulk_test, bson_types_test"
 echo ""
 
 # Export environment variables for tests
@@ -19,7 +19,8 @@ if docker ps -a | grep -q mongodb-test; then
     docker start mongodb-test || true
 else
     echo "Creating new MongoDB container..."
-    docker run -d -p 27017:27017 --name mongodb-test mongo:latest
+    # A single-node replica set, since partition summaries need change streams
+    docker run -d -p 27017:27017 --name mongodb-test mongo:latest --replSet rs0
 fi
 
 # Wait for MongoDB to be ready
@@ -32,6 +33,18 @@ if ! docker exec mongodb-test mongosh --eval "db.adminCommand('ping')" &> /dev/n
     sleep 5
 fi
 
+# Initiate the replica set (containers created before it was one stay standalone)
+docker exec mongodb-test mongosh --quiet --eval "
+  try { rs.status(); } catch (e) {
+    if (e.codeName === 'NotYetInitialized') {
+      rs.initiate({_id: 'rs0', members: [{_id: 0, host: 'localhost:27017'}]});
+    } else {
+      print('Warning: MongoDB is not a replica set; partition summary tests will fail. Recreate the mongodb-test container.');
+    }
+  }
+  while (!db.hello().isWritablePrimary && db.hello().setName) { sleep(500); }
+"
+
 # Create test data
 echo "Creating test data..."
 bash test/create-mongo-tables.sh
@@ -0,0 +1,302 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "mongo_bson_reader.hpp"
+#include <cstring>
+#include <string>
+#include <vector>
+
+using duckdb::MongoBsonElement;
+using duckdb::MongoBsonReader;
+using duckdb::MongoBsonType;
+
+namespace {
+
+// Builds BSON bytes by hand, so that lengths can be made inconsistent
+struct BsonBytes {
+	std::vector<uint8_t> bytes;
+
+	BsonBytes &Byte(uint8_t value) {
+		bytes.push_back(value);
+		return *this;
+	}
+	BsonBytes &Int32(int32_t value) {
+		uint8_t raw[sizeof(value)];
+		memcpy(raw, &value, sizeof(value));
+		bytes.insert(bytes.end(), raw, raw + sizeof(value));
+		return *this;
+	}
+	BsonBytes &Int64(int64_t value) {
+		uint8_t raw[sizeof(value)];
+		memcpy(raw, &value, sizeof(value));
+		bytes.insert(bytes.end(), raw, raw + sizeof(value));
+		return *this;
+	}
+	BsonBytes &Double(double value) {
+		uint8_t raw[sizeof(value)];
+		memcpy(raw, &value, sizeof(value));
+		bytes.insert(bytes.end(), raw, raw + sizeof(value));
+		return *this;
+	}
+	BsonBytes &Raw(const std::vector<uint8_t> &raw) {
+		bytes.insert(bytes.end(), raw.begin(), raw.end());
+		return *this;
+	}
+	BsonBytes &Zeros(size_t count) {
+		bytes.insert(bytes.end(), count, 0);
+		return *this;
+	}
+	BsonBytes &CString(const std::string &value) {
+		bytes.insert(bytes.end(), value.begin(), value.end());
+		return Byte(0);
+	}
+	BsonBytes &Key(MongoBsonType type, const std::string &key) {
+		return Byte(uint8_t(type)).CString(key);
+	}
+	//! A string value: its length prefix (characters + NUL), the characters and the NUL
+	BsonBytes &String(const std::string &value) {
+		return Int32(int32_t(value.size() + 1)).CString(value);
+	}
+	//! The elements so far wrapped into a document (length prefix and terminating NUL)
+	std::vector<uint8_t> Document() const {
+		BsonBytes document;
+		document.Int32(int32_t(bytes.size() + 5)).Raw(bytes).Byte(0);
+		return document.bytes;
+	}
+};
+
+std::vector<MongoBsonElement> ReadAll(const std::vector<uint8_t> &document, bool &malformed) {
+	MongoBsonReader reader(document.data(), document.size());
+	std::vector<MongoBsonElement> elements;
+	MongoBsonElement element;
+	while (reader.Next(element)) {
+		elements.push_back(element);
+	}
+	malformed = reader.Malformed();
+	return elements;
+}
+
+std::string KeyOf(const MongoBsonElement &element) {
+	return std::string(element.key, element.key_length);
+}
+
+// A document with `element` (type byte, key and value bytes) followed by a valid int32 element
+std::vector<uint8_t> DocumentWith(const BsonBytes &element) {
+	BsonBytes elements;
+	elements.Raw(element.bytes).Key(MongoBsonType::INT32, "after").Int32(1);
+	return elements.Document();
+}
+
+void RequireMalformed(const std::vector<uint8_t> &document) {
+	bool malformed = false;
+	auto elements = ReadAll(document, malformed);
+	REQUIRE(malformed);
+	// Nothing at or after the bad element is returned
+	for (auto &element : elements) {
+		REQUIRE(KeyOf(element) != "after");
+	}
+}
+
+} // namespace
+
+TEST_CASE("Raw BSON reader reads every element type", "[mongo][bson_reader]") {
+	BsonBytes nested;
+	nested.Key(MongoBsonType::INT32, "inner").Int32(5);
+	BsonBytes array;
+	array.Key(MongoBsonType::STRING, "0").String("a").Key(MongoBsonType::INT64, "1").Int64(2);
+
+	BsonBytes elements;
+	elements.Key(MongoBsonType::DOUBLE, "double").Double(2.5);
+	elements.Key(MongoBsonType::STRING, "string").String("h\xC3\xA9llo");
+	elements.Key(MongoBsonType::STRING, "empty").String("");
+	elements.Key(MongoBsonType::STRING, "nul").Int32(4).Raw({'a', 0, 'b'}).Byte(0);
+	elements.Key(MongoBsonType::DOCUMENT, "document").Raw(nested.Document());
+	elements.Key(MongoBsonType::ARRAY, "array").Raw(array.Document());
+	elements.Key(MongoBsonType::DOCUMENT, "empty_document").Raw(BsonBytes().Document());
+	elements.Key(MongoBsonType::BINARY, "binary").Int32(3).Byte(0).Raw({1, 2, 3});
+	elements.Key(MongoBsonType::UNDEFINED, "undefined");
+	elements.Key(MongoBsonType::OID, "oid").Raw({0x50, 0x7f, 0x1f, 0x77, 0xbc, 0xf8, 0x6c, 0xd7, 0x99, 0x43, 0x90,
+	                                             0x11});
+	elements.Key(MongoBsonType::BOOL, "bool").Byte(1);
+	elements.Key(MongoBsonType::DATE, "date").Int64(-1000);
+	elements.Key(MongoBsonType::NULL_VALUE, "null");
+	elements.Key(MongoBsonType::REGEX, "regex").CString("ab+c").CString("i");
+	elements.Key(MongoBsonType::DBPOINTER, "dbpointer").String("db.coll").Zeros(12);
+	elements.Key(MongoBsonType::CODE, "code").String("f()");
+	elements.Key(MongoBsonType::SYMBOL, "symbol").String("sym");
+	BsonBytes scope;
+	scope.Key(MongoBsonType::INT32, "x").Int32(1);
+	auto scope_document = scope.Document();
+	BsonBytes code_with_scope;
+	code_with_scope.String("g()").Raw(scope_document);
+	elements.Key(MongoBsonType::CODE_WITH_SCOPE, "code_with_scope")
+	    .Int32(int32_t(code_with_scope.bytes.size() + 4))
+	    .Raw(code_with_scope.bytes);
+	elements.Key(MongoBsonType::INT32, "int32").Int32(-7);
+	elements.Key(MongoBsonType::TIMESTAMP, "timestamp").Int64(int64_t(1700000000) << 32 | 7);
+	elements.Key(MongoBsonType::INT64, "int64").Int64(9007199254740993LL);
+	elements.Key(MongoBsonType::DECIMAL128, "decimal").Zeros(16);
+	elements.Key(MongoBsonType::MIN_KEY, "min");
+	elements.Key(MongoBsonType::MAX_KEY, "max");
+	auto document = elements.Document();
+
+	bool malformed = true;
+	auto read = ReadAll(document, malformed);
+	REQUIRE(!malformed);
+	std::vector<std::string> keys;
+	for (auto &element : read) {
+		keys.push_back(KeyOf(element));
+	}
+	std::vector<std::string> expected_keys {
+	    "double", "string", "empty", "nul",    "document", "array", "empty_document", "binary",
+	    "undefined", "oid", "bool",  "date",   "null",     "regex", "dbpointer",      "code",
+	    "symbol", "code_with_scope", "int32", "timestamp", "int64", "decimal",        "min",    "max"};
+	REQUIRE(keys == expected_keys);
+
+	REQUIRE(read[0].type == MongoBsonType::DOUBLE);
+	REQUIRE(read[0].GetDouble() == 2.5);
+	REQUIRE(std::string(read[1].GetStringData(), read[1].GetStringLength()) == "h\xC3\xA9llo");
+	REQUIRE(read[2].GetStringLength() == 0);
+	REQUIRE(std::string(read[3].GetStringData(), read[3].GetStringLength()) == std::string("a\0b", 3));
+	REQUIRE(read[9].value_length == 12);
+	REQUIRE(read[9].value[0] == 0x50);
+	REQUIRE(read[10].GetBool());
+	REQUIRE(read[11].GetInt64() == -1000);
+	REQUIRE(read[12].value_length == 0);
+	REQUIRE(std::string(read[15].GetStringData(), read[15].GetStringLength()) == "f()");
+	REQUIRE(read[18].GetInt32() == -7);
+	REQUIRE(read[20].GetInt64() == 9007199254740993LL);
+	REQUIRE(read[21].value_length == 16);
+
+	// Nested documents and arrays are skipped over; a reader of their own reads them
+	std::vector<uint8_t> nested_document(read[4].value, read[4].value + read[4].value_length);
+	auto nested_read = ReadAll(nested_document, malformed);
+	REQUIRE(!malformed);
+	REQUIRE(nested_read.size() == 1);
+	REQUIRE(KeyOf(nested_read[0]) == "inner");
+	REQUIRE(nested_read[0].GetInt32() == 5);
+
+	std::vector<uint8_t> array_document(read[5].value, read[5].value + read[5].value_length);
+	auto array_read = ReadAll(array_document, malformed);
+	REQUIRE(!malformed);
+	REQUIRE(array_read.size() == 2);
+	REQUIRE(std::string(array_read[0].GetStringData(), array_read[0].GetStringLength()) == "a");
+	REQUIRE(array_read[1].GetInt64() == 2);
+
+	std::vector<uint8_t> empty_document(read[6].value, read[6].value + read[6].value_length);
+	auto empty_read = ReadAll(empty_document, malformed);
+	REQUIRE(!malformed);
+	REQUIRE(empty_read.empty());
+}
+
+TEST_CASE("Raw BSON reader rejects bad document lengths", "[mongo][bson_reader]") {
+	BsonBytes elements;
+	elements.Key(MongoBsonType::INT32, "a").Int32(1);
+	auto document = elements.Document();
+
+	SECTION("shorter than a document header") {
+		bool malformed = false;
+		std::vector<uint8_t> short_document {5, 0, 0};
+		REQUIRE(ReadAll(short_document, malformed).empty());
+		REQUIRE(malformed);
+	}
+	SECTION("length prefix below the minimum") {
+		auto bad = document;
+		bad[0] = 4;
+		RequireMalformed(bad);
+	}
+	SECTION("length prefix past the buffer") {
+		auto bad = document;
+		bad[0] = uint8_t(document.size() + 1);
+		RequireMalformed(bad);
+	}
+	SECTION("truncated buffer") {
+		auto bad = std::vector<uint8_t>(document.begin(), document.end() - 1);
+		RequireMalformed(bad);
+	}
+	SECTION("no terminating NUL") {
+		auto bad = document;
+		bad.back() = 1;
+		RequireMalformed(bad);
+	}
+}
+
+TEST_CASE("Raw BSON reader rejects bad element lengths", "[mongo][bson_reader]") {
+	SECTION("string length past the document") {
+		BsonBytes element;
+		element.Key(MongoBsonType::STRING, "s").Int32(1000).CString("abc");
+		RequireMalformed(DocumentWith(element));
+	}
+	SECTION("string length of zero") {
+		BsonBytes element;
+		element.Key(MongoBsonType::STRING, "s").Int32(0);
+		RequireMalformed(DocumentWith(element));
+	}
+	SECTION("negative string length") {
+		BsonBytes element;
+		element.Key(MongoBsonType::STRING, "s").Int32(-5).CString("abc");
+		RequireMalformed(DocumentWith(element));
+	}
+	SECTION("string without its NUL") {
+		BsonBytes element;
+		element.Key(MongoBsonType::STRING, "s").Int32(3).Raw({'a', 'b', 'c'});
+		RequireMalformed(DocumentWith(element));
+	}
+	SECTION("nested document below the minimum length") {
+		BsonBytes element;
+		element.Key(MongoBsonType::DOCUMENT, "d").Int32(4);
+		RequireMalformed(DocumentWith(element));
+	}
+	SECTION("nested document past the document") {
+		BsonBytes element;
+		element.Key(MongoBsonType::ARRAY, "d").Int32(1000).Byte(0);
+		RequireMalformed(DocumentWith(element));
+	}
+	SECTION("negative binary length") {
+		BsonBytes element;
+		element.Key(MongoBsonType::BINARY, "b").Int32(-1).Byte(0);
+		RequireMalformed(DocumentWith(element));
+	}
+	SECTION("binary length past the document") {
+		BsonBytes element;
+		element.Key(MongoBsonType::BINARY, "b").Int32(1000).Byte(0).Raw({1, 2});
+		RequireMalformed(DocumentWith(element));
+	}
+	SECTION("dbpointer length past the document") {
+		BsonBytes element;
+		element.Key(MongoBsonType::DBPOINTER, "p").Int32(1000).CString("db");
+		RequireMalformed(DocumentWith(element));
+	}
+	SECTION("unknown element type") {
+		BsonBytes element;
+		element.Key(MongoBsonType(0x20), "x").Int32(1);
+		RequireMalformed(DocumentWith(element));
+	}
+}
+
+TEST_CASE("Raw BSON reader rejects truncated elements", "[mongo][bson_reader]") {
+	SECTION("fixed-size value cut by the end of the document") {
+		BsonBytes elements;
+		elements.Key(MongoBsonType::INT64, "n").Int32(1);
+		RequireMalformed(elements.Document());
+	}
+	SECTION("string length prefix cut by the end of the document") {
+		BsonBytes elements;
+		elements.Key(MongoBsonType::STRING, "s").Byte(1).Byte(0);
+		RequireMalformed(elements.Document());
+	}
+	SECTION("key without its NUL") {
+		BsonBytes elements;
+		elements.Byte(uint8_t(MongoBsonType::INT32)).Raw({'k', 'e', 'y'});
+		RequireMalformed(elements.Document());
+	}
+	SECTION("regex without its options") {
+		BsonBytes elements;
+		elements.Key(MongoBsonType::REGEX, "r").CString("ab+c").Raw({'i'});
+		RequireMalformed(elements.Document());
+	}
+	SECTION("oid cut by the end of the document") {
+		BsonBytes elements;
+		elements.Key(MongoBsonType::OID, "o").Zeros(11);
+		RequireMalformed(elements.Document());
+	}
+}